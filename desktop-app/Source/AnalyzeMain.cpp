@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    soundman-analyze - Headless Batch Analysis Entry Point
+
+    Decodes audio files directly (no audio device, no UI), runs the level,
+    true peak, phase, loudness, BPM, key and pitch analysis as fast as the
+    CPU allows and writes one DataExporter JSON file per input. Files are
+    analysed in parallel, one per worker thread.
+
+  ==============================================================================
+*/
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "Utils/DataExporter.h"
+#include <atomic>
+#include <iostream>
+
+namespace
+{
+    //==========================================================================
+    void printUsage()
+    {
+        std::cout << "Usage: soundman-analyze [options] <file or directory>...\n"
+                     "\n"
+                     "Options:\n"
+                     "  -o <dir>, --output=<dir>  Write JSON files here (default: next to each input)\n"
+                     "  -j <n>, --jobs=<n>        Files analysed in parallel (default: CPU cores)\n"
+                     "  -r, --recursive           Search directories recursively\n"
+                     "  -h, --help                Show this help\n"
+                     "\n"
+                     "Each input <name.ext> produces <name.ext>.json. Directory inputs keep\n"
+                     "their sub-directory layout under --output.\n";
+    }
+
+    //==========================================================================
+    struct Input
+    {
+        juce::File file;
+        juce::File outputFile;
+    };
+
+    juce::File getOutputFileFor(const juce::File& file, const juce::File& root, const juce::File& outputDirectory)
+    {
+        auto jsonName = file.getFileName() + ".json";
+
+        if (outputDirectory == juce::File())
+            return file.getSiblingFile(jsonName);
+
+        if (file.getParentDirectory() == root)
+            return outputDirectory.getChildFile(jsonName);
+
+        // Keep the layout below the directory given on the command line
+        return outputDirectory.getChildFile(file.getParentDirectory().getRelativePathFrom(root))
+                              .getChildFile(jsonName);
+    }
+
+    //==========================================================================
+    // Serialises console output from the worker threads
+    juce::CriticalSection consoleLock;
+
+    void printLine(std::ostream& stream, const juce::String& line)
+    {
+        const juce::ScopedLock sl(consoleLock);
+        stream << line << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 2 : 0;
+    }
+
+    juce::File outputDirectory;
+    if (args.containsOption("--output|-o"))
+    {
+        auto path = args.removeValueForOption("--output|-o");
+        if (path.isEmpty())
+        {
+            std::cerr << "Missing directory after --output" << std::endl;
+            return 2;
+        }
+
+        outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    }
+
+    int numJobs = juce::SystemStats::getNumCpus();
+    if (args.containsOption("--jobs|-j"))
+        numJobs = args.removeValueForOption("--jobs|-j").getIntValue();
+
+    if (numJobs < 1)
+    {
+        std::cerr << "--jobs needs a positive number" << std::endl;
+        return 2;
+    }
+
+    const bool recursive = args.removeOptionIfFound("--recursive|-r");
+
+    // Collect inputs
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    const auto wildcard = formatManager.getWildcardForAllFormats();
+
+    std::vector<Input> inputs;
+    bool missingInput = false;
+
+    for (const auto& arg : args.arguments)
+    {
+        if (arg.isOption())
+        {
+            std::cerr << "Unknown option: " << arg.text << std::endl;
+            return 2;
+        }
+
+        auto path = arg.resolveAsFile();
+
+        if (path.isDirectory())
+        {
+            for (const auto& entry : juce::RangedDirectoryIterator(path, recursive, wildcard))
+                inputs.push_back({ entry.getFile(), getOutputFileFor(entry.getFile(), path, outputDirectory) });
+        }
+        else if (path.existsAsFile())
+        {
+            inputs.push_back({ path, getOutputFileFor(path, path.getParentDirectory(), outputDirectory) });
+        }
+        else
+        {
+            std::cerr << "Not found: " << path.getFullPathName() << std::endl;
+            missingInput = true;
+        }
+    }
+
+    if (inputs.empty())
+    {
+        std::cerr << "No audio files to analyse" << std::endl;
+        return missingInput ? 1 : 2;
+    }
+
+    // Analyse
+    std::atomic<int> numFailed { 0 };
+    std::atomic<int> numRemaining { (int)inputs.size() };
+    juce::WaitableEvent finished;
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        juce::ThreadPool pool(juce::jmin(numJobs, (int)inputs.size()));
+
+        for (const auto& input : inputs)
+        {
+            pool.addJob([input, &numFailed, &numRemaining, &finished]
+            {
+                auto jobStart = juce::Time::getMillisecondCounterHiRes();
+                DataExporter::AnalysisData data;
+
+                if (!DataExporter::analyzeFile(input.file, data))
+                {
+                    printLine(std::cerr, "FAILED  " + input.file.getFullPathName() + " (cannot decode)");
+                    ++numFailed;
+                }
+                else if (!DataExporter::exportToJSON(data, input.outputFile))
+                {
+                    printLine(std::cerr, "FAILED  " + input.file.getFullPathName()
+                                         + " (cannot write " + input.outputFile.getFullPathName() + ")");
+                    ++numFailed;
+                }
+                else
+                {
+                    double seconds = (juce::Time::getMillisecondCounterHiRes() - jobStart) / 1000.0;
+                    double speed = seconds > 0.0 ? data.duration / seconds : 0.0;
+
+                    printLine(std::cout, "ok      " + input.file.getFullPathName()
+                                         + " (" + juce::String(seconds, 2) + " s, "
+                                         + juce::String(speed, 0) + "x realtime)");
+                }
+
+                if (--numRemaining == 0)
+                    finished.signal();
+            });
+        }
+
+        finished.wait();
+    }
+
+    double totalSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    std::cout << inputs.size() << " file(s), " << numFailed.load() << " failed, "
+              << juce::String(totalSeconds, 2) << " s" << std::endl;
+
+    return (numFailed.load() > 0 || missingInput) ? 1 : 0;
+}
@@ -0,0 +1,413 @@
+/*
+  ==============================================================================
+
+    soundman-benchmark - Engine Benchmarks
+
+    Times engine internals from the console, with no audio device or UI, so
+    changes to them can be measured on the machines they have to run on.
+
+    render-pool: renders a synthetic multitrack plan through TrackRenderPool
+    with every worker count from 0 (serial) up, and reports the time per
+    block and the speed-up over rendering serially. Each track reads a clip
+    held in RAM, runs it through a ParametricEQ insert and applies its
+    fader; the tracks are then summed in order, as MultiTrackAudioSource
+    renders a plan.
+
+    reader: reads a WAV or AIFF file from start to end a block at a time,
+    through MappedAudioReader and through the format's streaming reader,
+    and reports the time per block of each. The file is read once first,
+    so both find it in the page cache.
+
+  ==============================================================================
+*/
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "Core/MappedAudioReader.h"
+#include "Core/TrackRenderPool.h"
+#include "DSP/AudioFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    //==========================================================================
+    void printUsage()
+    {
+        std::cout << "Usage: soundman-benchmark <benchmark> [options]\n"
+                     "\n"
+                     "Benchmarks:\n"
+                     "  render-pool               Synthetic plan rendered with 0 to N pool workers\n"
+                     "  reader                    Block reads, memory-mapped against streamed\n"
+                     "\n"
+                     "render-pool options:\n"
+                     "  --tracks=<n>              Tracks in the plan (default: 64)\n"
+                     "  --bands=<n>               EQ bands per track insert (default: 8)\n"
+                     "  --block=<n>               Block size in samples (default: 512)\n"
+                     "  --rate=<hz>               Sample rate (default: 48000)\n"
+                     "  --seconds=<n>             Audio rendered per worker count (default: 30)\n"
+                     "  --workers=<n>             Most workers tried (default: CPU cores - 1, at least 1)\n"
+                     "\n"
+                     "reader options:\n"
+                     "  --file=<path>             WAV or AIFF file to read (default: a generated\n"
+                     "                            24-bit stereo 48 kHz WAV, deleted afterwards)\n"
+                     "  --seconds=<n>             Length of the generated file (default: 60)\n"
+                     "  --block=<n>               Samples per read (default: 512; the disk\n"
+                     "                            streamer reads 8192)\n"
+                     "\n"
+                     "  -h, --help                Show this help\n";
+    }
+
+    // Returns defaultValue if the option isn't given, and 0 if its value
+    // isn't a positive number
+    int getPositiveOption(juce::ArgumentList& args, const juce::String& option, int defaultValue)
+    {
+        if (!args.containsOption(option))
+            return defaultValue;
+
+        return juce::jmax(0, args.removeValueForOption(option).getIntValue());
+    }
+
+    // Anything left after the options are taken is an error
+    bool checkNoArgumentsLeft(const juce::ArgumentList& args)
+    {
+        if (args.size() > 1)
+        {
+            std::cerr << "Unknown argument: " << args[1].text << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    //==========================================================================
+    // Per-block times of one run, in milliseconds
+    struct BlockTimes
+    {
+        std::vector<double> times;
+
+        double getMean() const
+        {
+            double total = 0.0;
+            for (auto time : times)
+                total += time;
+
+            return times.empty() ? 0.0 : total / (double)times.size();
+        }
+
+        double getPercentile(double fraction) const
+        {
+            if (times.empty())
+                return 0.0;
+
+            auto sorted = times;
+            const auto index = (size_t)juce::jlimit(0.0, (double)sorted.size() - 1.0, fraction * (double)sorted.size());
+            std::nth_element(sorted.begin(), sorted.begin() + (std::ptrdiff_t)index, sorted.end());
+            return sorted[index];
+        }
+    };
+
+    //==========================================================================
+    // One track of the synthetic plan, rendered into its own buffer
+    struct SyntheticTrack
+    {
+        juce::AudioBuffer<float> clip;      // Looped
+        juce::AudioBuffer<float> output;
+        ParametricEQ insert;
+        float gain { 1.0f };
+        int clipPosition { 0 };
+    };
+
+    struct SyntheticRenderJob : public TrackRenderPool::Job
+    {
+        std::vector<std::unique_ptr<SyntheticTrack>>* tracks { nullptr };
+        int numSamples { 0 };
+
+        void perform(int taskIndex) noexcept override
+        {
+            auto& track = *(*tracks)[(size_t)taskIndex];
+            const int clipLength = track.clip.getNumSamples();
+
+            for (int done = 0; done < numSamples;)
+            {
+                const int numThisTime = juce::jmin(numSamples - done, clipLength - track.clipPosition);
+
+                for (int ch = 0; ch < track.output.getNumChannels(); ++ch)
+                    track.output.copyFrom(ch, done, track.clip, ch, track.clipPosition, numThisTime);
+
+                done += numThisTime;
+                track.clipPosition = (track.clipPosition + numThisTime) % clipLength;
+            }
+
+            track.insert.process(track.output);
+            track.output.applyGain(0, numSamples, track.gain);
+        }
+    };
+
+    //==========================================================================
+    int runRenderPoolBenchmark(juce::ArgumentList& args)
+    {
+        const int numTracks = getPositiveOption(args, "--tracks", 64);
+        const int numBands = getPositiveOption(args, "--bands", 8);
+        const int blockSize = getPositiveOption(args, "--block", 512);
+        const int sampleRate = getPositiveOption(args, "--rate", 48000);
+        const int seconds = getPositiveOption(args, "--seconds", 30);
+        const int maxWorkers = args.containsOption("--workers")
+            ? juce::jmax(0, args.removeValueForOption("--workers").getIntValue())
+            : juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+
+        if (numTracks < 1 || numTracks > TrackRenderPool::maxTasks || numBands < 1
+            || numBands > ParametricEQ::maxBands || blockSize < 1 || sampleRate < 1 || seconds < 1)
+        {
+            std::cerr << "Invalid render-pool options; see --help" << std::endl;
+            return 2;
+        }
+
+        if (!checkNoArgumentsLeft(args))
+            return 2;
+
+        // A second of noise per track, and bands spread over the spectrum
+        std::vector<std::unique_ptr<SyntheticTrack>> tracks;
+        juce::Random random(1);
+
+        for (int t = 0; t < numTracks; ++t)
+        {
+            auto track = std::make_unique<SyntheticTrack>();
+            track->clip.setSize(2, sampleRate);
+            track->output.setSize(2, blockSize);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < sampleRate; ++i)
+                    track->clip.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+            track->insert.setNumBands(numBands);
+
+            for (int b = 0; b < numBands; ++b)
+                track->insert.setBand(b, 40.0f * std::pow(400.0f, (float)b / (float)numBands),
+                                      (b % 2 == 0 ? 3.0f : -3.0f), 1.0f);
+
+            track->gain = 1.0f / (float)numTracks;
+            tracks.push_back(std::move(track));
+        }
+
+        SyntheticRenderJob job;
+        job.tracks = &tracks;
+        job.numSamples = blockSize;
+
+        juce::AudioBuffer<float> mix(2, blockSize);
+        const int numBlocks = (int)((juce::int64)seconds * sampleRate / blockSize);
+        const int numWarmUpBlocks = juce::jmax(1, numBlocks / 20);
+        const double blockMs = 1000.0 * blockSize / sampleRate;
+
+        std::cout << "render-pool: " << numTracks << " tracks, " << numBands << " EQ bands each, "
+                  << blockSize << "-sample blocks at " << sampleRate << " Hz ("
+                  << juce::String(blockMs, 2) << " ms), " << seconds << " s per run, "
+                  << juce::SystemStats::getNumCpus() << " CPU core(s)\n\n"
+                  << "workers   mean ms   p99 ms    max ms    x realtime   speed-up\n";
+
+        double serialMean = 0.0;
+
+        for (int numWorkers = 0; numWorkers <= maxWorkers; ++numWorkers)
+        {
+            TrackRenderPool pool(numWorkers);
+
+            for (auto& track : tracks)
+            {
+                track->insert.prepare((double)sampleRate, blockSize, 2);
+                track->clipPosition = 0;
+            }
+
+            auto renderBlock = [&]
+            {
+                pool.run(job, numTracks);
+                mix.clear();
+
+                for (auto& track : tracks)
+                    for (int ch = 0; ch < 2; ++ch)
+                        mix.addFrom(ch, 0, track->output, ch, 0, blockSize);
+            };
+
+            // Brings the workers up to speed and the clips into cache
+            for (int i = 0; i < numWarmUpBlocks; ++i)
+                renderBlock();
+
+            BlockTimes blockTimes;
+            blockTimes.times.reserve((size_t)numBlocks);
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                const auto start = juce::Time::getMillisecondCounterHiRes();
+                renderBlock();
+                blockTimes.times.push_back(juce::Time::getMillisecondCounterHiRes() - start);
+            }
+
+            const double mean = blockTimes.getMean();
+            if (numWorkers == 0)
+                serialMean = mean;
+
+            std::cout << juce::String(numWorkers).paddedRight(' ', 10)
+                      << juce::String(mean, 3).paddedRight(' ', 10)
+                      << juce::String(blockTimes.getPercentile(0.99), 3).paddedRight(' ', 10)
+                      << juce::String(blockTimes.getPercentile(1.0), 3).paddedRight(' ', 10)
+                      << juce::String(mean > 0.0 ? blockMs / mean : 0.0, 1).paddedRight(' ', 13)
+                      << juce::String(mean > 0.0 ? serialMean / mean : 0.0, 2) << "x" << std::endl;
+        }
+
+        return 0;
+    }
+
+    //==========================================================================
+    // Noise, so the file doesn't compress in any cache along the way
+    bool writeTestFile(const juce::File& file, int seconds)
+    {
+        constexpr int sampleRate = 48000;
+        constexpr int chunkSize = 8192;
+
+        std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release();  // Owned by the writer now
+
+        juce::AudioBuffer<float> chunk(2, chunkSize);
+        juce::Random random(1);
+
+        for (juce::int64 written = 0, total = (juce::int64)seconds * sampleRate; written < total;)
+        {
+            const int numThisTime = (int)juce::jmin((juce::int64)chunkSize, total - written);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < numThisTime; ++i)
+                    chunk.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+
+            if (!writer->writeFromAudioSampleBuffer(chunk, 0, numThisTime))
+                return false;
+
+            written += numThisTime;
+        }
+
+        return true;
+    }
+
+    BlockTimes timeBlockReads(juce::AudioFormatReader& reader, int blockSize)
+    {
+        juce::AudioBuffer<float> buffer(juce::jmax(1, (int)reader.numChannels), blockSize);
+        BlockTimes blockTimes;
+        blockTimes.times.reserve((size_t)(reader.lengthInSamples / blockSize));
+
+        for (juce::int64 position = 0; position + blockSize <= reader.lengthInSamples; position += blockSize)
+        {
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            reader.read(&buffer, 0, blockSize, position, true, true);
+            blockTimes.times.push_back(juce::Time::getMillisecondCounterHiRes() - start);
+        }
+
+        return blockTimes;
+    }
+
+    int runReaderBenchmark(juce::ArgumentList& args)
+    {
+        const int blockSize = getPositiveOption(args, "--block", 512);
+        const int seconds = getPositiveOption(args, "--seconds", 60);
+        const auto filePath = args.containsOption("--file") ? args.removeValueForOption("--file") : juce::String();
+
+        if (blockSize < 1 || seconds < 1)
+        {
+            std::cerr << "Invalid reader options; see --help" << std::endl;
+            return 2;
+        }
+
+        if (!checkNoArgumentsLeft(args))
+            return 2;
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        // Deleted when it goes out of scope; unused with --file
+        juce::TemporaryFile temporaryFile(".wav");
+        auto file = temporaryFile.getFile();
+
+        if (filePath.isNotEmpty())
+        {
+            file = juce::File::getCurrentWorkingDirectory().getChildFile(filePath);
+        }
+        else if (!writeTestFile(file, seconds))
+        {
+            std::cerr << "Can't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> streamed(formatManager.createReaderFor(file));
+        auto mapped = MappedAudioReader::createReaderFor(formatManager, file);
+
+        if (streamed == nullptr)
+        {
+            std::cerr << "Can't read " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        if (dynamic_cast<MappedAudioReader*>(mapped.get()) == nullptr)
+        {
+            std::cerr << file.getFileName() << " can't be memory-mapped (not uncompressed WAV or AIFF)" << std::endl;
+            return 1;
+        }
+
+        // Into the page cache, for both
+        timeBlockReads(*streamed, blockSize);
+
+        const double blockMs = 1000.0 * blockSize / streamed->sampleRate;
+
+        std::cout << "reader: " << file.getFileName() << ", " << (int)streamed->numChannels << " ch, "
+                  << (int)streamed->bitsPerSample << "-bit, " << juce::String(streamed->sampleRate, 0) << " Hz, "
+                  << juce::String((double)streamed->lengthInSamples / streamed->sampleRate, 1) << " s; "
+                  << blockSize << "-sample blocks (" << juce::String(blockMs, 2) << " ms)\n\n"
+                  << "reader      mean us   p99 us    max us    x realtime\n";
+
+        auto report = [blockMs](const char* name, const BlockTimes& blockTimes)
+        {
+            const double mean = blockTimes.getMean();
+
+            std::cout << juce::String(name).paddedRight(' ', 12)
+                      << juce::String(mean * 1000.0, 2).paddedRight(' ', 10)
+                      << juce::String(blockTimes.getPercentile(0.99) * 1000.0, 2).paddedRight(' ', 10)
+                      << juce::String(blockTimes.getPercentile(1.0) * 1000.0, 2).paddedRight(' ', 10)
+                      << juce::String(mean > 0.0 ? blockMs / mean : 0.0, 0) << std::endl;
+        };
+
+        report("streamed", timeBlockReads(*streamed, blockSize));
+        report("mapped", timeBlockReads(*mapped, blockSize));
+        return 0;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 2 : 0;
+    }
+
+    const auto benchmark = args[0].text;
+
+    if (benchmark == "render-pool")
+        return runRenderPoolBenchmark(args);
+
+    if (benchmark == "reader")
+        return runReaderBenchmark(args);
+
+    std::cerr << "Unknown benchmark: " << benchmark << std::endl;
+    return 2;
+}
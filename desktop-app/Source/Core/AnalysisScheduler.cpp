@@ -0,0 +1,362 @@
+/*
+  ==============================================================================
+
+    AnalysisScheduler.cpp
+
+    Background analysis worker pool implementation
+
+  ==============================================================================
+*/
+
+#include "AnalysisScheduler.h"
+
+//==============================================================================
+/**
+    One analyzer driven by the worker pool. Each job owns its own tap reader,
+    so analyzers drain the tap independently and a slow one (YIN pitch) never
+    holds back the others.
+*/
+class AnalysisScheduler::Job : public juce::ThreadPoolJob
+{
+public:
+    Job(const juce::String& name, AnalysisScheduler& owner)
+        : juce::ThreadPoolJob(name),
+          scheduler(owner),
+          reader(owner.analysisTap)
+    {
+        left.resize(chunkSize, 0.0f);
+        right.resize(chunkSize, 0.0f);
+        mono.resize(chunkSize, 0.0f);
+    }
+
+    juce::int64 getNumDroppedSamples() const { return droppedSamples.load(); }
+
+    JobStatus runJob() override
+    {
+        int generation = scheduler.prepareGeneration.load(std::memory_order_acquire);
+        if (generation != seenGeneration)
+        {
+            seenGeneration = generation;
+            prepare(scheduler.preparedSampleRate.load(), scheduler.preparedBlockSize.load());
+        }
+
+        applySettings();
+
+        bool processedAny = false;
+
+        while (!shouldExit())
+        {
+            juce::int64 startPosition = 0;
+            int numRead = reader.read(left.data(), right.data(), chunkSize, startPosition);
+            if (numRead <= 0)
+                break;
+
+            for (int i = 0; i < numRead; ++i)
+                mono[(size_t)i] = (left[(size_t)i] + right[(size_t)i]) * 0.5f;
+
+            process(left.data(), right.data(), mono.data(), numRead);
+            processedAny = true;
+        }
+
+        droppedSamples.store(reader.getNumDroppedSamples());
+
+        if (processedAny)
+            publish(reader.getReadPosition(), juce::Time::getMillisecondCounterHiRes());
+
+        return jobHasFinished;
+    }
+
+protected:
+    virtual void prepare(double sampleRate, int blockSize) = 0;
+    virtual void applySettings() {}
+    virtual void process(float* leftData, float* rightData, const float* monoData, int numSamples) = 0;
+    virtual void publish(juce::int64 samplePosition, double timeMs) = 0;
+
+    AnalysisScheduler& scheduler;
+
+private:
+    static constexpr int chunkSize = 4096;
+
+    AnalysisTap::Reader reader;
+    std::vector<float> left, right, mono;
+    std::atomic<juce::int64> droppedSamples { 0 };
+    int seenGeneration { -1 };
+};
+
+//==============================================================================
+class AnalysisScheduler::PitchJob : public AnalysisScheduler::Job
+{
+public:
+    explicit PitchJob(AnalysisScheduler& owner) : Job("Pitch Analysis", owner) {}
+
+protected:
+    void prepare(double sampleRate, int) override
+    {
+        detector.setSampleRate(sampleRate);
+    }
+
+    void applySettings() override
+    {
+        detector.setThreshold(scheduler.pitchThreshold.load());
+        detector.setMinFrequency(scheduler.pitchMinFrequency.load());
+        detector.setMaxFrequency(scheduler.pitchMaxFrequency.load());
+    }
+
+    void process(float*, float*, const float* monoData, int numSamples) override
+    {
+        for (int i = 0; i < numSamples; ++i)
+            detector.pushSample(monoData[i]);
+    }
+
+    void publish(juce::int64 samplePosition, double timeMs) override
+    {
+        snapshot.result = detector.getLatestPitch();
+        snapshot.samplePosition = samplePosition;
+        snapshot.timeMs = timeMs;
+        scheduler.pitchResults.publish(snapshot);
+    }
+
+private:
+    PitchDetector detector;
+    PitchSnapshot snapshot;
+};
+
+//==============================================================================
+class AnalysisScheduler::HarmonicsJob : public AnalysisScheduler::Job
+{
+public:
+    explicit HarmonicsJob(AnalysisScheduler& owner) : Job("Harmonics Analysis", owner) {}
+
+protected:
+    void prepare(double sampleRate, int) override
+    {
+        analyzer.setSampleRate(sampleRate);
+    }
+
+    void process(float*, float*, const float* monoData, int numSamples) override
+    {
+        for (int i = 0; i < numSamples; ++i)
+            analyzer.pushSample(monoData[i]);
+    }
+
+    void publish(juce::int64 samplePosition, double timeMs) override
+    {
+        snapshot.result = analyzer.getLatestAnalysis();
+        snapshot.samplePosition = samplePosition;
+        snapshot.timeMs = timeMs;
+        scheduler.harmonicsResults.publish(snapshot);
+    }
+
+private:
+    HarmonicsAnalyzer analyzer;
+    HarmonicsSnapshot snapshot;
+};
+
+//==============================================================================
+class AnalysisScheduler::MFCCJob : public AnalysisScheduler::Job
+{
+public:
+    explicit MFCCJob(AnalysisScheduler& owner) : Job("MFCC Analysis", owner) {}
+
+protected:
+    void prepare(double sampleRate, int) override
+    {
+        analyzer.setSampleRate(sampleRate);
+    }
+
+    void process(float*, float*, const float* monoData, int numSamples) override
+    {
+        for (int i = 0; i < numSamples; ++i)
+            analyzer.pushSample(monoData[i]);
+    }
+
+    void publish(juce::int64 samplePosition, double timeMs) override
+    {
+        snapshot.result = analyzer.getLatestResult();
+        snapshot.samplePosition = samplePosition;
+        snapshot.timeMs = timeMs;
+        scheduler.mfccResults.publish(snapshot);
+    }
+
+private:
+    MFCCAnalyzer analyzer;
+    MFCCSnapshot snapshot;
+};
+
+//==============================================================================
+class AnalysisScheduler::BPMJob : public AnalysisScheduler::Job
+{
+public:
+    explicit BPMJob(AnalysisScheduler& owner) : Job("BPM Analysis", owner) {}
+
+protected:
+    void prepare(double sampleRate, int newBlockSize) override
+    {
+        detector.prepare(sampleRate, newBlockSize);
+        blockSize = juce::jmax(16, newBlockSize);
+    }
+
+    void applySettings() override
+    {
+        detector.setMinBPM(scheduler.bpmMin.load());
+        detector.setMaxBPM(scheduler.bpmMax.load());
+    }
+
+    void process(float* leftData, float* rightData, const float*, int numSamples) override
+    {
+        // Feed device-sized blocks so beat detection keeps its original cadence
+        for (int offset = 0; offset < numSamples; offset += blockSize)
+        {
+            int numThisTime = juce::jmin(blockSize, numSamples - offset);
+            float* channels[] = { leftData + offset, rightData + offset };
+            juce::AudioBuffer<float> block(channels, 2, numThisTime);
+
+            detector.processBlock(block);
+
+            if (detector.isBeatDetected())
+                ++snapshot.result.beatCount;
+        }
+    }
+
+    void publish(juce::int64 samplePosition, double timeMs) override
+    {
+        snapshot.result.bpm = detector.getBPM();
+        snapshot.result.confidence = detector.getConfidence();
+        snapshot.result.onsetStrength = detector.getOnsetStrength();
+        snapshot.result.autocorrelation = detector.getAutocorrelation();
+        snapshot.samplePosition = samplePosition;
+        snapshot.timeMs = timeMs;
+        scheduler.bpmResults.publish(snapshot);
+    }
+
+private:
+    BPMDetector detector;
+    BPMSnapshot snapshot;
+    int blockSize { 512 };
+};
+
+//==============================================================================
+class AnalysisScheduler::KeyJob : public AnalysisScheduler::Job
+{
+public:
+    explicit KeyJob(AnalysisScheduler& owner) : Job("Key Analysis", owner) {}
+
+protected:
+    void prepare(double sampleRate, int newBlockSize) override
+    {
+        detector.prepare(sampleRate, newBlockSize);
+    }
+
+    void process(float* leftData, float* rightData, const float*, int numSamples) override
+    {
+        float* channels[] = { leftData, rightData };
+        juce::AudioBuffer<float> block(channels, 2, numSamples);
+        detector.processBlock(block);
+    }
+
+    void publish(juce::int64 samplePosition, double timeMs) override
+    {
+        snapshot.result.key = detector.getDetectedKey();
+        snapshot.result.confidence = detector.getConfidence();
+        snapshot.result.chroma = detector.getChroma();
+        snapshot.result.correlations = detector.getKeyCorrelations();
+        snapshot.samplePosition = samplePosition;
+        snapshot.timeMs = timeMs;
+        scheduler.keyResults.publish(snapshot);
+    }
+
+private:
+    KeyDetector detector;
+    KeySnapshot snapshot;
+};
+
+//==============================================================================
+AnalysisScheduler::AnalysisScheduler(AnalysisTap& tap, int numWorkers)
+    : juce::Thread("Analysis Scheduler"),
+      analysisTap(tap),
+      workerPool(juce::jmax(1, numWorkers))
+{
+    jobs.push_back(std::make_unique<PitchJob>(*this));
+    jobs.push_back(std::make_unique<HarmonicsJob>(*this));
+    jobs.push_back(std::make_unique<MFCCJob>(*this));
+    jobs.push_back(std::make_unique<BPMJob>(*this));
+    jobs.push_back(std::make_unique<KeyJob>(*this));
+}
+
+AnalysisScheduler::~AnalysisScheduler()
+{
+    stop();
+}
+
+int AnalysisScheduler::defaultNumWorkers()
+{
+    return juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1);
+}
+
+//==============================================================================
+void AnalysisScheduler::start()
+{
+    if (!isThreadRunning())
+        startThread();
+}
+
+void AnalysisScheduler::stop()
+{
+    stopThread(1000);
+    workerPool.removeAllJobs(true, 2000);
+}
+
+void AnalysisScheduler::prepare(double sampleRate, int blockSize)
+{
+    if (sampleRate <= 0.0)
+        return;
+
+    preparedSampleRate.store(sampleRate);
+    preparedBlockSize.store(juce::jmax(1, blockSize));
+    prepareGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void AnalysisScheduler::setPitchFrequencyRange(float minHz, float maxHz)
+{
+    pitchMinFrequency.store(juce::jmin(minHz, maxHz));
+    pitchMaxFrequency.store(juce::jmax(minHz, maxHz));
+}
+
+void AnalysisScheduler::setBPMRange(float minBPM, float maxBPM)
+{
+    bpmMin.store(minBPM);
+    bpmMax.store(maxBPM);
+}
+
+juce::int64 AnalysisScheduler::getNumDroppedSamples() const
+{
+    juce::int64 total = 0;
+    for (auto& job : jobs)
+        total += job->getNumDroppedSamples();
+    return total;
+}
+
+//==============================================================================
+void AnalysisScheduler::run()
+{
+    juce::int64 lastDispatchedPosition = -1;
+
+    while (!threadShouldExit())
+    {
+        // Only wake the workers when the audio thread has published new samples
+        auto writePosition = analysisTap.getWritePosition();
+
+        if (writePosition != lastDispatchedPosition)
+        {
+            lastDispatchedPosition = writePosition;
+
+            for (auto& job : jobs)
+            {
+                if (!workerPool.contains(job.get()))
+                    workerPool.addJob(job.get(), false);
+            }
+        }
+
+        wait(dispatchIntervalMs);
+    }
+}
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    AnalysisScheduler.h
+
+    Runs the music analyzers (Pitch, Harmonics, MFCC, BPM, Key) on a
+    background worker pool. Samples arrive from the audio thread through the
+    wait-free AnalysisTap; results are published as timestamped snapshots
+    that the UI reads without locks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "AnalysisTap.h"
+#include "../DSP/PitchDetector.h"
+#include "../DSP/HarmonicsAnalyzer.h"
+#include "../DSP/MFCCAnalyzer.h"
+#include "../DSP/BPMDetector.h"
+#include "../DSP/KeyDetector.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class AnalysisScheduler : private juce::Thread
+{
+public:
+    //==========================================================================
+    /**
+        Single-writer / single-reader triple buffer. The writer never waits for
+        the reader and the reader always gets the most recently published value.
+    */
+    template <typename ValueType>
+    class SnapshotBuffer
+    {
+    public:
+        // Writer thread
+        void publish(const ValueType& value)
+        {
+            slots[(size_t)backIndex] = value;
+            backIndex = middle.exchange(backIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+        }
+
+        // Reader thread: returns true if a newer value arrived since the last call
+        bool read(ValueType& dest)
+        {
+            bool fresh = (middle.load(std::memory_order_relaxed) & freshFlag) != 0;
+
+            if (fresh)
+                frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+
+            dest = slots[(size_t)frontIndex];
+            return fresh;
+        }
+
+    private:
+        static constexpr int indexMask = 3;
+        static constexpr int freshFlag = 4;
+
+        std::array<ValueType, 3> slots {};
+        std::atomic<int> middle { 1 };
+        int backIndex { 0 };
+        int frontIndex { 2 };
+    };
+
+    //==========================================================================
+    // Result snapshots
+    template <typename ResultType>
+    struct Snapshot
+    {
+        ResultType result {};
+        juce::int64 samplePosition { -1 };  // Tap position after the last analyzed sample
+        double timeMs { 0.0 };              // Time::getMillisecondCounterHiRes() at publish
+    };
+
+    struct BPMResult
+    {
+        float bpm { 0.0f };
+        float confidence { 0.0f };
+        juce::uint32 beatCount { 0 };       // Increments on every detected beat
+        std::vector<float> onsetStrength;
+        std::vector<float> autocorrelation;
+    };
+
+    struct KeyResult
+    {
+        KeyDetector::Key key { KeyDetector::Key::Unknown };
+        float confidence { 0.0f };
+        std::array<float, 12> chroma {};
+        std::array<float, 24> correlations {};
+    };
+
+    using PitchSnapshot = Snapshot<PitchDetector::PitchResult>;
+    using HarmonicsSnapshot = Snapshot<HarmonicsAnalyzer::AnalysisResult>;
+    using MFCCSnapshot = Snapshot<MFCCAnalyzer::MFCCResult>;
+    using BPMSnapshot = Snapshot<BPMResult>;
+    using KeySnapshot = Snapshot<KeyResult>;
+
+    //==========================================================================
+    explicit AnalysisScheduler(AnalysisTap& tap, int numWorkers = defaultNumWorkers());
+    ~AnalysisScheduler() override;
+
+    static int defaultNumWorkers();
+
+    //==========================================================================
+    // Lifecycle (message thread)
+    void start();
+    void stop();
+
+    // Applied by each analyzer before its next run
+    void prepare(double sampleRate, int blockSize);
+
+    //==========================================================================
+    // Analyzer settings (any thread)
+    void setPitchThreshold(float threshold) { pitchThreshold.store(threshold); }
+    void setPitchFrequencyRange(float minHz, float maxHz);
+    void setBPMRange(float minBPM, float maxBPM);
+
+    //==========================================================================
+    // Latest results (message thread). Return true if the snapshot is new.
+    bool getPitchSnapshot(PitchSnapshot& dest) { return pitchResults.read(dest); }
+    bool getHarmonicsSnapshot(HarmonicsSnapshot& dest) { return harmonicsResults.read(dest); }
+    bool getMFCCSnapshot(MFCCSnapshot& dest) { return mfccResults.read(dest); }
+    bool getBPMSnapshot(BPMSnapshot& dest) { return bpmResults.read(dest); }
+    bool getKeySnapshot(KeySnapshot& dest) { return keyResults.read(dest); }
+
+    // Samples the analyzers lost because they fell behind the audio thread
+    juce::int64 getNumDroppedSamples() const;
+
+private:
+    //==========================================================================
+    class Job;
+    class PitchJob;
+    class HarmonicsJob;
+    class MFCCJob;
+    class BPMJob;
+    class KeyJob;
+
+    void run() override;
+
+    //==========================================================================
+    AnalysisTap& analysisTap;
+    juce::ThreadPool workerPool;
+    std::vector<std::unique_ptr<Job>> jobs;
+
+    // Pending configuration, picked up by the jobs
+    std::atomic<double> preparedSampleRate { 44100.0 };
+    std::atomic<int> preparedBlockSize { 512 };
+    std::atomic<int> prepareGeneration { 0 };
+
+    std::atomic<float> pitchThreshold { 0.4f };
+    std::atomic<float> pitchMinFrequency { 50.0f };
+    std::atomic<float> pitchMaxFrequency { 2000.0f };
+    std::atomic<float> bpmMin { 60.0f };
+    std::atomic<float> bpmMax { 200.0f };
+
+    SnapshotBuffer<PitchSnapshot> pitchResults;
+    SnapshotBuffer<HarmonicsSnapshot> harmonicsResults;
+    SnapshotBuffer<MFCCSnapshot> mfccResults;
+    SnapshotBuffer<BPMSnapshot> bpmResults;
+    SnapshotBuffer<KeySnapshot> keyResults;
+
+    static constexpr int dispatchIntervalMs = 10;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisScheduler)
+};
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    AnalysisTap.cpp
+
+    Single-producer / multi-consumer lock-free tap implementation
+
+  ==============================================================================
+*/
+
+#include "AnalysisTap.h"
+#include <cstring>
+
+//==============================================================================
+AnalysisTap::AnalysisTap(int capacityInSamples)
+{
+    capacity = juce::nextPowerOfTwo(juce::jmax(1024, capacityInSamples));
+    mask = capacity - 1;
+
+    leftBuffer.resize((size_t)capacity, 0.0f);
+    rightBuffer.resize((size_t)capacity, 0.0f);
+}
+
+//==============================================================================
+void AnalysisTap::pushBlock(const float* left, const float* right, int numSamples)
+{
+    if (left == nullptr || numSamples <= 0)
+        return;
+
+    if (right == nullptr)
+        right = left;
+
+    auto position = writePosition.load(std::memory_order_relaxed);
+
+    // Blocks larger than the ring only keep their most recent samples
+    if (numSamples > capacity)
+    {
+        int skipped = numSamples - capacity;
+        left += skipped;
+        right += skipped;
+        position += skipped;
+        numSamples = capacity;
+    }
+
+    // Announce the region about to be overwritten before touching it,
+    // so readers copying concurrently can detect torn data
+    writeReserve.store(position + numSamples, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    int start = (int)(position & mask);
+    int firstPart = juce::jmin(numSamples, capacity - start);
+    int secondPart = numSamples - firstPart;
+
+    std::memcpy(leftBuffer.data() + start, left, sizeof(float) * (size_t)firstPart);
+    std::memcpy(rightBuffer.data() + start, right, sizeof(float) * (size_t)firstPart);
+
+    if (secondPart > 0)
+    {
+        std::memcpy(leftBuffer.data(), left + firstPart, sizeof(float) * (size_t)secondPart);
+        std::memcpy(rightBuffer.data(), right + firstPart, sizeof(float) * (size_t)secondPart);
+    }
+
+    writePosition.store(position + numSamples, std::memory_order_release);
+}
+
+//==============================================================================
+AnalysisTap::Reader::Reader(const AnalysisTap& t)
+    : tap(t)
+{
+    readPosition = tap.getWritePosition();
+    rightScratch.resize(scratchSize, 0.0f);
+    monoScratch.resize(scratchSize, 0.0f);
+}
+
+int AnalysisTap::Reader::getNumAvailable() const
+{
+    auto available = tap.getWritePosition() - readPosition;
+    return (int)juce::jlimit((juce::int64)0, (juce::int64)tap.capacity, available);
+}
+
+void AnalysisTap::Reader::skipToLatest()
+{
+    readPosition = tap.getWritePosition();
+}
+
+int AnalysisTap::Reader::read(float* left, float* right, int maxSamples, juce::int64& startPosition)
+{
+    startPosition = readPosition;
+
+    if (maxSamples <= 0)
+        return 0;
+
+    auto published = tap.getWritePosition();
+
+    // Reader fell behind: the oldest samples have already been overwritten
+    auto oldest = published - tap.capacity;
+    if (readPosition < oldest)
+    {
+        droppedSamples += oldest - readPosition;
+        readPosition = oldest;
+    }
+
+    int numToRead = (int)juce::jmin((juce::int64)maxSamples, published - readPosition);
+    if (numToRead <= 0)
+    {
+        startPosition = readPosition;
+        return 0;
+    }
+
+    int start = (int)(readPosition & tap.mask);
+    int firstPart = juce::jmin(numToRead, tap.capacity - start);
+    int secondPart = numToRead - firstPart;
+
+    if (left != nullptr)
+    {
+        std::memcpy(left, tap.leftBuffer.data() + start, sizeof(float) * (size_t)firstPart);
+        if (secondPart > 0)
+            std::memcpy(left + firstPart, tap.leftBuffer.data(), sizeof(float) * (size_t)secondPart);
+    }
+
+    if (right != nullptr)
+    {
+        std::memcpy(right, tap.rightBuffer.data() + start, sizeof(float) * (size_t)firstPart);
+        if (secondPart > 0)
+            std::memcpy(right + firstPart, tap.rightBuffer.data(), sizeof(float) * (size_t)secondPart);
+    }
+
+    // Anything the producer started overwriting while we copied is invalid
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto safeStart = tap.writeReserve.load(std::memory_order_relaxed) - tap.capacity;
+
+    if (safeStart > readPosition)
+    {
+        int torn = (int)juce::jmin((juce::int64)numToRead, safeStart - readPosition);
+        int remaining = numToRead - torn;
+
+        if (left != nullptr && remaining > 0)
+            std::memmove(left, left + torn, sizeof(float) * (size_t)remaining);
+        if (right != nullptr && remaining > 0)
+            std::memmove(right, right + torn, sizeof(float) * (size_t)remaining);
+
+        droppedSamples += torn;
+        readPosition += torn;
+        numToRead = remaining;
+    }
+
+    startPosition = readPosition;
+    readPosition += numToRead;
+    return numToRead;
+}
+
+int AnalysisTap::Reader::readMono(float* mono, int maxSamples)
+{
+    int total = 0;
+
+    while (total < maxSamples)
+    {
+        int chunk = juce::jmin(maxSamples - total, (int)rightScratch.size());
+        juce::int64 start = 0;
+        int got = read(mono + total, rightScratch.data(), chunk, start);
+
+        for (int i = 0; i < got; ++i)
+            mono[total + i] = (mono[total + i] + rightScratch[(size_t)i]) * 0.5f;
+
+        total += got;
+
+        if (got < chunk)
+            break;
+    }
+
+    return total;
+}
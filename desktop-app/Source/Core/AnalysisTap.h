@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    AnalysisTap.h
+
+    Single-producer / multi-consumer lock-free tap of the engine output.
+    The audio thread publishes whole stereo blocks; each display or analyzer
+    owns a Reader and drains the tap at its own pace.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+
+class AnalysisTap
+{
+public:
+    //==========================================================================
+    static constexpr int defaultCapacity = 1 << 15;  // 32768 samples per channel
+
+    explicit AnalysisTap(int capacityInSamples = defaultCapacity);
+    ~AnalysisTap() = default;
+
+    //==========================================================================
+    // Producer side (audio thread only, wait-free)
+
+    // Publish one block. 'right' may be nullptr for mono sources.
+    void pushBlock(const float* left, const float* right, int numSamples);
+
+    // Total number of samples ever published (stamp of the next block)
+    juce::int64 getWritePosition() const { return writePosition.load(std::memory_order_acquire); }
+
+    int getCapacity() const { return capacity; }
+
+    //==========================================================================
+    /**
+        Consumer cursor. Each reader keeps its own read position, so any number
+        of readers can drain the same tap independently. A Reader must only be
+        used from one thread at a time.
+    */
+    class Reader
+    {
+    public:
+        explicit Reader(const AnalysisTap& tap);
+
+        // Copy up to maxSamples of stereo audio into left/right.
+        // startPosition receives the stream position of the first copied sample.
+        // Returns the number of samples copied.
+        int read(float* left, float* right, int maxSamples, juce::int64& startPosition);
+
+        // Same as read(), but delivers the (L + R) / 2 mono mix
+        int readMono(float* mono, int maxSamples);
+
+        // Reads everything pending as the mono mix, calling sink(float) for
+        // each sample. Returns the number of samples read.
+        template <typename Sink>
+        int drainMono(Sink&& sink)
+        {
+            int total = 0;
+            int numRead = 0;
+
+            while ((numRead = readMono(monoScratch.data(), (int)monoScratch.size())) > 0)
+            {
+                for (int i = 0; i < numRead; ++i)
+                    sink(monoScratch[(size_t)i]);
+
+                total += numRead;
+            }
+
+            return total;
+        }
+
+        // Samples currently waiting for this reader (clamped to the tap capacity)
+        int getNumAvailable() const;
+
+        // Samples that were overwritten before this reader could consume them
+        juce::int64 getNumDroppedSamples() const { return droppedSamples; }
+        void resetDroppedCount() { droppedSamples = 0; }
+
+        // Discard everything pending and continue from the current write position
+        void skipToLatest();
+
+        juce::int64 getReadPosition() const { return readPosition; }
+
+    private:
+        static constexpr int scratchSize = 4096;
+
+        const AnalysisTap& tap;
+        juce::int64 readPosition { 0 };
+        juce::int64 droppedSamples { 0 };
+        std::vector<float> rightScratch;
+        std::vector<float> monoScratch;     // drainMono()'s
+
+        JUCE_DECLARE_NON_COPYABLE(Reader)
+    };
+
+private:
+    //==========================================================================
+    int capacity { 0 };
+    int mask { 0 };
+
+    std::vector<float> leftBuffer;
+    std::vector<float> rightBuffer;
+
+    std::atomic<juce::int64> writePosition { 0 };  // End of the last published block
+    std::atomic<juce::int64> writeReserve { 0 };   // End of the block being written
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisTap)
+};
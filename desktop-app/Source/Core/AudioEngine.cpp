@@ -17,9 +17,9 @@ AudioEngine::AudioEngine()
     // Register audio formats
     formatManager.registerBasicFormats();  // WAV, AIFF
 
-    // Listen for transport state changes (both tracks)
-    transportSource.addChangeListener(this);
-    transportSourceB.addChangeListener(this);
+    // Stop when the tracks being heard have played to their ends
+    filePlayer.onFinished = [this] { checkPlaybackFinished(); };
+    filePlayerB.onFinished = [this] { checkPlaybackFinished(); };
 }
 
 AudioEngine::~AudioEngine()
@@ -62,8 +62,9 @@ void AudioEngine::shutdown()
     if (!initialized)
         return;
 
-    // Stop playback
+    // Stop playback and recording
     stop();
+    stopRecording();
     unloadFile();
 
     // Remove audio callback
@@ -83,8 +84,8 @@ bool AudioEngine::loadFile(const juce::File& file)
         return false;
     }
 
-    // Create reader for the file
-    auto* reader = formatManager.createReaderFor(file);
+    // Create reader for the file (memory-mapped for WAV / AIFF)
+    auto* reader = MappedAudioReader::createReaderFor(formatManager, file).release();
     if (reader == nullptr)
     {
         showError("Unsupported audio format: " + file.getFileExtension());
@@ -94,24 +95,28 @@ bool AudioEngine::loadFile(const juce::File& file)
     // Stop current playback
     stop();
 
-    // Create new reader source
+    // Create new reader source, converted to the device rate
     auto newSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
+    auto newResampler = std::make_unique<SincResamplingSource>(newSource.get(), false, reader->sampleRate,
+                                                               (int)reader->numChannels, resamplingQuality);
 
-    // Set source to transport (Phase 1: simplified without resampling)
-    transportSource.setSource(newSource.get());
+    filePlayer.setSource(newResampler.get());
 
+    resamplingSource = std::move(newResampler);
     readerSource = std::move(newSource);
-    resamplingSource.reset();  // Clear any previous resampling source
     currentFile = file;
     playState = PlayState::Stopped;
 
+    // New programme: start integrated loudness / LRA from scratch
+    resetLoudness();
+
     return true;
 }
 
 void AudioEngine::unloadFile()
 {
     stop();
-    transportSource.setSource(nullptr);
+    filePlayer.setSource(nullptr);
     resamplingSource.reset();
     readerSource.reset();
     currentFile = juce::File();
@@ -140,8 +145,8 @@ bool AudioEngine::loadTrackB(const juce::File& file)
         return false;
     }
 
-    // Create reader for the file
-    auto* reader = formatManager.createReaderFor(file);
+    // Create reader for the file (memory-mapped for WAV / AIFF)
+    auto* reader = MappedAudioReader::createReaderFor(formatManager, file).release();
     if (reader == nullptr)
     {
         showError("Unsupported audio format: " + file.getFileExtension());
@@ -149,21 +154,18 @@ bool AudioEngine::loadTrackB(const juce::File& file)
     }
 
     // Stop Track B if playing
-    transportSourceB.stop();
-    transportSourceB.setSource(nullptr);
+    filePlayerB.stop();
+    filePlayerB.setSource(nullptr);
 
-    // Create new reader source
+    // Create new reader source, converted to the device rate
     auto newSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
+    auto newResampler = std::make_unique<SincResamplingSource>(newSource.get(), false, reader->sampleRate,
+                                                               (int)reader->numChannels, resamplingQuality);
 
-    // Set source to transport B
-    transportSourceB.setSource(newSource.get());
-
-    // Prepare if audio device is already running
-    if (preparedSampleRate > 0)
-    {
-        transportSourceB.prepareToPlay(preparedBlockSize, preparedSampleRate);
-    }
+    // Set source to Track B's player (prepared there if the device is running)
+    filePlayerB.setSource(newResampler.get());
 
+    resamplingSourceB = std::move(newResampler);
     readerSourceB = std::move(newSource);
     trackBFile = file;
 
@@ -172,8 +174,9 @@ bool AudioEngine::loadTrackB(const juce::File& file)
 
 void AudioEngine::unloadTrackB()
 {
-    transportSourceB.stop();
-    transportSourceB.setSource(nullptr);
+    filePlayerB.stop();
+    filePlayerB.setSource(nullptr);
+    resamplingSourceB.reset();
     readerSourceB.reset();
     trackBFile = juce::File();
 }
@@ -198,6 +201,25 @@ void AudioEngine::setTrackMixBalance(float balance)
     trackMixBalance.store(juce::jlimit(0.0f, 1.0f, balance));
 }
 
+void AudioEngine::setResamplingQuality(SincResampler::Quality quality)
+{
+    resamplingQuality = quality;
+
+    // Re-preparing through the players swaps the kernel with the callback kept out
+    for (auto* source : { resamplingSource.get(), resamplingSourceB.get() })
+        if (source != nullptr)
+            source->setQuality(quality);
+
+    if (preparedSampleRate > 0)
+    {
+        if (resamplingSource != nullptr)
+            filePlayer.prepareToPlay(preparedBlockSize, preparedSampleRate);
+
+        if (resamplingSourceB != nullptr)
+            filePlayerB.prepareToPlay(preparedBlockSize, preparedSampleRate);
+    }
+}
+
 //==============================================================================
 void AudioEngine::setMultiTrackSource(juce::PositionableAudioSource* source)
 {
@@ -244,14 +266,14 @@ void AudioEngine::play()
         {
             if (hasFileLoaded() && (track == ActiveTrack::A || track == ActiveTrack::Both))
             {
-                transportSource.setPosition(0.0);
-                transportSource.start();
+                filePlayer.setPosition(0.0);
+                filePlayer.start();
             }
 
             if (hasTrackBLoaded() && (track == ActiveTrack::B || track == ActiveTrack::Both))
             {
-                transportSourceB.setPosition(0.0);
-                transportSourceB.start();
+                filePlayerB.setPosition(0.0);
+                filePlayerB.start();
             }
         }
 
@@ -263,10 +285,10 @@ void AudioEngine::play()
         if (!hasMultiTrack && hasAnySingleFile)
         {
             if (hasFileLoaded() && (track == ActiveTrack::A || track == ActiveTrack::Both))
-                transportSource.start();
+                filePlayer.start();
 
             if (hasTrackBLoaded() && (track == ActiveTrack::B || track == ActiveTrack::Both))
-                transportSourceB.start();
+                filePlayerB.start();
         }
 
         playState = PlayState::Playing;
@@ -277,8 +299,8 @@ void AudioEngine::pause()
 {
     if (playState.load() == PlayState::Playing)
     {
-        transportSource.stop();
-        transportSourceB.stop();
+        filePlayer.stop();
+        filePlayerB.stop();
         playState = PlayState::Paused;
     }
 }
@@ -287,10 +309,10 @@ void AudioEngine::stop()
 {
     if (playState.load() != PlayState::Stopped)
     {
-        transportSource.stop();
-        transportSource.setPosition(0.0);
-        transportSourceB.stop();
-        transportSourceB.setPosition(0.0);
+        filePlayer.stop();
+        filePlayer.setPosition(0.0);
+        filePlayerB.stop();
+        filePlayerB.setPosition(0.0);
         playState = PlayState::Stopped;
     }
 }
@@ -300,20 +322,20 @@ void AudioEngine::setPosition(double position)
     // Set position for Track A
     if (hasFileLoaded())
     {
-        double durationA = transportSource.getLengthInSeconds();
+        double durationA = filePlayer.getLengthInSeconds();
         if (durationA > 0.0)
         {
-            transportSource.setPosition(position * durationA);
+            filePlayer.setPosition(position * durationA);
         }
     }
 
     // Set position for Track B
     if (hasTrackBLoaded())
     {
-        double durationB = transportSourceB.getLengthInSeconds();
+        double durationB = filePlayerB.getLengthInSeconds();
         if (durationB > 0.0)
         {
-            transportSourceB.setPosition(position * durationB);
+            filePlayerB.setPosition(position * durationB);
         }
     }
 }
@@ -323,20 +345,20 @@ void AudioEngine::setPositionSeconds(double seconds)
     // Set position in seconds for Track A
     if (hasFileLoaded())
     {
-        double durationA = transportSource.getLengthInSeconds();
+        double durationA = filePlayer.getLengthInSeconds();
         seconds = juce::jlimit(0.0, durationA, seconds);
-        transportSource.setPosition(seconds);
+        filePlayer.setPosition(seconds);
     }
 
     // Set position for Track B (proportionally)
     if (hasTrackBLoaded())
     {
-        double durationA = hasFileLoaded() ? transportSource.getLengthInSeconds() : 1.0;
-        double durationB = transportSourceB.getLengthInSeconds();
+        double durationA = hasFileLoaded() ? filePlayer.getLengthInSeconds() : 1.0;
+        double durationB = filePlayerB.getLengthInSeconds();
         if (durationA > 0.0 && durationB > 0.0)
         {
             double ratio = seconds / durationA;
-            transportSourceB.setPosition(ratio * durationB);
+            filePlayerB.setPosition(ratio * durationB);
         }
     }
 }
@@ -369,7 +391,7 @@ double AudioEngine::getPosition() const
     if (duration <= 0.0)
         return 0.0;
 
-    return transportSource.getCurrentPosition() / duration;
+    return filePlayer.getCurrentPosition() / duration;
 }
 
 double AudioEngine::getDuration() const
@@ -377,7 +399,7 @@ double AudioEngine::getDuration() const
     if (!hasFileLoaded() || readerSource == nullptr)
         return 0.0;
 
-    return transportSource.getLengthInSeconds();
+    return filePlayer.getLengthInSeconds();
 }
 
 //==============================================================================
@@ -478,6 +500,12 @@ void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChan
                                                    int numSamples,
                                                    const juce::AudioIODeviceCallbackContext& context)
 {
+    // Debug builds: report any allocation or lock made on this thread
+    RealtimeSafety::ScopedRealtimeContext realtimeContext;
+
+    // Temporary buffers for this block come from the preallocated arena
+    callbackArena.reset();
+
     // Create buffer wrapper (no allocation, just wraps the raw pointers)
     juce::AudioBuffer<float> buffer(const_cast<float**>(outputChannelData), numOutputChannels, numSamples);
 
@@ -498,105 +526,27 @@ void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChan
     }
     else
     {
-        // Single file playback - handle dual track mode
-        auto track = activeTrack.load();
-
-        // Handle dual track playback based on active track setting
-        if (track == ActiveTrack::A && hasFileLoaded())
-        {
-            // Track A only
-            transportSource.getNextAudioBlock(channelInfo);
-        }
-        else if (track == ActiveTrack::B && hasTrackBLoaded())
-        {
-            // Track B only
-            transportSourceB.getNextAudioBlock(channelInfo);
-        }
-        else if (track == ActiveTrack::Both)
-        {
-            // Mix both tracks
-            float balance = trackMixBalance.load();
-            float gainA = 1.0f - balance;  // 0.0 -> 1.0, 1.0 -> 0.0
-            float gainB = balance;          // 0.0 -> 0.0, 1.0 -> 1.0
-
-            // Get Track A audio
-            if (hasFileLoaded())
-            {
-                transportSource.getNextAudioBlock(channelInfo);
-                buffer.applyGain(gainA);
-            }
-
-            // Get Track B audio and mix
-            if (hasTrackBLoaded())
-            {
-                juce::AudioBuffer<float> bufferB(numOutputChannels, numSamples);
-                bufferB.clear();
-
-                juce::AudioSourceChannelInfo channelInfoB;
-                channelInfoB.buffer = &bufferB;
-                channelInfoB.startSample = 0;
-                channelInfoB.numSamples = numSamples;
-
-                transportSourceB.getNextAudioBlock(channelInfoB);
-
-                // Add Track B to output with gain
-                for (int ch = 0; ch < numOutputChannels; ++ch)
-                {
-                    if (ch < bufferB.getNumChannels())
-                    {
-                        buffer.addFrom(ch, 0, bufferB, ch, 0, numSamples, gainB);
-                    }
-                }
-            }
-        }
-        else if (hasFileLoaded())
-        {
-            // Default: play Track A if available
-            transportSource.getNextAudioBlock(channelInfo);
-        }
-    }  // End of else block for single file playback
-
-    // Check for loop point
-    if (loopEnabled.load() && playState.load() == PlayState::Playing)
-    {
-        double loopEnd = loopEndSeconds.load();
-        double loopStart = loopStartSeconds.load();
-
-        if (loopEnd > loopStart)
-        {
-            double currentPos = transportSource.getCurrentPosition();
-
-            if (currentPos >= loopEnd)
-            {
-                // Loop back to start
-                juce::MessageManager::callAsync([this, loopStart]()
-                {
-                    if (hasFileLoaded())
-                        transportSource.setPosition(loopStart);
-                    if (hasTrackBLoaded())
-                    {
-                        double durationA = hasFileLoaded() ? transportSource.getLengthInSeconds() : 1.0;
-                        double durationB = transportSourceB.getLengthInSeconds();
-                        if (durationA > 0.0 && durationB > 0.0)
-                        {
-                            double ratio = loopStart / durationA;
-                            transportSourceB.setPosition(ratio * durationB);
-                        }
-                    }
-                });
-            }
-        }
+        // Single file playback (dual track modes, sample-accurate looping)
+        renderSingleFilePlayback(buffer, numSamples);
     }
 
     // Get dry/wet mix amount
     float wetMix = dryWetMix.load();
+    const int latency = processLatency.load();
 
-    // Save dry (original) buffer for A/B comparison
-    juce::AudioBuffer<float> dryBuffer;
-    if (wetMix < 1.0f && audioProcessCallback)
-    {
-        dryBuffer.makeCopyOf(buffer);
-    }
+    // Save dry (original) buffer for A/B comparison. While the processing
+    // has latency the dry copy is kept even when fully wet, so the delay
+    // line's history is current when the mix moves.
+    const bool needsDry = audioProcessCallback && (wetMix < 1.0f || latency > 0);
+    auto dryBuffer = needsDry ? callbackArena.allocateBuffer(numOutputChannels, numSamples)
+                              : juce::AudioBuffer<float>();
+
+    for (int ch = 0; ch < dryBuffer.getNumChannels(); ++ch)
+        dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+    // Line the dry signal up with the processed one
+    if (dryBuffer.getNumChannels() > 0)
+        dryDelay.process(dryBuffer, 0, numSamples, latency);
 
     // Apply audio processing (filters, EQ, VST plugins, etc.)
     if (audioProcessCallback)
@@ -630,23 +580,23 @@ void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChan
     // Write to recording file if recording
     if (recordState.load() == RecordState::Recording)
     {
-        const juce::ScopedLock sl(writerLock);
-        if (recordingWriter != nullptr)
+        // Handshake with stopRecording(): either it sees this flag set,
+        // or we see the writer pointer already cleared
+        audioThreadUsingWriter.store(true);
+
+        if (auto* writer = activeRecordingWriter.load())
         {
             // If we have input channels, record from input; otherwise record output
             if (numInputChannels > 0 && inputChannelData != nullptr)
-            {
-                juce::AudioBuffer<float> inputBuffer(const_cast<float**>(inputChannelData), numInputChannels, numSamples);
-                recordingWriter->write(inputChannelData, numSamples);
-            }
+                writer->write(inputChannelData, numInputChannels, numSamples);
             else
-            {
-                recordingWriter->write(outputChannelData, numSamples);
-            }
+                writer->write(outputChannelData, numOutputChannels, numSamples);
         }
+
+        audioThreadUsingWriter.store(false);
     }
 
-    // Calculate levels for level meter and true peak meter
+    // Calculate levels for level meter
     float leftRMS = 0.0f;
     float leftPeak = 0.0f;
     float rightRMS = 0.0f;
@@ -699,26 +649,22 @@ void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChan
         levelCallback(leftRMS, leftPeak, rightRMS, rightPeak);
     }
 
-    // Push samples to spectrum analyzer (if callback is set)
-    if (spectrumCallback && numOutputChannels > 0 && playState.load() == PlayState::Playing)
+    // Publish the block to the analysis tap (one copy, no per-sample calls)
+    if (numOutputChannels > 0 && playState.load() == PlayState::Playing)
     {
-        // Push mono mix of left and right channels for spectrum analysis
-        const float* leftData = buffer.getReadPointer(0);
-        const float* rightData = numOutputChannels >= 2 ? buffer.getReadPointer(1) : leftData;
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            float monoSample = (leftData[i] + rightData[i]) * 0.5f;
-            spectrumCallback(monoSample);
-        }
+        analysisTap.pushBlock(buffer.getReadPointer(0),
+                              numOutputChannels >= 2 ? buffer.getReadPointer(1) : nullptr,
+                              numSamples);
     }
 
-    // Send true peak values (if callback is set)
-    // Note: This is a simplified implementation. For true inter-sample peak detection,
-    // oversampling should be used, but this provides a good approximation.
+    // Send true peak values (BS.1770-4 Annex 2, 4x oversampled)
     if (truePeakCallback && numOutputChannels > 0 && playState.load() == PlayState::Playing)
     {
-        truePeakCallback(leftPeak, rightPeak);
+        truePeakDetector.processBlock(buffer);
+
+        float leftTruePeak = truePeakDetector.getBlockPeak(0);
+        float rightTruePeak = numOutputChannels >= 2 ? truePeakDetector.getBlockPeak(1) : leftTruePeak;
+        truePeakCallback(leftTruePeak, rightTruePeak);
     }
 
     // Calculate and send phase correlation (if callback is set)
@@ -752,117 +698,214 @@ void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChan
         phaseCorrelationCallback(correlation);
     }
 
-    // Calculate and send loudness (if callback is set)
+    // Loudness (BS.1770-4). Measured on every played block, so the 100 ms
+    // hops and the gated integrated value don't depend on the buffer size.
+    if (loudnessResetPending.exchange(false))
+        loudnessAnalyzer.reset();
+
     if (loudnessCallback && numOutputChannels > 0 && playState.load() == PlayState::Playing)
     {
-        // Initialize loudness buffer if needed
-        if (loudnessBuffer.empty() && preparedSampleRate > 0)
+        loudnessAnalyzer.processBlock(buffer);
+
+        loudnessCallback(loudnessAnalyzer.getIntegratedLoudness(),
+                         loudnessAnalyzer.getShortTermLoudness(),
+                         loudnessAnalyzer.getMomentaryLoudness(),
+                         loudnessAnalyzer.getLoudnessRange());
+    }
+}
+
+//==============================================================================
+// Single file rendering (audio thread)
+
+void AudioEngine::renderTracks(juce::AudioBuffer<float>& dest, int startSample, int numSamples,
+                               juce::AudioBuffer<float>& trackBScratch)
+{
+    juce::AudioSourceChannelInfo channelInfo(&dest, startSample, numSamples);
+
+    // Handle dual track playback based on active track setting
+    auto track = activeTrack.load();
+
+    if (track == ActiveTrack::A && hasFileLoaded())
+    {
+        // Track A only
+        filePlayer.getNextAudioBlock(channelInfo);
+    }
+    else if (track == ActiveTrack::B && hasTrackBLoaded())
+    {
+        // Track B only
+        filePlayerB.getNextAudioBlock(channelInfo);
+    }
+    else if (track == ActiveTrack::Both)
+    {
+        // Mix both tracks
+        float balance = trackMixBalance.load();
+        float gainA = 1.0f - balance;  // 0.0 -> 1.0, 1.0 -> 0.0
+        float gainB = balance;          // 0.0 -> 0.0, 1.0 -> 1.0
+
+        // Get Track A audio
+        if (hasFileLoaded())
+        {
+            filePlayer.getNextAudioBlock(channelInfo);
+            dest.applyGain(startSample, numSamples, gainA);
+        }
+
+        // Get Track B audio (into arena scratch) and mix
+        if (hasTrackBLoaded() && trackBScratch.getNumChannels() > 0
+            && numSamples <= trackBScratch.getNumSamples())
         {
-            int blockSamples = (int)(preparedSampleRate * BLOCK_SIZE_MS / 1000.0);
-            int numBlocks = SHORT_TERM_BLOCKS + 10;  // Extra space for circular buffer
-            loudnessBuffer.resize(numBlocks, -70.0f);
+            juce::AudioSourceChannelInfo channelInfoB(&trackBScratch, 0, numSamples);
+            filePlayerB.getNextAudioBlock(channelInfoB);
+
+            int numChannels = juce::jmin(dest.getNumChannels(), trackBScratch.getNumChannels());
+            for (int ch = 0; ch < numChannels; ++ch)
+                dest.addFrom(ch, startSample, trackBScratch, ch, 0, numSamples, gainB);
         }
+    }
+    else if (hasFileLoaded())
+    {
+        // Default: play Track A if available
+        filePlayer.getNextAudioBlock(channelInfo);
+    }
+}
 
-        // Calculate mean square for this buffer (simplified without K-weighting)
-        double meanSquare = 0.0;
-        int sampleCount = 0;
+void AudioEngine::renderSingleFilePlayback(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    auto track = activeTrack.load();
+    bool useA = hasFileLoaded() && track != ActiveTrack::B;
+    bool useB = hasTrackBLoaded() && track != ActiveTrack::A;
+
+    // Track B scratch for "Both" mode, long enough for the loop tail as well
+    auto trackBScratch = (track == ActiveTrack::Both && hasTrackBLoaded())
+                             ? callbackArena.allocateBuffer(buffer.getNumChannels(),
+                                                            juce::jmax(numSamples, loopCrossfadeSamples))
+                             : juce::AudioBuffer<float>();
+
+    double loopStart = loopStartSeconds.load();
+    double loopEnd = loopEndSeconds.load();
+
+    bool looping = loopEnabled.load()
+                && playState.load() == PlayState::Playing
+                && loopEnd > loopStart
+                && preparedSampleRate > 0.0
+                && (useA || useB);
+
+    if (!looping)
+    {
+        loopTailLength = 0;
+        renderTracks(buffer, 0, numSamples, trackBScratch);
+        return;
+    }
+
+    // Loop range in each track's samples. Track B maps proportionally onto
+    // Track A's timeline, matching setPositionSeconds().
+    auto lengthA = filePlayer.getTotalLength();
+    auto lengthB = filePlayerB.getTotalLength();
+    double scaleB = (lengthA > 0 && lengthB > 0) ? (double)lengthB / (double)lengthA : 1.0;
+
+    auto loopStartA = (juce::int64)(loopStart * preparedSampleRate);
+    auto loopEndA = (juce::int64)(loopEnd * preparedSampleRate);
+    auto loopStartB = (juce::int64)((double)loopStartA * scaleB);
+    auto loopEndB = (juce::int64)((double)loopEndA * scaleB);
+
+    // The leading track decides where the block is split
+    auto& reference = useA ? filePlayer : filePlayerB;
+    auto referenceStart = useA ? loopStartA : loopStartB;
+    auto referenceEnd = useA ? loopEndA : loopEndB;
+
+    // A loop end past the end of the file wraps at the last sample
+    auto referenceLength = useA ? lengthA : lengthB;
+    if (referenceLength > 0)
+        referenceEnd = juce::jmin(referenceEnd, referenceLength);
+
+    if (referenceEnd <= referenceStart)
+    {
+        loopTailLength = 0;
+        renderTracks(buffer, 0, numSamples, trackBScratch);
+        return;
+    }
+
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        auto samplesUntilLoopEnd = referenceEnd - reference.getNextReadPosition();
 
-        for (int ch = 0; ch < numOutputChannels; ++ch)
+        if (samplesUntilLoopEnd > 0)
         {
-            const float* channelData = buffer.getReadPointer(ch);
-            for (int i = 0; i < numSamples; ++i)
-            {
-                double sample = channelData[i];
-                meanSquare += sample * sample;
-                sampleCount++;
-            }
+            int numThisTime = (int)juce::jmin((juce::int64)(numSamples - offset), samplesUntilLoopEnd);
+
+            renderTracks(buffer, offset, numThisTime, trackBScratch);
+            applyLoopCrossfade(buffer, offset, numThisTime);
+
+            offset += numThisTime;
+            continue;
         }
 
-        if (sampleCount > 0)
+        // Exactly at the loop end: keep the audio just past it for the
+        // crossfade, then wrap both tracks on the same output sample
+        captureLoopTail(trackBScratch, (int)juce::jmin((juce::int64)loopCrossfadeSamples,
+                                                       referenceEnd - referenceStart));
+
+        if (useA)
+            filePlayer.setNextReadPosition(loopStartA);
+        if (useB)
+            filePlayerB.setNextReadPosition(loopStartB);
+
+        // Seek did not take (e.g. loop start beyond the file): play on unlooped
+        if (reference.getNextReadPosition() >= referenceEnd)
         {
-            meanSquare /= sampleCount;
+            renderTracks(buffer, offset, numSamples - offset, trackBScratch);
+            break;
+        }
+    }
+}
 
-            // Convert to LUFS (simplified formula: LUFS = -0.691 + 10 * log10(MS))
-            float blockLoudness = -70.0f;
-            if (meanSquare > 0.0)
-            {
-                blockLoudness = -0.691f + 10.0f * std::log10((float)meanSquare);
-            }
+void AudioEngine::captureLoopTail(juce::AudioBuffer<float>& trackBScratch, int length)
+{
+    length = juce::jmin(length, loopTailBuffer.getNumSamples());
 
-            // Store in circular buffer
-            loudnessBuffer[loudnessBufferIndex] = blockLoudness;
-            loudnessBufferIndex = (loudnessBufferIndex + 1) % loudnessBuffer.size();
+    if (length <= 0)
+    {
+        loopTailLength = 0;
+        return;
+    }
 
-            // Calculate momentary loudness (400ms = 4 blocks)
-            float momentary = -70.0f;
-            double momentarySum = 0.0;
-            int momentaryCount = 0;
-            for (int i = 0; i < MOMENTARY_BLOCKS && i < loudnessBuffer.size(); ++i)
-            {
-                int idx = (loudnessBufferIndex - 1 - i + loudnessBuffer.size()) % loudnessBuffer.size();
-                if (loudnessBuffer[idx] > -69.0f)
-                {
-                    // Convert back to linear, sum, then convert to LUFS
-                    double linear = std::pow(10.0, (loudnessBuffer[idx] + 0.691) / 10.0);
-                    momentarySum += linear;
-                    momentaryCount++;
-                }
-            }
-            if (momentaryCount > 0)
-            {
-                momentary = -0.691f + 10.0f * std::log10((float)(momentarySum / momentaryCount));
-            }
+    loopTailBuffer.clear();
+    renderTracks(loopTailBuffer, 0, length, trackBScratch);
 
-            // Calculate short-term loudness (3s = 30 blocks)
-            float shortTerm = -70.0f;
-            double shortTermSum = 0.0;
-            int shortTermCount = 0;
-            for (int i = 0; i < SHORT_TERM_BLOCKS && i < loudnessBuffer.size(); ++i)
-            {
-                int idx = (loudnessBufferIndex - 1 - i + loudnessBuffer.size()) % loudnessBuffer.size();
-                if (loudnessBuffer[idx] > -69.0f)
-                {
-                    double linear = std::pow(10.0, (loudnessBuffer[idx] + 0.691) / 10.0);
-                    shortTermSum += linear;
-                    shortTermCount++;
-                }
-            }
-            if (shortTermCount > 0)
-            {
-                shortTerm = -0.691f + 10.0f * std::log10((float)(shortTermSum / shortTermCount));
-            }
+    loopTailLength = length;
+    loopTailPosition = 0;
+}
 
-            // Calculate integrated loudness (running average)
-            sumSquaredSamples += meanSquare;
-            totalSampleCount++;
-            float integrated = -70.0f;
-            if (totalSampleCount > 0)
-            {
-                double avgMeanSquare = sumSquaredSamples / totalSampleCount;
-                if (avgMeanSquare > 0.0)
-                {
-                    integrated = -0.691f + 10.0f * std::log10((float)avgMeanSquare);
-                }
-            }
+void AudioEngine::applyLoopCrossfade(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    int numToMix = juce::jmin(numSamples, loopTailLength - loopTailPosition);
+    if (numToMix <= 0 || loopFadeCurve.empty())
+        return;
 
-            // Calculate loudness range (simplified: difference between 95th and 10th percentile)
-            float lra = 0.0f;
-            if (loudnessBuffer.size() > 10)
-            {
-                std::vector<float> sortedBuffer = loudnessBuffer;
-                std::sort(sortedBuffer.begin(), sortedBuffer.end());
-                int idx10 = (int)(sortedBuffer.size() * 0.10f);
-                int idx95 = (int)(sortedBuffer.size() * 0.95f);
-                if (sortedBuffer[idx10] > -69.0f && sortedBuffer[idx95] > -69.0f)
-                {
-                    lra = sortedBuffer[idx95] - sortedBuffer[idx10];
-                }
-            }
+    // Equal-power: the loop start fades in while the audio past the end fades out
+    int numChannels = juce::jmin(buffer.getNumChannels(), loopTailBuffer.getNumChannels());
+    int curveSize = (int)loopFadeCurve.size();
+
+    for (int i = 0; i < numToMix; ++i)
+    {
+        int tailIndex = loopTailPosition + i;
+        int curveIndex = loopTailLength > 1 ? tailIndex * (curveSize - 1) / (loopTailLength - 1) : curveSize - 1;
 
-            // Send loudness values
-            loudnessCallback(integrated, shortTerm, momentary, lra);
+        float fadeIn = loopFadeCurve[(size_t)curveIndex];
+        float fadeOut = loopFadeCurve[(size_t)(curveSize - 1 - curveIndex)];
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = buffer.getWritePointer(ch, startSample);
+            data[i] = data[i] * fadeIn + loopTailBuffer.getSample(ch, tailIndex) * fadeOut;
         }
     }
+
+    loopTailPosition += numToMix;
+
+    if (loopTailPosition >= loopTailLength)
+        loopTailLength = 0;
 }
 
 void AudioEngine::audioDeviceAboutToStart(juce::AudioIODevice* device)
@@ -873,7 +916,8 @@ void AudioEngine::audioDeviceAboutToStart(juce::AudioIODevice* device)
     preparedSampleRate = device->getCurrentSampleRate();
     preparedBlockSize = device->getCurrentBufferSizeSamples();
 
-    prepareToPlay(preparedSampleRate, preparedBlockSize);
+    prepareToPlay(preparedSampleRate, preparedBlockSize,
+                  device->getActiveOutputChannels().countNumberOfSetBits());
 
     // Notify listeners about device start (for preparing external processors)
     if (deviceStartedCallback)
@@ -886,54 +930,26 @@ void AudioEngine::audioDeviceStopped()
 }
 
 //==============================================================================
-void AudioEngine::changeListenerCallback(juce::ChangeBroadcaster* source)
+void AudioEngine::checkPlaybackFinished()
 {
-    // Check if playback has finished for Track A
-    if (source == &transportSource && playState.load() == PlayState::Playing)
-    {
-        auto track = activeTrack.load();
-        bool trackAFinished = transportSource.hasStreamFinished();
-        bool trackBFinished = !hasTrackBLoaded() || transportSourceB.hasStreamFinished();
-
-        // Stop only if both relevant tracks have finished
-        bool shouldStop = false;
-        if (track == ActiveTrack::A && trackAFinished)
-            shouldStop = true;
-        else if (track == ActiveTrack::B && trackBFinished)
-            shouldStop = true;
-        else if (track == ActiveTrack::Both && trackAFinished && trackBFinished)
-            shouldStop = true;
-
-        if (shouldStop)
-        {
-            juce::MessageManager::callAsync([this]()
-            {
-                stop();
-            });
-        }
-    }
-
-    // Check if playback has finished for Track B
-    if (source == &transportSourceB && playState.load() == PlayState::Playing)
-    {
-        auto track = activeTrack.load();
-        bool trackAFinished = !hasFileLoaded() || transportSource.hasStreamFinished();
-        bool trackBFinished = transportSourceB.hasStreamFinished();
-
-        bool shouldStop = false;
-        if (track == ActiveTrack::B && trackBFinished)
-            shouldStop = true;
-        else if (track == ActiveTrack::Both && trackAFinished && trackBFinished)
-            shouldStop = true;
+    if (playState.load() != PlayState::Playing)
+        return;
 
-        if (shouldStop)
-        {
-            juce::MessageManager::callAsync([this]()
-            {
-                stop();
-            });
-        }
-    }
+    auto track = activeTrack.load();
+    bool trackAFinished = !hasFileLoaded() || filePlayer.hasStreamFinished();
+    bool trackBFinished = !hasTrackBLoaded() || filePlayerB.hasStreamFinished();
+
+    // Stop only if all relevant tracks have finished
+    bool shouldStop = false;
+    if (track == ActiveTrack::A && trackAFinished)
+        shouldStop = true;
+    else if (track == ActiveTrack::B && trackBFinished)
+        shouldStop = true;
+    else if (track == ActiveTrack::Both && trackAFinished && trackBFinished)
+        shouldStop = true;
+
+    if (shouldStop)
+        stop();
 }
 
 //==============================================================================
@@ -948,15 +964,46 @@ void AudioEngine::showError(const juce::String& message)
     }
 }
 
-void AudioEngine::prepareToPlay(double sampleRate, int blockSize)
+void AudioEngine::prepareToPlay(double sampleRate, int blockSize, int numOutputChannels)
 {
-    // Prepare Track A
-    transportSource.prepareToPlay(blockSize, sampleRate);
-    if (resamplingSource != nullptr)
-        resamplingSource->prepareToPlay(blockSize, sampleRate);
+    // Arena for the callback's temporary buffers: Track B and the dry copy.
+    // Twice the block size leaves headroom for devices that deliver
+    // oversized blocks.
+    callbackArena.prepare(juce::jmax(2, numOutputChannels),
+                          juce::jmax(blockSize * 2, 4096),
+                          2);
+
+    // Dry path delay, up to the longest chain latency followed
+    dryDelay.prepare(juce::jmax(2, numOutputChannels),
+                     juce::roundToInt(sampleRate * maxDryDelaySeconds),
+                     juce::jmax(blockSize * 2, 4096));
+
+    // Loop crossfade: tail buffer and equal-power fade-in curve
+    loopCrossfadeSamples = juce::jlimit(16, 2048, (int)(sampleRate * loopCrossfadeMs / 1000.0));
+    loopTailBuffer.setSize(juce::jmax(2, numOutputChannels), loopCrossfadeSamples);
+    loopTailBuffer.clear();
+    loopTailLength = 0;
+    loopTailPosition = 0;
+
+    loopFadeCurve.resize((size_t)loopCrossfadeSamples);
+    for (int i = 0; i < loopCrossfadeSamples; ++i)
+    {
+        double phase = (i + 0.5) / loopCrossfadeSamples;
+        loopFadeCurve[(size_t)i] = (float)std::sin(phase * juce::MathConstants<double>::halfPi);
+    }
+
+    // Loudness measurement (K-weighting is sample-rate dependent)
+    loudnessAnalyzer.prepare(sampleRate, juce::jmax(1, numOutputChannels));
+    loudnessResetPending.store(false);
+
+    // True peak measurement (4x polyphase interpolator)
+    truePeakDetector.prepare(juce::jmax(1, numOutputChannels));
+
+    // Prepare Track A (the player prepares its resampling source)
+    filePlayer.prepareToPlay(blockSize, sampleRate);
 
     // Prepare Track B
-    transportSourceB.prepareToPlay(blockSize, sampleRate);
+    filePlayerB.prepareToPlay(blockSize, sampleRate);
 }
 
 //==============================================================================
@@ -1017,11 +1064,10 @@ bool AudioEngine::startRecording(const juce::File& outputFile)
     if (!recordingThread.isThreadRunning())
         recordingThread.startThread();
 
-    // Create threaded writer for better performance
-    {
-        const juce::ScopedLock sl(writerLock);
-        recordingWriter.reset(new juce::AudioFormatWriter::ThreadedWriter(writer.release(), recordingThread, 32768));
-    }
+    // Hand the writer to the audio thread through a lock-free FIFO
+    recordingWriter = std::make_unique<RecordingWriter>(std::move(writer));
+    recordingThread.addTimeSliceClient(recordingWriter.get());
+    activeRecordingWriter.store(recordingWriter.get());
 
     recordState.store(RecordState::Recording);
     return true;
@@ -1034,9 +1080,15 @@ void AudioEngine::stopRecording()
 
     recordState.store(RecordState::Stopped);
 
+    // Detach the writer, then wait out a callback that may still be using it
+    activeRecordingWriter.store(nullptr);
+    while (audioThreadUsingWriter.load())
+        juce::Thread::yield();
+
     // Flush and close the writer
+    if (recordingWriter != nullptr)
     {
-        const juce::ScopedLock sl(writerLock);
+        recordingThread.removeTimeSliceClient(recordingWriter.get());
         recordingWriter.reset();
     }
 }
@@ -1058,10 +1110,11 @@ void AudioEngine::resumeRecording()
 void AudioEngine::releaseResources()
 {
     // Release Track A
-    transportSource.releaseResources();
-    if (resamplingSource != nullptr)
-        resamplingSource->releaseResources();
+    filePlayer.releaseResources();
 
     // Release Track B
-    transportSourceB.releaseResources();
+    filePlayerB.releaseResources();
+
+    callbackArena.release();
+    dryDelay.release();
 }
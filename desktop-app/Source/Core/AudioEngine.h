@@ -14,12 +14,21 @@
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_audio_utils/juce_audio_utils.h>
+#include "AnalysisTap.h"
+#include "FilePlayer.h"
+#include "MappedAudioReader.h"
+#include "RealtimeArena.h"
+#include "RealtimeSafety.h"
+#include "RecordingWriter.h"
+#include "SincResamplingSource.h"
+#include "../DSP/CompensationDelay.h"
+#include "../DSP/LoudnessAnalyzer.h"
+#include "../DSP/TruePeakDetector.h"
 #include <atomic>
 #include <functional>
 #include <vector>
 
-class AudioEngine : public juce::AudioIODeviceCallback,
-                    public juce::ChangeListener
+class AudioEngine : public juce::AudioIODeviceCallback
 {
 public:
     //==========================================================================
@@ -74,6 +83,10 @@ class AudioEngine : public juce::AudioIODeviceCallback,
     void setTrackMixBalance(float balance);  // 0.0 = A only, 1.0 = B only
     float getTrackMixBalance() const { return trackMixBalance.load(); }
 
+    // Sample-rate conversion for files whose rate differs from the device
+    void setResamplingQuality(SincResampler::Quality quality);
+    SincResampler::Quality getResamplingQuality() const { return resamplingQuality; }
+
     //==========================================================================
     // Playback control
     void play();
@@ -83,7 +96,8 @@ class AudioEngine : public juce::AudioIODeviceCallback,
     void setPositionSeconds(double seconds);  // Seek to time in seconds
 
     //==========================================================================
-    // Loop/Range playback
+    // Loop/Range playback. The wrap is sample-accurate: the audio callback
+    // splits the block at the loop end and crossfades into the loop start.
     void setLoopEnabled(bool enabled);
     bool isLoopEnabled() const { return loopEnabled.load(); }
 
@@ -147,6 +161,21 @@ class AudioEngine : public juce::AudioIODeviceCallback,
     void setDryWetMix(float wetAmount) { dryWetMix.store(juce::jlimit(0.0f, 1.0f, wetAmount)); }
     float getDryWetMix() const { return dryWetMix.load(); }
 
+    // Latency of the audio process callback (its plugin chain), in
+    // samples. The dry signal is delayed by as much, up to
+    // maxDryDelaySeconds, so mixes and A/B switches compare aligned audio
+    // rather than comb filtering. Owners update it as the chain changes.
+    void setProcessLatency(int samples) { processLatency.store(juce::jmax(0, samples)); }
+    int getProcessLatency() const { return processLatency.load(); }
+
+    static constexpr double maxDryDelaySeconds = 1.0;
+
+    //==========================================================================
+    // Analysis tap: stereo output blocks for displays and analyzers.
+    // Create an AnalysisTap::Reader on it and drain from any non-audio thread.
+    AnalysisTap& getAnalysisTap() { return analysisTap; }
+    const AnalysisTap& getAnalysisTap() const { return analysisTap; }
+
     //==========================================================================
     // Callbacks
     using ErrorCallback = std::function<void(const juce::String&)>;
@@ -155,9 +184,6 @@ class AudioEngine : public juce::AudioIODeviceCallback,
     using LevelCallback = std::function<void(float, float, float, float)>;  // leftRMS, leftPeak, rightRMS, rightPeak
     void setLevelCallback(LevelCallback callback) { levelCallback = callback; }
 
-    using SpectrumCallback = std::function<void(float)>;  // sample for FFT analysis
-    void setSpectrumCallback(SpectrumCallback callback) { spectrumCallback = callback; }
-
     using TruePeakCallback = std::function<void(float, float)>;  // leftPeak, rightPeak
     void setTruePeakCallback(TruePeakCallback callback) { truePeakCallback = callback; }
 
@@ -167,6 +193,9 @@ class AudioEngine : public juce::AudioIODeviceCallback,
     using LoudnessCallback = std::function<void(float, float, float, float)>;  // integrated, short-term, momentary, LRA
     void setLoudnessCallback(LoudnessCallback callback) { loudnessCallback = callback; }
 
+    // Restart integrated loudness / LRA (applied by the audio thread on its next block)
+    void resetLoudness() { loudnessResetPending.store(true); }
+
     // Audio processing callback (for filters, EQ, etc.)
     using AudioProcessCallback = std::function<void(juce::AudioBuffer<float>&)>;
     void setAudioProcessCallback(AudioProcessCallback callback) { audioProcessCallback = callback; }
@@ -187,31 +216,42 @@ class AudioEngine : public juce::AudioIODeviceCallback,
     void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
     void audioDeviceStopped() override;
 
-    //==========================================================================
-    // ChangeListener implementation (for transport state changes)
-    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
-
 private:
     //==========================================================================
     void showError(const juce::String& message);
-    void prepareToPlay(double sampleRate, int blockSize);
+
+    // Message thread, when a track plays off its end: stops once every
+    // track being heard has
+    void checkPlaybackFinished();
+    void prepareToPlay(double sampleRate, int blockSize, int numOutputChannels);
     void releaseResources();
 
+    // Single file playback (audio thread). renderSingleFilePlayback() splits
+    // the block at the loop end and wraps within the same callback.
+    void renderSingleFilePlayback(juce::AudioBuffer<float>& buffer, int numSamples);
+    void renderTracks(juce::AudioBuffer<float>& dest, int startSample, int numSamples,
+                      juce::AudioBuffer<float>& trackBScratch);
+    void captureLoopTail(juce::AudioBuffer<float>& trackBScratch, int length);
+    void applyLoopCrossfade(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
     //==========================================================================
     juce::AudioDeviceManager deviceManager;
     juce::AudioFormatManager formatManager;
 
     // Track A (main track)
-    juce::AudioTransportSource transportSource;
+    FilePlayer filePlayer;
     std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
-    std::unique_ptr<juce::ResamplingAudioSource> resamplingSource;
+    std::unique_ptr<SincResamplingSource> resamplingSource;  // Reads readerSource
     juce::File currentFile;
 
     // Track B (comparison track)
-    juce::AudioTransportSource transportSourceB;
+    FilePlayer filePlayerB;
     std::unique_ptr<juce::AudioFormatReaderSource> readerSourceB;
+    std::unique_ptr<SincResamplingSource> resamplingSourceB;  // Reads readerSourceB
     juce::File trackBFile;
 
+    SincResampler::Quality resamplingQuality { SincResampler::Quality::high };
+
     // Mixer for combining tracks
     juce::MixerAudioSource mixerSource;
 
@@ -226,43 +266,60 @@ class AudioEngine : public juce::AudioIODeviceCallback,
 
     ErrorCallback errorCallback;
     LevelCallback levelCallback;
-    SpectrumCallback spectrumCallback;
     TruePeakCallback truePeakCallback;
     PhaseCorrelationCallback phaseCorrelationCallback;
     LoudnessCallback loudnessCallback;
     AudioProcessCallback audioProcessCallback;
     DeviceStartedCallback deviceStartedCallback;
 
+    // Output tap for displays and analyzers (lock-free, block based)
+    AnalysisTap analysisTap;
+
     bool initialized { false };
     double preparedSampleRate { 0.0 };
     int preparedBlockSize { 0 };
 
+    // Scratch memory for the device callback (Track B mix, dry copy).
+    // Sized in prepareToPlay(), reset at the start of every callback.
+    RealtimeArena callbackArena;
+
     // Master gain control
     std::atomic<float> masterGain { 1.0f };  // Linear gain (1.0 = 0dB)
 
     // Dry/Wet mix control (0.0 = dry, 1.0 = wet)
     std::atomic<float> dryWetMix { 1.0f };  // Default to fully wet (processed)
 
+    // Dry path latency compensation (delay line sized in prepareToPlay)
+    std::atomic<int> processLatency { 0 };
+    CompensationDelay dryDelay;
+
     // Loop/Range playback
     std::atomic<bool> loopEnabled { false };
     std::atomic<double> loopStartSeconds { 0.0 };
     std::atomic<double> loopEndSeconds { 0.0 };
 
+    // Loop wrap crossfade (audio thread state, sized in prepareToPlay)
+    juce::AudioBuffer<float> loopTailBuffer;     // Audio just past the loop end
+    std::vector<float> loopFadeCurve;            // Equal-power fade-in
+    int loopCrossfadeSamples { 0 };
+    int loopTailLength { 0 };                    // 0 = no crossfade in progress
+    int loopTailPosition { 0 };
+    static constexpr double loopCrossfadeMs = 5.0;
+
     // Recording state
     std::atomic<RecordState> recordState { RecordState::Stopped };
-    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> recordingWriter;
+    std::unique_ptr<RecordingWriter> recordingWriter;         // Owned by the message thread
+    std::atomic<RecordingWriter*> activeRecordingWriter { nullptr };  // Seen by the audio thread
+    std::atomic<bool> audioThreadUsingWriter { false };
     juce::File recordingFile;
-    juce::CriticalSection writerLock;
     juce::TimeSliceThread recordingThread { "Recording Thread" };
 
-    // Loudness measurement state
-    std::vector<float> loudnessBuffer;           // Circular buffer for loudness blocks
-    int loudnessBufferIndex { 0 };
-    double sumSquaredSamples { 0.0 };            // For integrated loudness
-    int totalSampleCount { 0 };
-    static constexpr int MOMENTARY_BLOCKS = 4;   // 400ms / 100ms blocks
-    static constexpr int SHORT_TERM_BLOCKS = 30; // 3s / 100ms blocks
-    static constexpr int BLOCK_SIZE_MS = 100;    // 100ms blocks
+    // Loudness measurement (audio thread)
+    LoudnessAnalyzer loudnessAnalyzer;
+    std::atomic<bool> loudnessResetPending { false };
+
+    // Inter-sample peak measurement (audio thread)
+    TruePeakDetector truePeakDetector;
 
     //==========================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+
+    DiskStreamer.cpp
+
+    Background read-ahead for clip playback implementation
+
+  ==============================================================================
+*/
+
+#include "DiskStreamer.h"
+
+namespace
+{
+    constexpr int minimumCapacity = 16384;  // Samples; well above any device block
+    constexpr int fillChunkSize = 8192;     // Samples read per reader call
+    constexpr int pollIntervalMs = 2;       // Also the worst-case re-prime and wake latency
+    constexpr int parkedIntervalMs = 250;   // Parked streams are woken when primed
+}
+
+//==============================================================================
+// Consumers can't wake a parked stream without taking the thread's client
+// list lock, so they flag it instead; the thread's waker client, polled as
+// often as an active stream, moves the flagged streams to the front
+struct DiskStreamer::ReaderThread : private juce::TimeSliceClient
+{
+    explicit ReaderThread(const juce::String& name)
+        : thread(name)
+    {
+        thread.addTimeSliceClient(this);
+        thread.startThread(juce::Thread::Priority::high);
+    }
+
+    ~ReaderThread() override
+    {
+        thread.stopThread(2000);
+    }
+
+    void addStream(Stream& stream)
+    {
+        {
+            const juce::ScopedLock sl(streamsLock);
+            streams.add(&stream);
+        }
+
+        thread.addTimeSliceClient(&stream);
+    }
+
+    // Waits for a fill or a wake in progress to finish
+    void removeStream(Stream& stream)
+    {
+        {
+            const juce::ScopedLock sl(streamsLock);
+            streams.removeFirstMatchingValue(&stream);
+        }
+
+        thread.removeTimeSliceClient(&stream);
+    }
+
+    // Consumer side
+    void requestWake(Stream& stream) noexcept
+    {
+        stream.wakeRequested.store(true, std::memory_order_relaxed);
+        wakePending.store(true, std::memory_order_release);
+    }
+
+    int useTimeSlice() override
+    {
+        if (wakePending.exchange(false, std::memory_order_acquire))
+        {
+            const juce::ScopedLock sl(streamsLock);
+
+            for (auto* stream : streams)
+                if (stream->wakeRequested.exchange(false, std::memory_order_relaxed))
+                    thread.moveToFrontOfQueue(stream);
+        }
+
+        return pollIntervalMs;
+    }
+
+    juce::TimeSliceThread thread;
+    juce::CriticalSection streamsLock;  // Message thread vs reader thread only
+    juce::Array<Stream*> streams;
+    std::atomic<bool> wakePending { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReaderThread)
+};
+
+//==============================================================================
+DiskStreamer::DiskStreamer(int numReaderThreads)
+{
+    if (numReaderThreads <= 0)
+        numReaderThreads = juce::jlimit(2, 4, juce::SystemStats::getNumCpus() / 2);
+
+    for (int i = 0; i < numReaderThreads; ++i)
+        threads.add(new ReaderThread("Disk Streamer " + juce::String(i + 1)));
+}
+
+DiskStreamer::~DiskStreamer()
+{
+    jassert(numStreams.load() == 0);
+}
+
+DiskStreamer::ReaderThread* DiskStreamer::addStream(Stream& stream)
+{
+    // Round-robin; streams sharing a mapped reader may read it from
+    // different threads at once
+    auto* readerThread = threads[nextThread.fetch_add(1) % threads.size()];
+    readerThread->addStream(stream);
+    ++numStreams;
+    return readerThread;
+}
+
+//==============================================================================
+DiskStreamer::Stream::Stream(DiskStreamer& owner, ReaderSource readerSource, double sampleRate,
+                             int numChannelsToUse, double readAheadSeconds)
+    : streamer(owner),
+      acquireReader(std::move(readerSource)),
+      numChannels(juce::jmax(1, numChannelsToUse)),
+      capacity(juce::jmax(minimumCapacity, (int)(sampleRate * readAheadSeconds)))
+{
+    readerThread = streamer.addStream(*this);
+}
+
+DiskStreamer::Stream::~Stream()
+{
+    readerThread->removeStream(*this);
+    --streamer.numStreams;
+}
+
+//==============================================================================
+void DiskStreamer::Stream::prepareFor(juce::int64 sourcePosition) noexcept
+{
+    if (!isPreparedFor(sourcePosition))
+        prime(sourcePosition);
+}
+
+bool DiskStreamer::Stream::isPreparedFor(juce::int64 sourcePosition) const noexcept
+{
+    return !consumerParked && sourcePosition >= consumerPosition
+        && sourcePosition < consumerPosition + capacity / 2;
+}
+
+void DiskStreamer::Stream::park() noexcept
+{
+    if (consumerParked)
+        return;
+
+    consumerParked = true;
+    requestedPosition.store(-1, std::memory_order_relaxed);
+    requestedGeneration.store(++consumerGeneration, std::memory_order_release);
+}
+
+void DiskStreamer::Stream::prime(juce::int64 sourcePosition) noexcept
+{
+    const bool wasParked = consumerParked;
+
+    consumerParked = false;
+    consumerPosition = sourcePosition;
+
+    readPosition.store(sourcePosition, std::memory_order_relaxed);
+    requestedPosition.store(sourcePosition, std::memory_order_relaxed);
+    requestedGeneration.store(++consumerGeneration, std::memory_order_release);
+
+    // A parked stream is only polled now and then; an active one is already
+    // polled every few milliseconds
+    if (wasParked)
+        wake();
+}
+
+void DiskStreamer::Stream::wake() noexcept
+{
+    // Picked up within pollIntervalMs
+    readerThread->requestWake(*this);
+}
+
+bool DiskStreamer::Stream::read(juce::AudioBuffer<float>& dest, int destStartSample,
+                                int numSamples, juce::int64 sourcePosition) noexcept
+{
+    if (numSamples <= 0)
+        return true;
+
+    jassert(numSamples <= capacity);
+
+    const bool served = !consumerParked
+                     && servedGeneration.load(std::memory_order_acquire) == consumerGeneration;
+
+    if (served && sourcePosition >= consumerPosition
+        && sourcePosition + numSamples <= validEnd.load(std::memory_order_acquire))
+    {
+        // Up to two segments of the ring
+        int ringIndex = (int)(sourcePosition % capacity);
+        int firstPart = juce::jmin(numSamples, capacity - ringIndex);
+
+        // Raw pointers only: the ring's AudioBuffer flags belong to the reader thread
+        for (int ch = 0; ch < dest.getNumChannels(); ++ch)
+        {
+            int srcCh = juce::jmin(ch, numChannels - 1);
+            dest.copyFrom(ch, destStartSample, ring.getReadPointer(srcCh, ringIndex), firstPart);
+
+            if (firstPart < numSamples)
+                dest.copyFrom(ch, destStartSample + firstPart, ring.getReadPointer(srcCh, 0), numSamples - firstPart);
+        }
+
+        // Frees the space behind us for the reader thread
+        consumerPosition = sourcePosition + numSamples;
+        readPosition.store(consumerPosition, std::memory_order_release);
+        return true;
+    }
+
+    // Underrun
+    dest.clear(destStartSample, numSamples);
+    ++streamer.underruns;
+
+    const auto nextPosition = sourcePosition + numSamples;
+
+    if (isPreparedFor(sourcePosition))
+    {
+        // Reader thread is behind: skip what we missed so it catches up
+        consumerPosition = nextPosition;
+        readPosition.store(consumerPosition, std::memory_order_release);
+
+        // Not even served yet: the wake may have landed while the thread was
+        // still scheduling the parked stream's next poll
+        if (!served)
+            wake();
+    }
+    else
+    {
+        // Seek, or first read after parking
+        prime(nextPosition);
+    }
+
+    return false;
+}
+
+//==============================================================================
+int DiskStreamer::Stream::useTimeSlice()
+{
+    auto generation = requestedGeneration.load(std::memory_order_acquire);
+
+    if (generation != producerGeneration)
+    {
+        producerGeneration = generation;
+        auto target = requestedPosition.load(std::memory_order_relaxed);
+
+        // The consumer has moved to the new generation, so nothing reads the
+        // ring until we serve it
+        if (target < 0)
+        {
+            producerParked = true;
+            ring.setSize(0, 0);
+            reader.reset();
+        }
+        else
+        {
+            if (producerParked)
+                reader = acquireReader();
+
+            producerParked = false;
+
+            if (ring.getNumSamples() != capacity)
+                ring.setSize(numChannels, capacity);
+
+            writePosition = target;
+            validEnd.store(target, std::memory_order_relaxed);
+        }
+
+        servedGeneration.store(generation, std::memory_order_release);
+    }
+
+    // Woken by prime(); a request that arrived while parking is served now
+    if (producerParked)
+        return requestedGeneration.load(std::memory_order_acquire) != producerGeneration ? 0 : parkedIntervalMs;
+
+    return fill();
+}
+
+int DiskStreamer::Stream::fill()
+{
+    auto consumed = readPosition.load(std::memory_order_acquire);
+
+    // Never write over data the consumer may still read
+    auto start = juce::jmax(writePosition, consumed);
+    auto end = consumed + capacity;
+
+    if (start >= end)
+        return pollIntervalMs;
+
+    int numToRead = (int)juce::jmin((juce::int64)fillChunkSize, end - start);
+    int ringIndex = (int)(start % capacity);
+    int firstPart = juce::jmin(numToRead, capacity - ringIndex);
+
+    auto* const* channels = ring.getArrayOfWritePointers();
+    juce::AudioBuffer<float> firstSegment(channels, numChannels, ringIndex, firstPart);
+    juce::AudioBuffer<float> secondSegment(channels, numChannels, 0, numToRead - firstPart);
+
+    if (reader != nullptr)
+    {
+        reader->read(&firstSegment, 0, firstPart, start, true, true);
+
+        if (firstPart < numToRead)
+            reader->read(&secondSegment, 0, numToRead - firstPart, start + firstPart, true, true);
+    }
+    else
+    {
+        firstSegment.clear();
+        secondSegment.clear();
+    }
+
+    writePosition = start + numToRead;
+    validEnd.store(writePosition, std::memory_order_release);
+
+    // Keep going straight away while the ring isn't full, unless a new
+    // request arrived
+    return writePosition < end ? 0 : pollIntervalMs;
+}
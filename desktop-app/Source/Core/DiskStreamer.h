@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    DiskStreamer.h
+
+    Disk streaming for clip playback. Each clip owns a Stream: a read-ahead
+    ring that a pool of background reader threads keeps filled ahead of the
+    clip's play position. The audio thread only copies out of the ring; if
+    the data isn't there yet it outputs silence and counts an underrun, so
+    file I/O latency never reaches the device callback.
+
+    A read outside the buffered window (a seek) re-primes the ring from the
+    new position. Rings are allocated by the reader threads only while a
+    clip is near the play position, and freed again when it is parked; the
+    stream's file reader is acquired and released along with its ring.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class DiskStreamer
+{
+    // A reader thread and the streams it serves
+    struct ReaderThread;
+
+public:
+    //==========================================================================
+    static constexpr double defaultReadAheadSeconds = 1.0;
+
+    // numReaderThreads <= 0 picks a count from the number of CPU cores
+    explicit DiskStreamer(int numReaderThreads = 0);
+
+    // All streams must have been destroyed first
+    ~DiskStreamer();
+
+    //==========================================================================
+    class Stream : private juce::TimeSliceClient
+    {
+    public:
+        // Hands out a reader of the file, called on a reader thread when the
+        // stream is primed after being parked; the reader is released when
+        // it's parked again. A reader given to several streams must keep no
+        // read state (a memory-mapped one), as they read it concurrently.
+        using ReaderSource = std::function<std::shared_ptr<juce::AudioFormatReader>()>;
+
+        Stream(DiskStreamer& owner, ReaderSource acquireReader, double sampleRate,
+               int numChannels, double readAheadSeconds = defaultReadAheadSeconds);
+
+        // Waits for a fill in progress to finish
+        ~Stream() override;
+
+        //======================================================================
+        // Consumer side: one thread at a time (the audio thread, or a thread
+        // holding the lock that serialises it with the audio thread). Wait-free;
+        // a parked stream that is primed is woken by its reader thread.
+
+        // Make sure data from sourcePosition onwards is (or will be) buffered.
+        // Re-primes only if the position is outside the current window.
+        void prepareFor(juce::int64 sourcePosition) noexcept;
+
+        // Whether data from sourcePosition onwards is buffered or on its way
+        bool isPreparedFor(juce::int64 sourcePosition) const noexcept;
+
+        // Drop the buffered data and let the ring be freed
+        void park() noexcept;
+
+        // Copies numSamples from sourcePosition into dest. If they aren't
+        // buffered, clears that region, counts an underrun, re-primes if
+        // needed and returns false.
+        bool read(juce::AudioBuffer<float>& dest, int destStartSample,
+                  int numSamples, juce::int64 sourcePosition) noexcept;
+
+        int getCapacity() const noexcept { return capacity; }
+
+    private:
+        //======================================================================
+        friend class DiskStreamer;
+
+        int useTimeSlice() override;
+        void prime(juce::int64 sourcePosition) noexcept;
+        void wake() noexcept;
+        int fill();
+
+        DiskStreamer& streamer;
+        ReaderThread* readerThread { nullptr };
+        const ReaderSource acquireReader;
+        const int numChannels;
+        const int capacity;
+
+        // Owned by the reader thread; read by the consumer only while its
+        // generation has been served
+        juce::AudioBuffer<float> ring;
+
+        // Consumer -> reader thread
+        std::atomic<juce::uint32> requestedGeneration { 0 };
+        std::atomic<juce::int64> requestedPosition { -1 };  // -1: parked
+        std::atomic<juce::int64> readPosition { 0 };
+        std::atomic<bool> wakeRequested { false };
+
+        // Reader thread -> consumer
+        std::atomic<juce::uint32> servedGeneration { 0 };
+        std::atomic<juce::int64> validEnd { 0 };
+
+        // Consumer only
+        juce::uint32 consumerGeneration { 0 };
+        juce::int64 consumerPosition { 0 };
+        bool consumerParked { true };
+
+        // Reader thread only; reader is nullptr while parked (or if the
+        // file can't be opened, when the ring fills with silence)
+        std::shared_ptr<juce::AudioFormatReader> reader;
+        juce::uint32 producerGeneration { 0 };
+        juce::int64 writePosition { 0 };
+        bool producerParked { true };
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Stream)
+    };
+
+    //==========================================================================
+    // Reads that found no data, since construction
+    juce::int64 getNumUnderruns() const noexcept { return underruns.load(); }
+
+    int getNumReaderThreads() const noexcept { return threads.size(); }
+
+private:
+    //==========================================================================
+    ReaderThread* addStream(Stream& stream);
+
+    juce::OwnedArray<ReaderThread> threads;
+    std::atomic<int> nextThread { 0 };
+    std::atomic<juce::int64> underruns { 0 };
+    std::atomic<int> numStreams { 0 };
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskStreamer)
+};
@@ -10,27 +10,116 @@
 
 #include "EffectChain.h"
 
+namespace
+{
+    constexpr int retiredFreeIntervalMs = 500;
+
+    juce::AudioChannelSet channelSetFor(int numChannels)
+    {
+        auto set = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        return set.size() == numChannels ? set : juce::AudioChannelSet::discreteChannels(numChannels);
+    }
+}
+
 //==============================================================================
-EffectChain::EffectChain()
+class EffectChain::PluginNode : public juce::AudioProcessor
 {
-    processorGraph = std::make_unique<juce::AudioProcessorGraph>();
+public:
+    PluginNode(std::shared_ptr<juce::AudioPluginInstance> instance, std::shared_ptr<PluginLoadMeter> loadMeter)
+        : juce::AudioProcessor(busesFor(*instance)),
+          plugin(std::move(instance)),
+          load(std::move(loadMeter))
+    {
+        setLatencySamples(plugin->getLatencySamples());
+    }
 
-    // Create input/output nodes
-    audioInputNode = processorGraph->addNode(
-        std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
-            juce::AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode))->nodeID;
+    const juce::String getName() const override { return plugin->getName(); }
 
-    audioOutputNode = processorGraph->addNode(
-        std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
-            juce::AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode))->nodeID;
+    // The chain prepares and releases the plugin itself, not each graph
+    void prepareToPlay(double /*sampleRate*/, int /*samplesPerBlock*/) override {}
+    void releaseResources() override {}
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        plugin->processBlock(buffer, midiMessages);
+        measure(start, buffer.getNumSamples());
+    }
+
+    // Lets the plugin keep its latency (and tails) while bypassed
+    void processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        plugin->processBlockBypassed(buffer, midiMessages);
+        measure(start, buffer.getNumSamples());
+    }
+
+    double getTailLengthSeconds() const override { return plugin->getTailLengthSeconds(); }
+    bool acceptsMidi() const override { return plugin->acceptsMidi(); }
+    bool producesMidi() const override { return plugin->producesMidi(); }
+
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int /*index*/) override {}
+    const juce::String getProgramName(int /*index*/) override { return {}; }
+    void changeProgramName(int /*index*/, const juce::String& /*newName*/) override {}
+
+    void getStateInformation(juce::MemoryBlock& /*destData*/) override {}
+    void setStateInformation(const void* /*data*/, int /*sizeInBytes*/) override {}
+
+private:
+    void measure(juce::int64 startTicks, int numSamples) noexcept
+    {
+        // Offline renders run as fast as they can; not a load
+        if (!plugin->isNonRealtime())
+            load->addBlock(juce::Time::getHighResolutionTicks() - startTicks, numSamples, getSampleRate());
+    }
+
+    // The same channels as the plugin it stands in for
+    static BusesProperties busesFor(const juce::AudioProcessor& processor)
+    {
+        BusesProperties buses;
+
+        if (processor.getTotalNumInputChannels() > 0)
+            buses = buses.withInput("Input", channelSetFor(processor.getTotalNumInputChannels()), true);
+
+        if (processor.getTotalNumOutputChannels() > 0)
+            buses = buses.withOutput("Output", channelSetFor(processor.getTotalNumOutputChannels()), true);
+
+        return buses;
+    }
+
+    std::shared_ptr<juce::AudioPluginInstance> plugin;
+    std::shared_ptr<PluginLoadMeter> load;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginNode)
+};
 
-    // Initial connection: input -> output
-    connectNodes();
+//==============================================================================
+EffectChain::EffectChain()
+{
+    // Input straight to output; nothing is playing yet
+    activeGraph = buildGraph();
+    latestGraph = activeGraph.get();
 }
 
 EffectChain::~EffectChain()
 {
-    clearAllPlugins();
+    stopTimer();
+
+    for (auto& slot : pluginSlots)
+        slot.plugin->removeListener(this);
+
+    cancelPendingUpdate();
+
+    delete pendingGraph.exchange(nullptr);
+    freeRetiredGraphs();
+
+    activeGraph.reset();
+    pluginSlots.clear();
 }
 
 //==============================================================================
@@ -39,52 +128,53 @@ int EffectChain::addPlugin(std::unique_ptr<juce::AudioPluginInstance> plugin, co
     if (plugin == nullptr)
         return -1;
 
-    juce::ScopedLock lock(processLock);
+    int index = 0;
 
-    // Prepare the plugin with current settings
-    plugin->setPlayConfigDetails(2, 2, currentSampleRate, currentBlockSize);
-    plugin->prepareToPlay(currentSampleRate, currentBlockSize);
+    {
+        const juce::ScopedLock sl(slotLock);
 
-    // Add to graph
-    auto node = processorGraph->addNode(std::move(plugin));
-    if (node == nullptr)
-        return -1;
+        // Loaded for other settings, or not prepared at all
+        if (plugin->getSampleRate() != currentSampleRate || plugin->getBlockSize() != currentBlockSize)
+            preparePlugin(*plugin, currentSampleRate, currentBlockSize);
 
-    PluginSlot slot;
-    slot.plugin = nullptr; // Plugin is now owned by the graph
-    slot.nodeId = node->nodeID;
-    slot.name = name;
-    slot.bypassed = false;
+        PluginSlot slot;
+        slot.plugin = std::move(plugin);
+        slot.name = name;
+        slot.bypassed = false;
+        slot.load = std::make_shared<PluginLoadMeter>();
+        slot.load->setSpikeThreshold(loadSpikeThreshold);
+        slot.plugin->addListener(this);
 
-    pluginSlots.push_back(std::move(slot));
+        pluginSlots.push_back(std::move(slot));
+        index = (int)pluginSlots.size() - 1;
 
-    // Rebuild connections
-    connectNodes();
+        publishGraph();
+    }
 
-    // Re-prepare graph after connection changes
-    processorGraph->prepareToPlay(currentSampleRate, currentBlockSize);
+    triggerAsyncUpdate();
 
     if (onChainChanged)
         onChainChanged();
 
-    return (int)pluginSlots.size() - 1;
+    return index;
 }
 
 void EffectChain::removePlugin(int slotIndex)
 {
-    if (slotIndex < 0 || slotIndex >= (int)pluginSlots.size())
-        return;
+    {
+        const juce::ScopedLock sl(slotLock);
 
-    juce::ScopedLock lock(processLock);
+        if (slotIndex < 0 || slotIndex >= (int)pluginSlots.size())
+            return;
 
-    // Remove from graph
-    processorGraph->removeNode(pluginSlots[slotIndex].nodeId);
+        // The running graph keeps the plugin alive until it's retired
+        pluginSlots[(size_t)slotIndex].plugin->removeListener(this);
+        pluginSlots.erase(pluginSlots.begin() + slotIndex);
 
-    // Remove from our list
-    pluginSlots.erase(pluginSlots.begin() + slotIndex);
+        publishGraph();
+    }
 
-    // Rebuild connections
-    connectNodes();
+    triggerAsyncUpdate();
 
     if (onChainChanged)
         onChainChanged();
@@ -92,26 +182,29 @@ void EffectChain::removePlugin(int slotIndex)
 
 void EffectChain::movePlugin(int fromIndex, int toIndex)
 {
-    if (fromIndex < 0 || fromIndex >= (int)pluginSlots.size())
-        return;
-    if (toIndex < 0 || toIndex >= (int)pluginSlots.size())
-        return;
-    if (fromIndex == toIndex)
-        return;
+    {
+        const juce::ScopedLock sl(slotLock);
 
-    juce::ScopedLock lock(processLock);
+        if (fromIndex < 0 || fromIndex >= (int)pluginSlots.size())
+            return;
+        if (toIndex < 0 || toIndex >= (int)pluginSlots.size())
+            return;
+        if (fromIndex == toIndex)
+            return;
 
-    // Move the slot
-    auto slot = std::move(pluginSlots[fromIndex]);
-    pluginSlots.erase(pluginSlots.begin() + fromIndex);
+        // Move the slot
+        auto slot = std::move(pluginSlots[fromIndex]);
+        pluginSlots.erase(pluginSlots.begin() + fromIndex);
 
-    if (toIndex > fromIndex)
-        toIndex--;
+        if (toIndex > fromIndex)
+            toIndex--;
 
-    pluginSlots.insert(pluginSlots.begin() + toIndex, std::move(slot));
+        pluginSlots.insert(pluginSlots.begin() + toIndex, std::move(slot));
 
-    // Rebuild connections
-    connectNodes();
+        publishGraph();
+    }
+
+    triggerAsyncUpdate();
 
     if (onChainChanged)
         onChainChanged();
@@ -119,16 +212,17 @@ void EffectChain::movePlugin(int fromIndex, int toIndex)
 
 void EffectChain::clearAllPlugins()
 {
-    juce::ScopedLock lock(processLock);
-
-    // Remove all plugin nodes
-    for (auto& slot : pluginSlots)
     {
-        processorGraph->removeNode(slot.nodeId);
+        const juce::ScopedLock sl(slotLock);
+
+        for (auto& slot : pluginSlots)
+            slot.plugin->removeListener(this);
+
+        pluginSlots.clear();
+        publishGraph();
     }
 
-    pluginSlots.clear();
-    connectNodes();
+    triggerAsyncUpdate();
 
     if (onChainChanged)
         onChainChanged();
@@ -148,15 +242,81 @@ const EffectChain::PluginSlot* EffectChain::getPluginSlot(int index) const
     return &pluginSlots[index];
 }
 
+juce::AudioProcessor* EffectChain::getPluginProcessor(int slotIndex) const
+{
+    if (slotIndex < 0 || slotIndex >= (int)pluginSlots.size())
+        return nullptr;
+
+    return pluginSlots[slotIndex].plugin.get();
+}
+
+//==============================================================================
+PluginLoadMeter::Stats EffectChain::getPluginLoad(int slotIndex) const
+{
+    const juce::ScopedLock sl(slotLock);
+
+    if (slotIndex < 0 || slotIndex >= (int)pluginSlots.size())
+        return {};
+
+    return pluginSlots[slotIndex].load->getStats();
+}
+
+void EffectChain::resetPluginLoads()
+{
+    const juce::ScopedLock sl(slotLock);
+
+    for (auto& slot : pluginSlots)
+        slot.load->reset();
+}
+
+void EffectChain::setLoadSpikeThreshold(float percent)
+{
+    const juce::ScopedLock sl(slotLock);
+
+    loadSpikeThreshold = percent;
+
+    for (auto& slot : pluginSlots)
+        slot.load->setSpikeThreshold(percent);
+}
+
+//==============================================================================
+bool EffectChain::updateLatency()
+{
+    const juce::ScopedLock sl(slotLock);
+
+    int totalLatency = 0;
+
+    if (!chainBypassed)
+    {
+        // Only plugins with audio inputs are in the chain (see connectNodes)
+        for (const auto& slot : pluginSlots)
+        {
+            if (slot.plugin->getTotalNumInputChannels() > 0)
+                totalLatency += slot.plugin->getLatencySamples();
+        }
+    }
+
+    if (totalLatency == getLatencySamples())
+        return false;
+
+    setLatencySamples(totalLatency);
+    return true;
+}
+
 //==============================================================================
 void EffectChain::setPluginBypassed(int slotIndex, bool bypassed)
 {
+    const juce::ScopedLock sl(slotLock);
+
     if (slotIndex < 0 || slotIndex >= (int)pluginSlots.size())
         return;
 
     pluginSlots[slotIndex].bypassed = bypassed;
+    triggerAsyncUpdate();
 
-    auto node = processorGraph->getNodeForId(pluginSlots[slotIndex].nodeId);
+    // A running graph that's about to be replaced keeps the old setting
+    // for the few blocks it has left
+    auto node = latestGraph->getNodeForId(pluginSlots[slotIndex].nodeId);
     if (node != nullptr)
     {
         node->setBypassed(bypassed);
@@ -174,184 +334,338 @@ bool EffectChain::isPluginBypassed(int slotIndex) const
 //==============================================================================
 juce::AudioProcessorEditor* EffectChain::createEditorForPlugin(int slotIndex)
 {
-    if (slotIndex < 0 || slotIndex >= (int)pluginSlots.size())
-        return nullptr;
-
-    auto node = processorGraph->getNodeForId(pluginSlots[slotIndex].nodeId);
-    if (node == nullptr || node->getProcessor() == nullptr)
+    auto* plugin = getPluginProcessor(slotIndex);
+    if (plugin == nullptr)
         return nullptr;
 
-    if (node->getProcessor()->hasEditor())
-        return node->getProcessor()->createEditor();
+    if (plugin->hasEditor())
+        return plugin->createEditor();
 
     return nullptr;
 }
 
 //==============================================================================
-void EffectChain::rebuildGraph()
+void EffectChain::preparePlugin(juce::AudioPluginInstance& plugin, double sampleRate, int blockSize)
 {
-    // Remove all connections
-    processorGraph->clear();
+    plugin.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    plugin.prepareToPlay(sampleRate, blockSize);
+}
 
-    // Re-add input/output nodes
-    audioInputNode = processorGraph->addNode(
+std::unique_ptr<juce::AudioProcessorGraph> EffectChain::buildGraph()
+{
+    auto graph = std::make_unique<juce::AudioProcessorGraph>();
+    graph->setPlayConfigDetails(2, 2, currentSampleRate, currentBlockSize);
+
+    // Create input/output nodes
+    auto inputNode = graph->addNode(
         std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
             juce::AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode))->nodeID;
 
-    audioOutputNode = processorGraph->addNode(
+    auto outputNode = graph->addNode(
         std::make_unique<juce::AudioProcessorGraph::AudioGraphIOProcessor>(
             juce::AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode))->nodeID;
 
-    // Re-add all plugins
-    // Note: Plugin instances are owned by the graph, so full rebuild would require save/restore state
-    (void)pluginSlots; // Currently not reimplementing plugins after clear
+    for (auto& slot : pluginSlots)
+    {
+        auto node = graph->addNode(std::make_unique<PluginNode>(slot.plugin, slot.load));
+        slot.nodeId = node->nodeID;
+        node->setBypassed(slot.bypassed);
+    }
 
-    connectNodes();
+    connectNodes(*graph, inputNode, outputNode);
+
+    // Builds the rendering sequence here rather than on the audio thread
+    graph->setNonRealtime(isNonRealtime());
+    graph->prepareToPlay(currentSampleRate, currentBlockSize);
+
+    return graph;
 }
 
-void EffectChain::connectNodes()
+void EffectChain::connectNodes(juce::AudioProcessorGraph& graph,
+                               juce::AudioProcessorGraph::NodeID inputNode,
+                               juce::AudioProcessorGraph::NodeID outputNode)
 {
-    // Remove all existing connections
-    for (auto connection : processorGraph->getConnections())
-    {
-        processorGraph->removeConnection(connection);
-    }
-
-    if (pluginSlots.empty())
-    {
-        // Direct connection: input -> output
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            processorGraph->addConnection({
-                { audioInputNode, ch },
-                { audioOutputNode, ch }
-            });
-        }
-        return;
-    }
+    // Plugins added, removed or reordered
+    updateLatency();
 
-    // Build list of effect plugins only (plugins with audio inputs)
+    // Build list of effect plugins only (plugins with audio inputs).
+    // Instruments (synths) with 0 inputs are skipped from the chain; they
+    // would need MIDI input to produce sound.
     std::vector<size_t> effectIndices;
     for (size_t i = 0; i < pluginSlots.size(); ++i)
     {
-        auto node = processorGraph->getNodeForId(pluginSlots[i].nodeId);
-        if (node != nullptr && node->getProcessor() != nullptr)
-        {
-            int numInputs = node->getProcessor()->getTotalNumInputChannels();
-            if (numInputs > 0)
-            {
-                // This is an effect plugin (has audio inputs)
-                effectIndices.push_back(i);
-            }
-            // Instruments (synths) with 0 inputs are skipped from the chain
-            // They would need MIDI input to produce sound
-        }
+        if (pluginSlots[i].plugin->getTotalNumInputChannels() > 0)
+            effectIndices.push_back(i);
     }
 
     if (effectIndices.empty())
     {
-        // No effect plugins, just pass through
+        // Direct connection: input -> output
         for (int ch = 0; ch < 2; ++ch)
         {
-            processorGraph->addConnection({
-                { audioInputNode, ch },
-                { audioOutputNode, ch }
+            graph.addConnection({
+                { inputNode, ch },
+                { outputNode, ch }
             });
         }
         return;
     }
 
     // Connect input to first effect plugin
-    auto firstNode = processorGraph->getNodeForId(pluginSlots[effectIndices[0]].nodeId);
-    if (firstNode != nullptr && firstNode->getProcessor() != nullptr)
+    const auto& first = pluginSlots[effectIndices[0]];
+    for (int ch = 0; ch < juce::jmin(2, first.plugin->getTotalNumInputChannels()); ++ch)
     {
-        int numInputs = firstNode->getProcessor()->getTotalNumInputChannels();
-        for (int ch = 0; ch < juce::jmin(2, numInputs); ++ch)
-        {
-            processorGraph->addConnection({
-                { audioInputNode, ch },
-                { pluginSlots[effectIndices[0]].nodeId, ch }
-            });
-        }
+        graph.addConnection({
+            { inputNode, ch },
+            { first.nodeId, ch }
+        });
     }
 
     // Connect effect plugins in series
     for (size_t i = 0; i < effectIndices.size() - 1; ++i)
     {
-        auto currentNode = processorGraph->getNodeForId(pluginSlots[effectIndices[i]].nodeId);
-        auto nextNode = processorGraph->getNodeForId(pluginSlots[effectIndices[i + 1]].nodeId);
+        const auto& current = pluginSlots[effectIndices[i]];
+        const auto& next = pluginSlots[effectIndices[i + 1]];
+
+        int numOutputs = current.plugin->getTotalNumOutputChannels();
+        int numInputs = next.plugin->getTotalNumInputChannels();
+        int channels = juce::jmin(numOutputs, numInputs, 2);
 
-        if (currentNode != nullptr && nextNode != nullptr &&
-            currentNode->getProcessor() != nullptr && nextNode->getProcessor() != nullptr)
+        for (int ch = 0; ch < channels; ++ch)
         {
-            int numOutputs = currentNode->getProcessor()->getTotalNumOutputChannels();
-            int numInputs = nextNode->getProcessor()->getTotalNumInputChannels();
-            int channels = juce::jmin(numOutputs, numInputs, 2);
-
-            for (int ch = 0; ch < channels; ++ch)
-            {
-                processorGraph->addConnection({
-                    { pluginSlots[effectIndices[i]].nodeId, ch },
-                    { pluginSlots[effectIndices[i + 1]].nodeId, ch }
-                });
-            }
+            graph.addConnection({
+                { current.nodeId, ch },
+                { next.nodeId, ch }
+            });
         }
     }
 
     // Connect last effect plugin to output
-    auto lastNode = processorGraph->getNodeForId(pluginSlots[effectIndices.back()].nodeId);
-    if (lastNode != nullptr && lastNode->getProcessor() != nullptr)
+    const auto& last = pluginSlots[effectIndices.back()];
+    for (int ch = 0; ch < juce::jmin(2, last.plugin->getTotalNumOutputChannels()); ++ch)
     {
-        int numOutputs = lastNode->getProcessor()->getTotalNumOutputChannels();
-        for (int ch = 0; ch < juce::jmin(2, numOutputs); ++ch)
-        {
-            processorGraph->addConnection({
-                { pluginSlots[effectIndices.back()].nodeId, ch },
-                { audioOutputNode, ch }
-            });
-        }
+        graph.addConnection({
+            { last.nodeId, ch },
+            { outputNode, ch }
+        });
     }
 }
 
+void EffectChain::publishGraph()
+{
+    auto graph = buildGraph();
+    latestGraph = graph.get();
+
+    // A graph the audio thread never picked up is simply replaced
+    delete pendingGraph.exchange(graph.release());
+
+    freeRetiredGraphs();
+    startTimer(retiredFreeIntervalMs);
+}
+
+bool EffectChain::adoptPendingGraph()
+{
+    if (pendingGraph.load() == nullptr)
+        return false;
+
+    // No room to retire the running graph: try again next block
+    if (activeGraph != nullptr && retiredFifo.getFreeSpace() == 0)
+        return false;
+
+    auto* graph = pendingGraph.exchange(nullptr);
+    if (graph == nullptr)
+        return false;
+
+    retireGraph(activeGraph.release());
+    activeGraph.reset(graph);
+    return true;
+}
+
+void EffectChain::retireGraph(juce::AudioProcessorGraph* graph)
+{
+    if (graph == nullptr)
+        return;
+
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+    {
+        // Only when the chain is prepared again with every slot taken
+        delete graph;
+        return;
+    }
+
+    retiredGraphs[static_cast<size_t>(size1 > 0 ? start1 : start2)] = graph;
+    retiredFifo.finishedWrite(1);
+}
+
+void EffectChain::freeRetiredGraphs()
+{
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToRead(retiredFifo.getNumReady(), start1, size1, start2, size2);
+
+    // Plugins removed from the chain go with the last graph that ran them
+    for (int i = 0; i < size1; ++i)
+        delete retiredGraphs[static_cast<size_t>(start1 + i)];
+
+    for (int i = 0; i < size2; ++i)
+        delete retiredGraphs[static_cast<size_t>(start2 + i)];
+
+    retiredFifo.finishedRead(size1 + size2);
+}
+
+void EffectChain::timerCallback()
+{
+    freeRetiredGraphs();
+
+    if (pendingGraph.load() == nullptr && retiredFifo.getNumReady() == 0)
+        stopTimer();
+}
+
+//==============================================================================
+void EffectChain::handleAsyncUpdate()
+{
+    if (onStateChanged)
+        onStateChanged();
+}
+
+void EffectChain::audioProcessorParameterChanged(juce::AudioProcessor*, int, float)
+{
+    // May be the audio thread (automation). Only the first change until
+    // the update is delivered posts a message; the rest find it pending.
+    triggerAsyncUpdate();
+}
+
+void EffectChain::audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails& details)
+{
+    // Latency changes are picked up by updateLatency()
+    if (details.programChanged || details.nonParameterStateChanged)
+        triggerAsyncUpdate();
+}
+
 //==============================================================================
 void EffectChain::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::ScopedLock lock(processLock);
+    // Before the lock: a block passed through meanwhile is seen as stale
+    ++prepareGeneration;
+
+    const juce::ScopedLock sl(slotLock);
+    const juce::ScopedLock lock(processLock);
 
+    released = false;
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
+    setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
 
-    processorGraph->setPlayConfigDetails(2, 2, sampleRate, samplesPerBlock);
-    processorGraph->prepareToPlay(sampleRate, samplesPerBlock);
+    for (auto& slot : pluginSlots)
+        preparePlugin(*slot.plugin, sampleRate, samplesPerBlock);
+
+    // Nothing is playing through the chain: the new graph goes straight in
+    delete pendingGraph.exchange(nullptr);
+    retireGraph(activeGraph.release());
+
+    activeGraph = buildGraph();
+    latestGraph = activeGraph.get();
+
+    fadeLength = juce::jmax(1, juce::roundToInt(sampleRate * swapFadeSeconds));
+    fadeInPosition = fadeLength;
 }
 
 void EffectChain::releaseResources()
 {
-    processorGraph->releaseResources();
+    ++prepareGeneration;
+
+    const juce::ScopedLock sl(slotLock);
+    const juce::ScopedLock lock(processLock);
+
+    released = true;
+
+    for (auto& slot : pluginSlots)
+        slot.plugin->releaseResources();
+
+    if (activeGraph != nullptr)
+        activeGraph->releaseResources();
 }
 
 void EffectChain::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedLock lock(processLock);
+    // The chain is being prepared or reset: pass the block through rather
+    // than wait
+    juce::ScopedTryLock lock(processLock);
+
+    // Released, or re-prepared for smaller blocks, by the device while an
+    // offline render still runs it
+    if (!lock.isLocked() || released || buffer.getNumSamples() > currentBlockSize)
+        return;
 
     if (chainBypassed)
+    {
+        // Nothing to fade while the chain isn't heard
+        if (adoptPendingGraph())
+            fadeInPosition = fadeLength;
+
         return;
+    }
 
-    processorGraph->processBlock(buffer, midiMessages);
+    const int numSamples = buffer.getNumSamples();
+    const bool swapping = numSamples > 0 && pendingGraph.load() != nullptr
+                          && (activeGraph == nullptr || retiredFifo.getFreeSpace() > 0);
+
+    if (activeGraph != nullptr)
+        activeGraph->processBlock(buffer, midiMessages);
+
+    // The graph swapped in last block fades in
+    if (fadeInPosition < fadeLength)
+    {
+        const int count = juce::jmin(numSamples, fadeLength - fadeInPosition);
+
+        buffer.applyGainRamp(0, count,
+                             (float)fadeInPosition / (float)fadeLength,
+                             (float)(fadeInPosition + count) / (float)fadeLength);
+        fadeInPosition += count;
+    }
+
+    if (swapping)
+    {
+        // The graphs share their plugins, so they can't both run this
+        // block: the old one fades out at its end instead, and the new one
+        // takes over from the next
+        const int count = juce::jmin(numSamples, fadeLength);
+        buffer.applyGainRamp(numSamples - count, count, 1.0f, 0.0f);
+
+        if (adoptPendingGraph())
+            fadeInPosition = 0;
+    }
+}
+
+void EffectChain::reset()
+{
+    const juce::ScopedLock sl(slotLock);
+    const juce::ScopedLock lock(processLock);
+
+    for (auto& slot : pluginSlots)
+        slot.plugin->reset();
+}
+
+void EffectChain::setNonRealtime(bool isNonRealtime) noexcept
+{
+    juce::AudioProcessor::setNonRealtime(isNonRealtime);
+
+    const juce::ScopedLock sl(slotLock);
+
+    for (auto& slot : pluginSlots)
+        slot.plugin->setNonRealtime(isNonRealtime);
 }
 
 double EffectChain::getTailLengthSeconds() const
 {
+    const juce::ScopedLock sl(slotLock);
+
     double maxTail = 0.0;
 
     for (const auto& slot : pluginSlots)
-    {
-        auto node = processorGraph->getNodeForId(slot.nodeId);
-        if (node != nullptr && node->getProcessor() != nullptr)
-        {
-            maxTail = std::max(maxTail, node->getProcessor()->getTailLengthSeconds());
-        }
-    }
+        maxTail = std::max(maxTail, slot.plugin->getTailLengthSeconds());
 
     return maxTail;
 }
@@ -369,6 +683,8 @@ void EffectChain::loadChainState(const void* data, int sizeInBytes)
 
 void EffectChain::getStateInformation(juce::MemoryBlock& destData)
 {
+    const juce::ScopedLock sl(slotLock);
+
     juce::XmlElement xml("EffectChain");
 
     xml.setAttribute("bypassed", chainBypassed);
@@ -382,13 +698,9 @@ void EffectChain::getStateInformation(juce::MemoryBlock& destData)
         pluginXml->setAttribute("bypassed", pluginSlots[i].bypassed);
 
         // Save plugin state
-        auto node = processorGraph->getNodeForId(pluginSlots[i].nodeId);
-        if (node != nullptr && node->getProcessor() != nullptr)
-        {
-            juce::MemoryBlock pluginState;
-            node->getProcessor()->getStateInformation(pluginState);
-            pluginXml->setAttribute("state", pluginState.toBase64Encoding());
-        }
+        juce::MemoryBlock pluginState;
+        pluginSlots[i].plugin->getStateInformation(pluginState);
+        pluginXml->setAttribute("state", pluginState.toBase64Encoding());
     }
 
     copyXmlToBinary(xml, destData);
@@ -404,6 +716,7 @@ void EffectChain::setStateInformation(const void* data, int sizeInBytes)
         return;
 
     chainBypassed = xml->getBoolAttribute("bypassed", false);
+    triggerAsyncUpdate();
 
     // Plugin restoration would require the PluginManager to reload plugins
     // This is a simplified version that just restores bypass states
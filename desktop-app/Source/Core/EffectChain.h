@@ -5,16 +5,29 @@
 
     Audio effect chain using AudioProcessorGraph
 
+    Edits never touch the graph the audio thread is running. Each one
+    builds and prepares a new graph on the calling (message) thread around
+    the same plugin instances, and publishes it; the audio thread swaps it
+    in at the start of a block, fading the old graph out at the end of the
+    last block and the new one in over the next, and hands the old graph
+    back to be freed on the message thread.
+
   ==============================================================================
 */
 
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "PluginLoadMeter.h"
+#include <array>
+#include <atomic>
 #include <vector>
 #include <memory>
 
-class EffectChain : public juce::AudioProcessor
+class EffectChain : public juce::AudioProcessor,
+                    private juce::Timer,
+                    private juce::AsyncUpdater,
+                    private juce::AudioProcessorListener
 {
 public:
     //==========================================================================
@@ -25,12 +38,19 @@ class EffectChain : public juce::AudioProcessor
     // Plugin chain management
     struct PluginSlot
     {
-        std::unique_ptr<juce::AudioPluginInstance> plugin;
-        juce::AudioProcessorGraph::NodeID nodeId;
+        // Shared with the graphs built around it
+        std::shared_ptr<juce::AudioPluginInstance> plugin;
+        juce::AudioProcessorGraph::NodeID nodeId;   // In the latest graph
         bool bypassed { false };
         juce::String name;
+
+        // Timed by the graphs' nodes, on whichever thread runs the chain
+        std::shared_ptr<PluginLoadMeter> load;
     };
 
+    // Message thread. A plugin that isn't prepared at the chain's sample
+    // rate and block size yet (see PluginManager::loadPluginAsync) is
+    // prepared here first.
     int addPlugin(std::unique_ptr<juce::AudioPluginInstance> plugin, const juce::String& name);
     void removePlugin(int slotIndex);
     void movePlugin(int fromIndex, int toIndex);
@@ -40,13 +60,35 @@ class EffectChain : public juce::AudioProcessor
     PluginSlot* getPluginSlot(int index);
     const PluginSlot* getPluginSlot(int index) const;
 
+    // The plugin in a slot, or nullptr
+    juce::AudioProcessor* getPluginProcessor(int slotIndex) const;
+
     //==========================================================================
     // Bypass control
     void setPluginBypassed(int slotIndex, bool bypassed);
     bool isPluginBypassed(int slotIndex) const;
-    void setChainBypassed(bool bypassed) { chainBypassed = bypassed; }
+    void setChainBypassed(bool bypassed) { chainBypassed = bypassed; updateLatency(); triggerAsyncUpdate(); }
     bool isChainBypassed() const { return chainBypassed; }
 
+    //==========================================================================
+    // Latency: the sum of the chained plugins' latencies, reported through
+    // getLatencySamples() (0 while the whole chain is bypassed). Bypassed
+    // plugins still count; bypass keeps a plugin's latency. Plugins can
+    // change theirs at any time, so owners call this now and then. Returns
+    // true if the total changed.
+    bool updateLatency();
+
+    //==========================================================================
+    // DSP load per slot, as a percentage of the block duration (offline
+    // renders aren't counted). Any thread for the stats; message thread for
+    // the rest.
+    PluginLoadMeter::Stats getPluginLoad(int slotIndex) const;
+    void resetPluginLoads();
+
+    // Blocks over this percentage of their duration count as spikes
+    void setLoadSpikeThreshold(float percent);
+    float getLoadSpikeThreshold() const { return loadSpikeThreshold; }
+
     //==========================================================================
     // Plugin editor
     juce::AudioProcessorEditor* createEditorForPlugin(int slotIndex);
@@ -63,6 +105,18 @@ class EffectChain : public juce::AudioProcessor
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
 
+    // Passed on to the plugins: clears their state (tails, filter memory),
+    // and tells them whether they're rendering offline
+    void reset() override;
+    void setNonRealtime(bool isNonRealtime) noexcept override;
+
+    // Bumped as every prepareToPlay() and releaseResources() starts. The
+    // device can re-prepare or release a chain an offline render is running
+    // through; the render compares this after each block and gives up once
+    // it's changed. A released chain passes blocks through until prepared,
+    // as does any chain given blocks bigger than it's prepared for.
+    juce::uint32 getPrepareGeneration() const noexcept { return prepareGeneration.load(); }
+
     double getTailLengthSeconds() const override;
     bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return true; }
@@ -83,22 +137,76 @@ class EffectChain : public juce::AudioProcessor
     // Callbacks
     std::function<void()> onChainChanged;
 
+    // Message thread, soon after anything that may change the saved state:
+    // slot and bypass edits, or a plugin reporting a parameter, program or
+    // state change (from any thread). Changes close together come as one.
+    std::function<void()> onStateChanged;
+
+    // Length of each half of the fade when a new graph is swapped in
+    static constexpr double swapFadeSeconds = 0.002;
+
 private:
     //==========================================================================
-    void rebuildGraph();
-    void connectNodes();
+    // Stands in for a plugin in a graph, so several graphs can hold the
+    // same instance (one running, one being built)
+    class PluginNode;
+
+    // A graph around the current slots, prepared at the current settings;
+    // sets the slots' node IDs
+    std::unique_ptr<juce::AudioProcessorGraph> buildGraph();
+    void connectNodes(juce::AudioProcessorGraph& graph,
+                      juce::AudioProcessorGraph::NodeID inputNode,
+                      juce::AudioProcessorGraph::NodeID outputNode);
+
+    // Builds a graph for the current slots and hands it to the audio thread
+    void publishGraph();
+
+    // Audio thread: takes the pending graph if there's room to retire the
+    // running one
+    bool adoptPendingGraph();
+    void retireGraph(juce::AudioProcessorGraph* graph);
+
+    void freeRetiredGraphs();
+    void timerCallback() override;      // Frees retired graphs
+
+    // Calls onStateChanged
+    void handleAsyncUpdate() override;
+
+    // AudioProcessorListener, on every slot's plugin
+    void audioProcessorParameterChanged(juce::AudioProcessor* processor, int parameterIndex, float newValue) override;
+    void audioProcessorChanged(juce::AudioProcessor* processor, const ChangeDetails& details) override;
+
+    static void preparePlugin(juce::AudioPluginInstance& plugin, double sampleRate, int blockSize);
 
     //==========================================================================
-    std::unique_ptr<juce::AudioProcessorGraph> processorGraph;
     std::vector<PluginSlot> pluginSlots;
 
-    juce::AudioProcessorGraph::NodeID audioInputNode;
-    juce::AudioProcessorGraph::NodeID audioOutputNode;
+    // The graph last built (pending or running); for bypass changes
+    juce::AudioProcessorGraph* latestGraph { nullptr };
+
+    // Audio thread's
+    std::unique_ptr<juce::AudioProcessorGraph> activeGraph;
+    int fadeLength { 1 };
+    int fadeInPosition { 1 };           // fadeLength once the fade-in is done
+
+    std::atomic<juce::AudioProcessorGraph*> pendingGraph { nullptr };
+
+    // Graphs swapped out by the audio thread, freed on the message thread
+    static constexpr int maxRetiredGraphs = 8;
+    juce::AbstractFifo retiredFifo { maxRetiredGraphs };
+    std::array<juce::AudioProcessorGraph*, maxRetiredGraphs> retiredGraphs {};
 
     bool chainBypassed { false };
+    bool released { false };            // Guarded by processLock
+    std::atomic<juce::uint32> prepareGeneration { 0 };
+    float loadSpikeThreshold { PluginLoadMeter::defaultSpikeThreshold };
     double currentSampleRate { 44100.0 };
     int currentBlockSize { 512 };
 
+    // slotLock guards the slots and graph building (message thread edits,
+    // device changes, offline renders); processLock keeps processBlock out
+    // while the chain is prepared or reset. Taken in that order.
+    juce::CriticalSection slotLock;
     juce::CriticalSection processLock;
 
     //==========================================================================
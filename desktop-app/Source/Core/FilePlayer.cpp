@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    FilePlayer.cpp
+
+    Lock-free single-file playback implementation
+
+  ==============================================================================
+*/
+
+#include "FilePlayer.h"
+
+//==============================================================================
+FilePlayer::~FilePlayer()
+{
+    stopTimer();
+    detachSource();
+}
+
+//==============================================================================
+void FilePlayer::setSource(juce::PositionableAudioSource* newSource)
+{
+    playing.store(false);
+
+    auto* oldSource = detachSource();
+
+    if (oldSource != nullptr && oldSource != newSource)
+        oldSource->releaseResources();
+
+    attachedSource = newSource;
+
+    if (newSource != nullptr && preparedSampleRate.load() > 0.0)
+        newSource->prepareToPlay(preparedBlockSize, preparedSampleRate.load());
+
+    if (newSource != nullptr)
+        newSource->setNextReadPosition(0);
+
+    pendingSeek.store(-1);
+    position.store(0);
+    totalLength.store(newSource != nullptr ? newSource->getTotalLength() : 0);
+    streamFinished.store(false);
+    finishPending.store(false);
+
+    source.store(newSource);
+}
+
+void FilePlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    auto* input = detachSource();
+
+    preparedBlockSize = samplesPerBlockExpected;
+    preparedSampleRate.store(sampleRate);
+
+    if (input != nullptr)
+    {
+        input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        totalLength.store(input->getTotalLength());
+        position.store(input->getNextReadPosition());
+    }
+
+    source.store(input);
+}
+
+void FilePlayer::releaseResources()
+{
+    auto* input = detachSource();
+
+    if (input != nullptr)
+        input->releaseResources();
+
+    preparedSampleRate.store(0.0);
+    source.store(input);
+}
+
+juce::PositionableAudioSource* FilePlayer::detachSource()
+{
+    source.store(nullptr);
+
+    while (audioThreadUsingSource.load())
+        juce::Thread::yield();
+
+    return attachedSource;
+}
+
+//==============================================================================
+void FilePlayer::start()
+{
+    if (attachedSource == nullptr)
+        return;
+
+    streamFinished.store(false);
+    playing.store(true);
+
+    if (!isTimerRunning())
+        startTimer(finishPollIntervalMs);
+}
+
+void FilePlayer::stop()
+{
+    playing.store(false);
+}
+
+void FilePlayer::setPosition(double seconds)
+{
+    const double sampleRate = preparedSampleRate.load();
+
+    streamFinished.store(false);
+    setNextReadPosition(sampleRate > 0.0 ? (juce::int64)(juce::jmax(0.0, seconds) * sampleRate) : 0);
+}
+
+double FilePlayer::getCurrentPosition() const
+{
+    const double sampleRate = preparedSampleRate.load();
+    return sampleRate > 0.0 ? (double)getNextReadPosition() / sampleRate : 0.0;
+}
+
+double FilePlayer::getLengthInSeconds() const
+{
+    const double sampleRate = preparedSampleRate.load();
+    return sampleRate > 0.0 ? (double)totalLength.load() / sampleRate : 0.0;
+}
+
+void FilePlayer::timerCallback()
+{
+    if (finishPending.exchange(false) && onFinished != nullptr)
+        onFinished();
+
+    if (!playing.load() && !finishPending.load())
+        stopTimer();
+}
+
+//==============================================================================
+void FilePlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // Set before the source is looked at, so detachSource() can't miss us
+    audioThreadUsingSource.store(true);
+    auto* input = source.load();
+
+    if (input == nullptr)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        wasPlaying = false;
+        audioThreadUsingSource.store(false);
+        return;
+    }
+
+    bool isPlaying = playing.load();
+
+    auto seek = pendingSeek.exchange(-1);
+    if (seek >= 0)
+    {
+        input->setNextReadPosition(seek);
+
+        // Stopped and moved (stop() then back to the start): the fade-out
+        // would be of the new position
+        if (!isPlaying)
+            wasPlaying = false;
+    }
+
+    // Checked once any seek is applied, so a loop wrap just past the end
+    // doesn't count; as AudioTransportSource, one sample of slack
+    if (isPlaying && !input->isLooping() && input->getNextReadPosition() > totalLength.load() + 1)
+    {
+        bool expected = true;
+        playing.compare_exchange_strong(expected, false);
+
+        streamFinished.store(true);
+        finishPending.store(true);
+        isPlaying = false;
+        wasPlaying = false;
+    }
+
+    if (isPlaying || wasPlaying)
+    {
+        input->getNextAudioBlock(bufferToFill);
+
+        // Just stopped: fade the block out rather than click
+        if (!isPlaying)
+            bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, 1.0f, 0.0f);
+    }
+    else
+    {
+        bufferToFill.clearActiveBufferRegion();
+    }
+
+    wasPlaying = isPlaying;
+    position.store(input->getNextReadPosition());
+
+    audioThreadUsingSource.store(false);
+}
+
+void FilePlayer::setNextReadPosition(juce::int64 newPosition) noexcept
+{
+    pendingSeek.store(juce::jmax((juce::int64)0, newPosition));
+}
+
+juce::int64 FilePlayer::getNextReadPosition() const noexcept
+{
+    // A seek not applied yet is where the next block starts; one past the
+    // end is reported as the end
+    auto seek = pendingSeek.load();
+    if (seek >= 0)
+        return juce::jmin(seek, totalLength.load());
+
+    return position.load();
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    FilePlayer.h
+
+    Single-file playback for AudioEngine, in place of AudioTransportSource,
+    whose callback takes a lock on every block. Play state, seeks and the
+    play position are handed between the threads with atomics; the audio
+    thread applies a requested seek at the start of its next block.
+
+    The source is swapped or re-prepared only while the audio thread is
+    kept out of it: the message thread detaches it and waits for a callback
+    still using it to finish, as AudioEngine does for its recording writer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_events/juce_events.h>
+#include <atomic>
+#include <functional>
+
+class FilePlayer : private juce::Timer
+{
+public:
+    //==========================================================================
+    FilePlayer() = default;
+    ~FilePlayer() override;
+
+    //==========================================================================
+    // Message thread. The source is prepared here if the player is, and
+    // the old one released; neither is deleted. Playback stops.
+    void setSource(juce::PositionableAudioSource* newSource);
+
+    // Message thread, or the device thread while no callback runs
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+
+    //==========================================================================
+    // Message thread
+    void start();
+    void stop();                        // Fades the next block out
+    bool isPlaying() const noexcept { return playing.load(); }
+
+    void setPosition(double seconds);
+    double getCurrentPosition() const;  // Seconds
+    double getLengthInSeconds() const;
+
+    // Playback ran off the end of the source
+    bool hasStreamFinished() const noexcept { return streamFinished.load(); }
+
+    // Message thread, soon after playback runs off the end
+    std::function<void()> onFinished;
+
+    //==========================================================================
+    // Audio thread. Positions are in the source's samples; a seek takes
+    // effect at the next getNextAudioBlock(), but is reported at once.
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill);
+
+    void setNextReadPosition(juce::int64 newPosition) noexcept;
+    juce::int64 getNextReadPosition() const noexcept;
+    juce::int64 getTotalLength() const noexcept { return totalLength.load(); }
+
+private:
+    //==========================================================================
+    void timerCallback() override;      // Delivers onFinished
+
+    // Detaches the source and waits out a callback that may still be using it
+    juce::PositionableAudioSource* detachSource();
+
+    std::atomic<juce::PositionableAudioSource*> source { nullptr };
+    std::atomic<bool> audioThreadUsingSource { false };
+
+    juce::PositionableAudioSource* attachedSource { nullptr };  // Message thread's
+    int preparedBlockSize { 0 };
+    std::atomic<double> preparedSampleRate { 0.0 };             // 0: not prepared
+    std::atomic<juce::int64> totalLength { 0 };                 // At the prepared rate
+
+    // Message thread -> audio thread
+    std::atomic<bool> playing { false };
+    std::atomic<juce::int64> pendingSeek { -1 };
+
+    // Audio thread -> message thread
+    std::atomic<juce::int64> position { 0 };
+    std::atomic<bool> streamFinished { false };
+    std::atomic<bool> finishPending { false };
+
+    // Audio thread's
+    bool wasPlaying { false };
+
+    static constexpr int finishPollIntervalMs = 50;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilePlayer)
+};
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    MappedAudioReader.cpp
+
+    Memory-mapped WAV / AIFF reading with page prefetch implementation
+
+  ==============================================================================
+*/
+
+#include "MappedAudioReader.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD || JUCE_ANDROID
+ #define SOUNDMAN_USE_MADVISE 1
+ #include <sys/mman.h>
+#else
+ #define SOUNDMAN_USE_MADVISE 0
+#endif
+
+namespace
+{
+    //==========================================================================
+    // MemoryMappedAudioFormatReader keeps the address of a sample protected.
+    // Naming the member through a derived class is the legal way to reach it;
+    // this class is never instantiated.
+    struct MappedSampleAddress : public juce::MemoryMappedAudioFormatReader
+    {
+        static const void* get(const juce::MemoryMappedAudioFormatReader& reader, juce::int64 sample)
+        {
+            return (reader.*(&MappedSampleAddress::sampleToPointer))(sample);
+        }
+    };
+
+    constexpr int prefetchPollIntervalMs = 20;
+    constexpr int idlePollIntervalMs = 100;
+}
+
+//==============================================================================
+// One prefetch thread shared by every open mapped file
+class MappedAudioReader::PrefetchThread : public juce::TimeSliceThread
+{
+public:
+    PrefetchThread() : juce::TimeSliceThread("Audio File Prefetch")
+    {
+        startThread();
+    }
+
+    ~PrefetchThread() override
+    {
+        stopThread(1000);
+    }
+};
+
+//==============================================================================
+std::unique_ptr<juce::AudioFormatReader> MappedAudioReader::createReaderFor(juce::AudioFormatManager& formatManager,
+                                                                            const juce::File& file)
+{
+    // WAV and AIFF implement createMemoryMappedReader(); other formats return nullptr
+    if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+
+        // Compressed or unusual variants (and files too big to map) can't be mapped
+        if (mapped != nullptr && mapped->lengthInSamples > 0 && mapped->mapEntireFile())
+            return std::make_unique<MappedAudioReader>(std::move(mapped));
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+}
+
+//==============================================================================
+MappedAudioReader::MappedAudioReader(std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader)
+    : juce::AudioFormatReader(nullptr, mappedReader->getFormatName()),
+      source(std::move(mappedReader))
+{
+    sampleRate = source->sampleRate;
+    bitsPerSample = source->bitsPerSample;
+    lengthInSamples = source->lengthInSamples;
+    numChannels = source->numChannels;
+    usesFloatingPointData = source->usesFloatingPointData;
+    metadataValues = source->metadataValues;
+
+    prefetchLength = juce::jmax((juce::int64)1, (juce::int64)(sampleRate * prefetchSeconds));
+
+    // Start of the file is the most likely first read
+    nextReadPosition.store(0);
+    prefetchThread->addTimeSliceClient(this);
+}
+
+MappedAudioReader::~MappedAudioReader()
+{
+    // Waits for a prefetch in progress on this file to finish
+    prefetchThread->removeTimeSliceClient(this);
+}
+
+//==============================================================================
+bool MappedAudioReader::readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                    juce::int64 startSampleInFile, int numSamples)
+{
+    nextReadPosition.store(startSampleInFile + numSamples, std::memory_order_relaxed);
+
+    return source->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer,
+                               startSampleInFile, numSamples);
+}
+
+void MappedAudioReader::readMaxLevels(juce::int64 startSample, juce::int64 numSamples,
+                                      juce::Range<float>* results, int numChannelsToRead)
+{
+    source->readMaxLevels(startSample, numSamples, results, numChannelsToRead);
+}
+
+//==============================================================================
+int MappedAudioReader::useTimeSlice()
+{
+    auto position = nextReadPosition.load(std::memory_order_relaxed);
+
+    if (position < 0 || position >= lengthInSamples)
+        return idlePollIntervalMs;
+
+    // Re-advise once playback is half-way through the prefetched range,
+    // or straight away after a seek
+    bool seeked = position < prefetchedStart || position > prefetchedEnd;
+    bool runningOut = position > prefetchedEnd - prefetchLength / 2 && prefetchedEnd < lengthInSamples;
+
+    if (seeked || runningOut)
+    {
+        prefetchedStart = position;
+        prefetchedEnd = juce::jmin(lengthInSamples, position + prefetchLength);
+        prefetch(prefetchedStart, prefetchedEnd);
+    }
+
+    return prefetchPollIntervalMs;
+}
+
+void MappedAudioReader::prefetch(juce::int64 startSample, juce::int64 endSample)
+{
+    auto mapped = source->getMappedSection().getIntersectionWith({ startSample, endSample });
+    if (mapped.isEmpty())
+        return;
+
+   #if SOUNDMAN_USE_MADVISE
+    // Asynchronous read-ahead into the page cache; returns without waiting
+    const auto pageSize = (juce::pointer_sized_int)juce::SystemStats::getPageSize();
+    auto start = (juce::pointer_sized_int)MappedSampleAddress::get(*source, mapped.getStart());
+    auto end = (juce::pointer_sized_int)MappedSampleAddress::get(*source, mapped.getEnd() - 1) + 1;
+    start -= start % pageSize;  // The mapping itself starts on a page boundary
+
+    madvise((void*)start, (size_t)(end - start), MADV_WILLNEED);
+   #else
+    // No madvise: fault the pages in from here, off the audio thread
+    const auto frameBytes = juce::jmax(1, (int)(numChannels * bitsPerSample / 8));
+    const auto samplesPerPage = juce::jmax((juce::int64)1, (juce::int64)(juce::SystemStats::getPageSize() / frameBytes));
+
+    for (auto sample = mapped.getStart(); sample < mapped.getEnd(); sample += samplesPerPage)
+        source->touchSample(sample);
+   #endif
+}
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    MappedAudioReader.h
+
+    Zero-copy reading of uncompressed WAV / AIFF files. The file is opened
+    with the format's memory-mapped reader, so playback reads PCM straight
+    from the page cache instead of through buffered read() calls.
+
+    Every read records the play position; a shared background thread then
+    asks the OS to page in the next few seconds of the file (madvise
+    WILLNEED on POSIX), so the audio thread doesn't take the page faults.
+
+    Compressed formats (FLAC, Ogg, ...) use the format's streaming reader.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <memory>
+
+class MappedAudioReader : public juce::AudioFormatReader,
+                          private juce::TimeSliceClient
+{
+public:
+    //==========================================================================
+    // Memory-mapped reader for uncompressed WAV / AIFF, otherwise the
+    // format's streaming reader. Returns nullptr if the file can't be read.
+    static std::unique_ptr<juce::AudioFormatReader> createReaderFor(juce::AudioFormatManager& formatManager,
+                                                                    const juce::File& file);
+
+    // Takes ownership of a reader whose whole file is already mapped
+    explicit MappedAudioReader(std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader);
+    ~MappedAudioReader() override;
+
+    //==========================================================================
+    // AudioFormatReader
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     juce::int64 startSampleInFile, int numSamples) override;
+
+    void readMaxLevels(juce::int64 startSample, juce::int64 numSamples,
+                       juce::Range<float>* results, int numChannelsToRead) override;
+
+    juce::AudioChannelSet getChannelLayout() override { return source->getChannelLayout(); }
+
+    //==========================================================================
+    // How far ahead of the last read the prefetcher pages the file in
+    static constexpr double prefetchSeconds = 2.0;
+
+private:
+    //==========================================================================
+    int useTimeSlice() override;
+    void prefetch(juce::int64 startSample, juce::int64 endSample);
+
+    class PrefetchThread;
+
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> source;
+    juce::SharedResourcePointer<PrefetchThread> prefetchThread;
+
+    // Written by the reading thread, read by the prefetch thread
+    std::atomic<juce::int64> nextReadPosition { -1 };
+
+    // Prefetch thread only: range of samples last advised
+    juce::int64 prefetchedStart { 0 };
+    juce::int64 prefetchedEnd { 0 };
+    juce::int64 prefetchLength { 0 };
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappedAudioReader)
+};
@@ -9,6 +9,7 @@
 */
 
 #include "MultiTrackAudioSource.h"
+#include "MappedAudioReader.h"
 
 //==============================================================================
 // AudioFileCache Implementation
@@ -19,15 +20,89 @@ AudioFileCache::AudioFileCache(juce::AudioFormatManager& fm)
 {
 }
 
+AudioFileCache::~AudioFileCache()
+{
+    conversionPool.removeAllJobs(true, 2000);
+}
+
 juce::AudioFormatReaderSource* AudioFileCache::getReaderSource(const juce::String& filePath)
 {
     juce::ScopedLock sl(cacheLock);
 
+    auto* entry = findOrLoad(filePath);
+    return entry != nullptr ? entry->source.get() : nullptr;
+}
+
+//==============================================================================
+// Idle readers of one file, shared by the cache entry and the leases handed out
+struct AudioFileCache::ReaderPool
+{
+    ReaderPool(juce::AudioFormatManager& fm, const juce::File& f)
+        : formatManager(fm), file(f)
+    {
+    }
+
+    juce::AudioFormatManager& formatManager;
+    const juce::File file;
+    juce::CriticalSection lock;
+    std::vector<std::unique_ptr<juce::AudioFormatReader>> idle;
+};
+
+AudioFileCache::ReaderLease AudioFileCache::acquireReader(const juce::String& filePath)
+{
+    std::shared_ptr<ReaderPool> pool;
+
+    {
+        juce::ScopedLock sl(cacheLock);
+
+        auto* entry = findOrLoad(filePath);
+        if (entry == nullptr)
+            return nullptr;
+
+        // One mapped reader serves every clip on the file
+        if (entry->mapped)
+            return entry->reader;
+
+        pool = entry->readerPool;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    {
+        juce::ScopedLock pl(pool->lock);
+
+        if (!pool->idle.empty())
+        {
+            reader = std::move(pool->idle.back());
+            pool->idle.pop_back();
+        }
+    }
+
+    if (reader == nullptr)
+        reader.reset(pool->formatManager.createReaderFor(pool->file));
+
+    if (reader == nullptr)
+        return nullptr;
+
+    // The lease keeps the pool alive, so it can be returned to after the
+    // file has left the cache
+    return ReaderLease(reader.release(), [pool](juce::AudioFormatReader* released)
+    {
+        std::unique_ptr<juce::AudioFormatReader> returned(released);
+        juce::ScopedLock pl(pool->lock);
+
+        if (static_cast<int>(pool->idle.size()) < maxIdleReadersPerFile)
+            pool->idle.push_back(std::move(returned));
+    });
+}
+
+AudioFileCache::CachedFile* AudioFileCache::findOrLoad(const juce::String& filePath)
+{
     // Check if already cached
     auto it = cache.find(filePath);
     if (it != cache.end() && it->second.source != nullptr)
     {
-        return it->second.source.get();
+        return &it->second;
     }
 
     // Try to load the file
@@ -35,8 +110,8 @@ juce::AudioFormatReaderSource* AudioFileCache::getReaderSource(const juce::Strin
     if (!file.existsAsFile())
         return nullptr;
 
-    auto reader = std::unique_ptr<juce::AudioFormatReader>(
-        formatManager.createReaderFor(file));
+    // Memory-mapped for WAV / AIFF, so clips read PCM from the page cache
+    auto reader = MappedAudioReader::createReaderFor(formatManager, file);
 
     if (reader == nullptr)
         return nullptr;
@@ -48,13 +123,17 @@ juce::AudioFormatReaderSource* AudioFileCache::getReaderSource(const juce::Strin
     entry.numChannels = static_cast<int>(reader->numChannels);
 
     auto* rawReader = reader.get();
+    entry.mapped = dynamic_cast<MappedAudioReader*>(rawReader) != nullptr;
     entry.reader = std::move(reader);
     entry.source = std::make_unique<juce::AudioFormatReaderSource>(rawReader, false);
 
-    auto* sourcePtr = entry.source.get();
-    cache[filePath] = std::move(entry);
+    if (!entry.mapped)
+        entry.readerPool = std::make_shared<ReaderPool>(formatManager, file);
 
-    return sourcePtr;
+    auto& cached = cache[filePath];
+    cached = std::move(entry);
+
+    return &cached;
 }
 
 double AudioFileCache::getSampleRate(const juce::String& filePath) const
@@ -88,477 +167,1442 @@ void AudioFileCache::clearCache()
 {
     juce::ScopedLock sl(cacheLock);
     cache.clear();
+    convertedCache.clear();
+    decodedCache.clear();
+    decodedAudioSize = 0;
 }
 
 void AudioFileCache::removeFromCache(const juce::String& filePath)
 {
     juce::ScopedLock sl(cacheLock);
     cache.erase(filePath);
-}
-
-//==============================================================================
-// ClipAudioSource Implementation
-//==============================================================================
-
-ClipAudioSource::ClipAudioSource(AudioFileCache& cache, const juce::ValueTree& clipState)
-    : audioCache(cache)
-    , state(clipState)
-{
-    updateFromState();
-}
 
-void ClipAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
-{
-    samplesPerBlock = samplesPerBlockExpected;
-    currentSampleRate = sampleRate;
-    tempBuffer.setSize(2, samplesPerBlockExpected);
-}
+    auto decodedIt = decodedCache.find(filePath);
+    if (decodedIt != decodedCache.end())
+    {
+        decodedAudioSize -= decodedIt->second.bytes;
+        decodedCache.erase(decodedIt);
+    }
 
-void ClipAudioSource::releaseResources()
-{
-    tempBuffer.setSize(0, 0);
+    // Converted copies are keyed by path, rate and quality
+    for (auto it = convertedCache.begin(); it != convertedCache.end();)
+    {
+        if (it->first.startsWith(filePath + "|"))
+            it = convertedCache.erase(it);
+        else
+            ++it;
+    }
 }
 
-void ClipAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+//==============================================================================
+// Converts a whole file to one sample rate, off the audio and message threads
+class AudioFileCache::ConversionJob : public juce::ThreadPoolJob
 {
-    // Check if clip is active at current position
-    if (!isActiveAt(currentPosition))
+public:
+    ConversionJob(juce::AudioFormatManager& fm, const juce::File& fileToConvert, double rate,
+                  SincResampler::Quality qualityToUse, std::shared_ptr<ConvertedAudio> destination)
+        : juce::ThreadPoolJob("Convert " + fileToConvert.getFileName()),
+          formatManager(fm), file(fileToConvert), targetSampleRate(rate),
+          quality(qualityToUse), target(std::move(destination))
     {
-        bufferToFill.clearActiveBufferRegion();
-        currentPosition += bufferToFill.numSamples;
-        return;
     }
 
-    auto* readerSource = audioCache.getReaderSource(audioFilePath);
-    if (readerSource == nullptr)
+    JobStatus runJob() override
     {
-        bufferToFill.clearActiveBufferRegion();
-        currentPosition += bufferToFill.numSamples;
-        return;
-    }
-
-    // Calculate position within clip
-    juce::int64 clipStart = timelineStart;
-    juce::int64 positionInClip = currentPosition - clipStart;
+        // Own reader, so the conversion never contends with playback
+        auto reader = MappedAudioReader::createReaderFor(formatManager, file);
+        if (reader == nullptr || reader->sampleRate <= 0.0)
+            return jobHasFinished;
 
-    // Set reader position (sourceStart + position within clip)
-    readerSource->setNextReadPosition(sourceStart + positionInClip);
+        constexpr int chunkSize = 4096;
+        const double ratio = reader->sampleRate / targetSampleRate;
 
-    // Read audio
-    readerSource->getNextAudioBlock(bufferToFill);
+        SincResampler resampler;
+        resampler.prepare(2, ratio, quality, chunkSize);
 
-    // Apply gain and fades
-    auto* buffer = bufferToFill.buffer;
-    int startSample = bufferToFill.startSample;
-    int numSamples = bufferToFill.numSamples;
+        const auto length = (int)((double)reader->lengthInSamples / ratio);
+        target->buffer.setSize(2, length);
 
-    for (int i = 0; i < numSamples; ++i)
-    {
-        juce::int64 samplePos = positionInClip + i;
-        float fadeGain = calculateFadeGain(samplePos);
-        float totalGain = gain * fadeGain;
+        juce::AudioBuffer<float> input(2, resampler.getMaxInputSamplesPerCall());
+        auto readPosition = (juce::int64)-resampler.getInputLatency();  // Reads before 0 are silent
 
-        for (int ch = 0; ch < buffer->getNumChannels(); ++ch)
+        for (int done = 0; done < length; done += chunkSize)
         {
-            buffer->setSample(ch, startSample + i,
-                buffer->getSample(ch, startSample + i) * totalGain);
+            if (shouldExit())
+                return jobHasFinished;
+
+            const int numThisTime = juce::jmin(chunkSize, length - done);
+            const int numInput = resampler.getNumInputSamplesNeeded(numThisTime);
+
+            reader->read(&input, 0, numInput, readPosition, true, true);
+            readPosition += numInput;
+
+            float* output[] = { target->buffer.getWritePointer(0, done), target->buffer.getWritePointer(1, done) };
+            resampler.process(input.getArrayOfReadPointers(), output, numThisTime);
         }
+
+        target->ready.store(true, std::memory_order_release);
+        return jobHasFinished;
     }
 
-    currentPosition += numSamples;
-}
+private:
+    juce::AudioFormatManager& formatManager;
+    const juce::File file;
+    const double targetSampleRate;
+    const SincResampler::Quality quality;
+    std::shared_ptr<ConvertedAudio> target;
 
-void ClipAudioSource::setNextReadPosition(juce::int64 newPosition)
-{
-    currentPosition = newPosition;
-}
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConversionJob)
+};
 
-juce::int64 ClipAudioSource::getNextReadPosition() const
+void AudioFileCache::setConvertedAudioCacheEnabled(bool shouldCache)
 {
-    return currentPosition;
+    juce::ScopedLock sl(cacheLock);
+    convertedAudioCacheEnabled = shouldCache;
+
+    if (!shouldCache)
+    {
+        // Clips keep the copies they hold until they are re-prepared
+        convertedCache.clear();
+        conversionPool.removeAllJobs(true, 0);
+    }
 }
 
-juce::int64 ClipAudioSource::getTotalLength() const
+std::shared_ptr<const AudioFileCache::ConvertedAudio> AudioFileCache::getConvertedAudio(const juce::String& filePath,
+                                                                                        double targetSampleRate)
 {
-    return timelineStart + length;
+    juce::ScopedLock sl(cacheLock);
+
+    if (!convertedAudioCacheEnabled || targetSampleRate <= 0.0)
+        return nullptr;
+
+    auto* entry = findOrLoad(filePath);
+    if (entry == nullptr || entry->sampleRate <= 0.0
+        || (double)entry->lengthInSamples / entry->sampleRate > maxConvertedSeconds)
+        return nullptr;
+
+    auto key = filePath + "|" + juce::String(targetSampleRate) + "|" + SincResampler::getQualityName(resamplingQuality);
+    auto& converted = convertedCache[key];
+
+    if (converted == nullptr)
+    {
+        converted = std::make_shared<ConvertedAudio>();
+        conversionPool.addJob(new ConversionJob(formatManager, juce::File(filePath), targetSampleRate,
+                                                resamplingQuality, converted), true);
+    }
+
+    return converted;
 }
 
-bool ClipAudioSource::isActiveAt(juce::int64 timelinePosition) const
+
+//==============================================================================
+// Decodes a whole file into memory, off the audio and message threads
+class AudioFileCache::DecodeJob : public juce::ThreadPoolJob
 {
-    return timelinePosition >= timelineStart &&
-           timelinePosition < (timelineStart + length);
-}
+public:
+    DecodeJob(juce::AudioFormatManager& fm, const juce::File& fileToDecode,
+              std::shared_ptr<DecodedAudio> destination)
+        : juce::ThreadPoolJob("Decode " + fileToDecode.getFileName()),
+          formatManager(fm), file(fileToDecode), target(std::move(destination))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto reader = MappedAudioReader::createReaderFor(formatManager, file);
+        if (reader == nullptr)
+            return jobHasFinished;
+
+        constexpr int chunkSize = 65536;
+        const auto length = static_cast<int>(reader->lengthInSamples);
+        const int numChannels = juce::jlimit(1, 2, static_cast<int>(reader->numChannels));
+
+        target->buffer.setSize(numChannels, length);
 
-juce::int64 ClipAudioSource::getTimelineStart() const
+        for (int done = 0; done < length; done += chunkSize)
+        {
+            if (shouldExit())
+                return jobHasFinished;
+
+            const int numThisTime = juce::jmin(chunkSize, length - done);
+            reader->read(&target->buffer, done, numThisTime, done, true, numChannels > 1);
+        }
+
+        target->ready.store(true, std::memory_order_release);
+        return jobHasFinished;
+    }
+
+private:
+    juce::AudioFormatManager& formatManager;
+    const juce::File file;
+    std::shared_ptr<DecodedAudio> target;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodeJob)
+};
+
+void AudioFileCache::setDecodedAudioBudget(juce::int64 bytes)
 {
-    return timelineStart;
+    juce::ScopedLock sl(cacheLock);
+    decodedAudioBudget = juce::jmax(static_cast<juce::int64>(0), bytes);
+    trimDecodedCache();
 }
 
-juce::int64 ClipAudioSource::getTimelineEnd() const
+juce::int64 AudioFileCache::getDecodedAudioBudget() const
 {
-    return timelineStart + length;
+    juce::ScopedLock sl(cacheLock);
+    return decodedAudioBudget;
 }
 
-float ClipAudioSource::getGain() const
+juce::int64 AudioFileCache::getDecodedAudioSize() const
 {
-    return gain;
+    juce::ScopedLock sl(cacheLock);
+    return decodedAudioSize;
 }
 
-void ClipAudioSource::updateFromState()
+void AudioFileCache::setPinned(const juce::String& filePath, bool shouldPin)
 {
-    audioFilePath = state[IDs::audioFilePath].toString();
-    sourceStart = static_cast<juce::int64>(state[IDs::sourceStart]);
-    length = static_cast<juce::int64>(state[IDs::length]);
-    timelineStart = static_cast<juce::int64>(state[IDs::timelineStart]);
-    gain = static_cast<float>(state[IDs::gain]);
-    fadeInSamples = static_cast<juce::int64>(state[IDs::fadeInSamples]);
-    fadeOutSamples = static_cast<juce::int64>(state[IDs::fadeOutSamples]);
+    juce::ScopedLock sl(cacheLock);
+
+    if (shouldPin)
+    {
+        pinnedFiles.addIfNotAlreadyThere(filePath);
+    }
+    else
+    {
+        pinnedFiles.removeString(filePath);
+        trimDecodedCache();
+    }
 }
 
-juce::String ClipAudioSource::getClipId() const
+bool AudioFileCache::isPinned(const juce::String& filePath) const
 {
-    return state[IDs::clipId].toString();
+    juce::ScopedLock sl(cacheLock);
+    return pinnedFiles.contains(filePath);
 }
 
-float ClipAudioSource::calculateFadeGain(juce::int64 positionInClip) const
+std::shared_ptr<const AudioFileCache::DecodedAudio> AudioFileCache::getDecodedAudio(const juce::String& filePath)
 {
-    float fadeGain = 1.0f;
+    juce::ScopedLock sl(cacheLock);
+
+    const bool pinned = pinnedFiles.contains(filePath);
+    if (decodedAudioBudget <= 0 && !pinned)
+        return nullptr;
 
-    // Fade in
-    if (fadeInSamples > 0 && positionInClip < fadeInSamples)
+    auto existing = decodedCache.find(filePath);
+    if (existing != decodedCache.end())
     {
-        fadeGain *= static_cast<float>(positionInClip) / static_cast<float>(fadeInSamples);
+        existing->second.lastUsed = ++decodedUseCounter;
+        return existing->second.audio;
     }
 
-    // Fade out
-    if (fadeOutSamples > 0)
+    auto* entry = findOrLoad(filePath);
+    if (entry == nullptr || entry->lengthInSamples <= 0
+        || entry->lengthInSamples > std::numeric_limits<int>::max())
+        return nullptr;
+
+    auto bytes = entry->lengthInSamples * juce::jlimit(1, 2, entry->numChannels)
+                 * static_cast<juce::int64>(sizeof(float));
+
+    // Make room; a pinned file is cached even if it doesn't fit
+    if (!trimDecodedCache(bytes) && !pinned)
+        return nullptr;
+
+    auto& decoded = decodedCache[filePath];
+    decoded.audio = std::make_shared<DecodedAudio>();
+    decoded.bytes = bytes;
+    decoded.lastUsed = ++decodedUseCounter;
+    decodedAudioSize += bytes;
+
+    conversionPool.addJob(new DecodeJob(formatManager, juce::File(filePath), decoded.audio), true);
+
+    return decoded.audio;
+}
+
+bool AudioFileCache::trimDecodedCache(juce::int64 bytesToAdd)
+{
+    while (decodedAudioSize + bytesToAdd > decodedAudioBudget)
     {
-        juce::int64 fadeOutStart = length - fadeOutSamples;
-        if (positionInClip >= fadeOutStart)
+        auto oldest = decodedCache.end();
+
+        for (auto it = decodedCache.begin(); it != decodedCache.end(); ++it)
         {
-            juce::int64 posInFadeOut = positionInClip - fadeOutStart;
-            fadeGain *= 1.0f - (static_cast<float>(posInFadeOut) / static_cast<float>(fadeOutSamples));
+            if (!pinnedFiles.contains(it->first)
+                && (oldest == decodedCache.end() || it->second.lastUsed < oldest->second.lastUsed))
+                oldest = it;
         }
+
+        if (oldest == decodedCache.end())
+            return false;
+
+        // Clips still holding it keep it until they are re-prepared
+        decodedAudioSize -= oldest->second.bytes;
+        decodedCache.erase(oldest);
     }
 
-    return juce::jlimit(0.0f, 1.0f, fadeGain);
+    return true;
 }
 
 //==============================================================================
-// TrackAudioSource Implementation
+// ClipAudioSource Implementation
 //==============================================================================
 
-TrackAudioSource::TrackAudioSource(AudioFileCache& cache, const juce::ValueTree& trackState)
+ClipAudioSource::ClipAudioSource(AudioFileCache& cache, DiskStreamer& streamer, const juce::String& filePath)
     : audioCache(cache)
-    , state(trackState)
+    , diskStreamer(streamer)
+    , audioFilePath(filePath)
 {
-    updateFromState();
-    rebuildClips();
-}
+    // Loading the file here keeps it off the audio thread. The stream takes
+    // a reader only while the clip is cued, so idle clips on a streamed
+    // format hold no decoder.
+    if (audioCache.getReaderSource(audioFilePath) == nullptr)
+        return;
 
-void TrackAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
-{
-    samplesPerBlock = samplesPerBlockExpected;
-    currentSampleRate = sampleRate;
-    mixBuffer.setSize(2, samplesPerBlockExpected);
+    auto& cache = audioCache;
+    auto path = audioFilePath;
+
+    auto fileSampleRate = audioCache.getSampleRate(audioFilePath);
+    auto acquireReader = [&cache, path] { return cache.acquireReader(path); };
 
-    for (auto* clip : clips)
-        clip->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    stream = std::make_unique<DiskStreamer::Stream>(diskStreamer, acquireReader, fileSampleRate, 2);
+    loopStartStream = std::make_unique<DiskStreamer::Stream>(diskStreamer, acquireReader, fileSampleRate, 2);
 }
 
-void TrackAudioSource::releaseResources()
+void ClipAudioSource::setOfflineRendering(bool shouldReadDirectly)
 {
-    mixBuffer.setSize(0, 0);
-
-    for (auto* clip : clips)
-        clip->releaseResources();
+    offline = shouldReadDirectly;
+    offlineReader = offline && stream != nullptr ? audioCache.acquireReader(audioFilePath) : nullptr;
 }
 
-void TrackAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+void ClipAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    // Check if track should play
-    if (!shouldPlay())
-    {
-        bufferToFill.clearActiveBufferRegion();
-        currentPosition += bufferToFill.numSamples;
-        return;
-    }
-
-    // Clear output buffer
-    bufferToFill.clearActiveBufferRegion();
-
-    // Mix all clips
-    for (auto* clip : clips)
-    {
-        if (clip->isActiveAt(currentPosition))
-        {
-            // Prepare temp buffer for this clip
-            mixBuffer.clear();
-            juce::AudioSourceChannelInfo clipInfo(&mixBuffer, 0, bufferToFill.numSamples);
+    samplesPerBlock = samplesPerBlockExpected;
+    currentSampleRate = sampleRate;
 
-            clip->getNextAudioBlock(clipInfo);
+    // Files at another rate are converted to the device rate
+    double fileSampleRate = audioCache.getSampleRate(audioFilePath);
+    resampleRatio = (fileSampleRate > 0.0 && sampleRate > 0.0) ? fileSampleRate / sampleRate : 1.0;
+    resampledSourceStart = -1;
+    resampledPosition = -1;
+    converted.reset();
 
-            // Add to output buffer
-            for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch)
-            {
-                int srcCh = ch < mixBuffer.getNumChannels() ? ch : 0;
-                bufferToFill.buffer->addFrom(ch, bufferToFill.startSample,
-                    mixBuffer, srcCh, 0, bufferToFill.numSamples);
-            }
-        }
-        else
-        {
-            // Still advance clip position
-            clip->setNextReadPosition(currentPosition + bufferToFill.numSamples);
-        }
-    }
+    // Short, much reused files may be held decoded in memory
+    decoded = audioCache.getDecodedAudio(audioFilePath);
 
-    // Apply volume
-    if (volume != 1.0f)
+    if (needsResampling())
     {
-        bufferToFill.buffer->applyGain(bufferToFill.startSample,
-            bufferToFill.numSamples, volume);
+        resampler.prepare(2, resampleRatio, audioCache.getResamplingQuality(), samplesPerBlockExpected);
+        tempBuffer.setSize(2, resampler.getMaxInputSamplesPerCall());
+        converted = audioCache.getConvertedAudio(audioFilePath, sampleRate);
     }
-
-    // Apply pan
-    if (pan != 0.0f && bufferToFill.buffer->getNumChannels() >= 2)
+    else
     {
-        applyPan(*bufferToFill.buffer, pan);
+        tempBuffer.setSize(2, samplesPerBlockExpected);
     }
-
-    currentPosition += bufferToFill.numSamples;
 }
 
-void TrackAudioSource::setNextReadPosition(juce::int64 newPosition)
+void ClipAudioSource::releaseResources()
 {
-    currentPosition = newPosition;
-
-    for (auto* clip : clips)
-        clip->setNextReadPosition(newPosition);
+    tempBuffer.setSize(0, 0);
 }
 
-juce::int64 TrackAudioSource::getNextReadPosition() const
+void ClipAudioSource::cue(const RenderPlan::Clip& clip, juce::int64 timelinePosition)
 {
-    return currentPosition;
-}
+    if (stream == nullptr || offline)
+        return;
 
-juce::int64 TrackAudioSource::getTotalLength() const
-{
-    juce::int64 maxLength = 0;
+    auto sourcePosition = getStreamPosition(clip, timelinePosition);
 
-    for (auto* clip : clips)
+    if (sourcePosition < 0)
     {
-        juce::int64 clipEnd = clip->getTimelineEnd();
-        if (clipEnd > maxLength)
-            maxLength = clipEnd;
+        stream->park();
+        return;
     }
 
-    return maxLength;
-}
+    // Wrapped to the loop start: carry on with the ring primed for it
+    if (!stream->isPreparedFor(sourcePosition) && loopStartStream->isPreparedFor(sourcePosition))
+    {
+        std::swap(stream, loopStartStream);
+        loopStartStream->park();
+        return;
+    }
 
-float TrackAudioSource::getVolume() const
-{
-    return volume;
+    stream->prepareFor(sourcePosition);
 }
 
-float TrackAudioSource::getPan() const
+void ClipAudioSource::cueLoopStart(const RenderPlan::Clip& clip, juce::int64 loopStart)
 {
-    return pan;
-}
+    if (stream == nullptr || offline)
+        return;
 
-bool TrackAudioSource::isMuted() const
-{
-    return muted;
-}
+    auto sourcePosition = getStreamPosition(clip, loopStart);
 
-bool TrackAudioSource::isSoloed() const
-{
-    return soloed;
+    if (sourcePosition < 0)
+        loopStartStream->park();
+    else
+        loopStartStream->prepareFor(sourcePosition);
 }
 
-void TrackAudioSource::setSoloActiveInProject(bool soloActive)
+void ClipAudioSource::parkLoopStart()
 {
-    soloActiveInProject = soloActive;
+    if (loopStartStream != nullptr)
+        loopStartStream->park();
 }
 
-void TrackAudioSource::updateFromState()
+juce::int64 ClipAudioSource::getStreamPosition(const RenderPlan::Clip& clip, juce::int64 timelinePosition) const
 {
-    volume = static_cast<float>(state[IDs::volume]);
-    pan = static_cast<float>(state[IDs::pan]);
-    muted = static_cast<bool>(state[IDs::mute]);
-    soloed = static_cast<bool>(state[IDs::solo]);
+    auto leadIn = static_cast<juce::int64>(stream->getCapacity() / 2);
+
+    if (usesConvertedAudio() || usesDecodedAudio()
+        || timelinePosition < clip.timelineStart - leadIn || timelinePosition >= clip.timelineEnd)
+        return -1;
+
+    auto positionInClip = juce::jmax(static_cast<juce::int64>(0), timelinePosition - clip.timelineStart);
+    auto sourcePosition = clip.sourceStart + positionInClip;
+
+    // The resampler starts reading its latency before the exact position
+    if (needsResampling())
+        sourcePosition = static_cast<juce::int64>(std::floor(static_cast<double>(clip.sourceStart)
+                                                             + static_cast<double>(positionInClip) * resampleRatio))
+                         - resampler.getInputLatency();
+
+    return juce::jmax(static_cast<juce::int64>(0), sourcePosition);
 }
 
-juce::String TrackAudioSource::getTrackId() const
+void ClipAudioSource::read(const RenderPlan::Clip& clip, juce::AudioBuffer<float>& buffer,
+                           int startSample, int numSamples, juce::int64 timelinePosition)
 {
-    return state[IDs::trackId].toString();
+    if (stream == nullptr)
+    {
+        buffer.clear(startSample, numSamples);
+        return;
+    }
+
+    juce::int64 positionInClip = timelinePosition - clip.timelineStart;
+
+    if (usesConvertedAudio())
+    {
+        readConverted(clip, buffer, startSample, numSamples, positionInClip);
+    }
+    else if (needsResampling())
+    {
+        readResampled(clip, buffer, startSample, numSamples, positionInClip);
+    }
+    else
+    {
+        readSource(buffer, startSample, numSamples, clip.sourceStart + positionInClip);
+    }
 }
 
-void TrackAudioSource::rebuildClips()
+void ClipAudioSource::readSource(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                 juce::int64 sourcePosition)
 {
-    clips.clear();
-
-    for (int i = 0; i < state.getNumChildren(); ++i)
+    if (!usesDecodedAudio())
     {
-        auto child = state.getChild(i);
-        if (child.hasType(IDs::CLIP))
+        if (offline)
         {
-            auto* clip = new ClipAudioSource(audioCache, child);
-            clip->prepareToPlay(samplesPerBlock, currentSampleRate);
-            clips.add(clip);
+            if (offlineReader != nullptr)
+                offlineReader->read(&buffer, startSample, numSamples, sourcePosition, true, true);
+            else
+                buffer.clear(startSample, numSamples);
+
+            return;
         }
+
+        // Copy from the read-ahead ring; silence if the disk hasn't kept up
+        stream->read(buffer, startSample, numSamples, sourcePosition);
+        return;
+    }
+
+    const auto& source = decoded->buffer;
+    auto available = juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples),
+                                  static_cast<juce::int64>(source.getNumSamples()) - sourcePosition);
+    int numToCopy = static_cast<int>(available);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (numToCopy > 0)
+            buffer.copyFrom(ch, startSample, source, juce::jmin(ch, source.getNumChannels() - 1),
+                            static_cast<int>(sourcePosition), numToCopy);
+
+        if (numToCopy < numSamples)
+            buffer.clear(ch, startSample + numToCopy, numSamples - numToCopy);
     }
 }
 
-void TrackAudioSource::applyPan(juce::AudioBuffer<float>& buffer, float panValue)
+void ClipAudioSource::readConverted(const RenderPlan::Clip& clip, juce::AudioBuffer<float>& buffer,
+                                    int startSample, int numSamples, juce::int64 positionInClip)
 {
-    // Simple equal-power pan law
-    float leftGain = std::cos((panValue + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
-    float rightGain = std::sin((panValue + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
+    // sourceStart is in file samples; the copy is at the device rate
+    const auto& source = converted->buffer;
+    auto position = static_cast<juce::int64>(std::llround(static_cast<double>(clip.sourceStart) / resampleRatio))
+                    + positionInClip;
+
+    auto available = juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples),
+                                  static_cast<juce::int64>(source.getNumSamples()) - position);
+    int numToCopy = static_cast<int>(available);
 
-    if (buffer.getNumChannels() >= 2)
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
     {
-        buffer.applyGain(0, 0, buffer.getNumSamples(), leftGain);
-        buffer.applyGain(1, 0, buffer.getNumSamples(), rightGain);
+        if (numToCopy > 0)
+            buffer.copyFrom(ch, startSample, source, juce::jmin(ch, 1), static_cast<int>(position), numToCopy);
+
+        if (numToCopy < numSamples)
+            buffer.clear(ch, startSample + numToCopy, numSamples - numToCopy);
     }
 }
 
-bool TrackAudioSource::shouldPlay() const
+void ClipAudioSource::readResampled(const RenderPlan::Clip& clip, juce::AudioBuffer<float>& buffer,
+                                    int startSample, int numSamples, juce::int64 positionInClip)
 {
-    if (muted)
-        return false;
+    // Not continuing from the previous block (or the clip was moved or
+    // trimmed): restart at the exact file position
+    if (resampledPosition != positionInClip || resampledSourceStart != clip.sourceStart)
+    {
+        double sourcePosition = static_cast<double>(clip.sourceStart) + static_cast<double>(positionInClip) * resampleRatio;
+        auto whole = static_cast<juce::int64>(std::floor(sourcePosition));
 
-    if (soloActiveInProject && !soloed)
-        return false;
+        resampler.reset(sourcePosition - static_cast<double>(whole));
+        sourceReadPosition = whole - resampler.getInputLatency();
+    }
 
-    return true;
+    for (int done = 0; done < numSamples;)
+    {
+        int numThisTime = juce::jmin(samplesPerBlock, numSamples - done);
+        int numInput = resampler.getNumInputSamplesNeeded(numThisTime);
+
+        // Positions before the start of the file are silent
+        int numSilent = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numInput),
+                                                      -sourceReadPosition));
+        if (numSilent > 0)
+            tempBuffer.clear(0, numSilent);
+
+        if (numInput > numSilent)
+            readSource(tempBuffer, numSilent, numInput - numSilent, sourceReadPosition + numSilent);
+
+        sourceReadPosition += numInput;
+
+        float* output[] = { buffer.getWritePointer(0, startSample + done),
+                            buffer.getWritePointer(juce::jmin(1, buffer.getNumChannels() - 1), startSample + done) };
+        resampler.process(tempBuffer.getArrayOfReadPointers(), output, numThisTime);
+
+        done += numThisTime;
+    }
+
+    resampledSourceStart = clip.sourceStart;
+    resampledPosition = positionInClip + numSamples;
 }
 
 //==============================================================================
-// MultiTrackAudioSource Implementation
+// TrackAudioSource Implementation
 //==============================================================================
 
-MultiTrackAudioSource::MultiTrackAudioSource(juce::AudioFormatManager& fm)
-    : formatManager(fm)
-    , audioCache(fm)
+TrackAudioSource::TrackAudioSource(const juce::String& id)
+    : trackId(id)
 {
 }
 
-MultiTrackAudioSource::~MultiTrackAudioSource()
+void TrackAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    if (projectState.isValid())
-        projectState.removeListener(this);
-}
+    samplesPerBlock = samplesPerBlockExpected;
 
-void MultiTrackAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
-{
-    juce::ScopedLock sl(lock);
+    output.setSize(2, samplesPerBlockExpected);
+    clipBuffer.setSize(2, samplesPerBlockExpected);
+    gains.allocate(static_cast<size_t>(juce::jmax(1, samplesPerBlockExpected)), false);
 
-    samplesPerBlock = samplesPerBlockExpected;
-    currentSampleRate = sampleRate;
-    mixBuffer.setSize(2, samplesPerBlockExpected);
+    inserts.prepareToPlay(sampleRate, samplesPerBlockExpected);
+    insertMidi.ensureSize(2048);
 
-    for (auto* track : tracks)
-        track->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // Keeps its capacity; the plan's compensation still has to fit. The
+    // audio thread is held off, so the line the active plan uses can be
+    // re-prepared.
+    if (compensationDelay != nullptr)
+        compensationDelay->prepare(2, compensationDelay->getMaxDelay(), samplesPerBlockExpected);
 }
 
-void MultiTrackAudioSource::releaseResources()
+void TrackAudioSource::releaseResources()
 {
-    juce::ScopedLock sl(lock);
+    output.setSize(0, 0);
+    clipBuffer.setSize(0, 0);
+    inserts.releaseResources();
+}
 
-    mixBuffer.setSize(0, 0);
+std::shared_ptr<CompensationDelay> TrackAudioSource::getCompensationDelay(int delaySamples)
+{
+    if (compensationDelay == nullptr || delaySamples > compensationDelay->getMaxDelay())
+    {
+        auto line = std::make_shared<CompensationDelay>();
+        line->prepare(2, juce::nextPowerOfTwo(juce::jmax(1, delaySamples)), samplesPerBlock);
+        compensationDelay = std::move(line);
+    }
 
-    for (auto* track : tracks)
-        track->releaseResources();
+    return compensationDelay;
 }
 
-void MultiTrackAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+void TrackAudioSource::render(const RenderPlan& plan, const RenderPlan::Track& track,
+                              juce::int64 timelinePosition, int numSamples)
 {
-    juce::ScopedLock sl(lock);
+    output.clear(0, numSamples);
 
-    // Clear output buffer
-    bufferToFill.clearActiveBufferRegion();
-
-    if (tracks.isEmpty())
-        return;
+    const juce::int64 blockEnd = timelinePosition + numSamples;
 
-    // Handle looping
-    if (looping && loopEnd > loopStart)
+    // Clips overlapping the block: only the samples each one covers
+    plan.forEachClipOverlapping(track, timelinePosition, blockEnd, [&](const RenderPlan::Clip& clip)
     {
-        if (currentPosition >= loopEnd)
+        if (clip.source == nullptr)
+            return;
+
+        juce::int64 rangeStart = juce::jmax(clip.timelineStart, timelinePosition);
+        juce::int64 rangeEnd = juce::jmin(clip.timelineEnd, blockEnd);
+        int offset = static_cast<int>(rangeStart - timelinePosition);
+        int count = static_cast<int>(rangeEnd - rangeStart);
+
+        if (track.audible)
         {
-            currentPosition = loopStart;
-            for (auto* track : tracks)
-                track->setNextReadPosition(loopStart);
+            clip.source->read(clip, clipBuffer, offset, count, rangeStart);
+            addClip(clip, offset, count, rangeStart - clip.timelineStart);
         }
-    }
 
-    // Mix all tracks
-    for (auto* track : tracks)
+        // Keep a muted clip's stream moving; let go of one that ends here
+        if (!track.audible || clip.timelineEnd <= blockEnd)
+            clip.source->cue(clip, blockEnd);
+    });
+
+    // Clips starting soon: prime their streams
+    const int lastClip = track.firstClip + track.numClips;
+
+    for (int i = plan.findFirstClipStartingFrom(track, blockEnd); i < lastClip; ++i)
     {
-        mixBuffer.clear();
-        juce::AudioSourceChannelInfo trackInfo(&mixBuffer, 0, bufferToFill.numSamples);
+        const auto& clip = plan.clips[static_cast<size_t>(i)];
 
-        track->getNextAudioBlock(trackInfo);
+        if (clip.timelineStart >= blockEnd + plan.cueAheadSamples)
+            break;
 
-        // Add to output buffer
-        for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch)
-        {
-            int srcCh = ch < mixBuffer.getNumChannels() ? ch : 0;
-            bufferToFill.buffer->addFrom(ch, bufferToFill.startSample,
-                mixBuffer, srcCh, 0, bufferToFill.numSamples);
-        }
+        if (clip.source != nullptr)
+            clip.source->cue(clip, blockEnd);
     }
 
-    // Apply master volume
-    if (masterVolume != 1.0f)
+    // Inserts, then the delay that lines this track up with the slowest
+    if (track.audible && track.insertsActive && !insertsHeld.load())
+    {
+        juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), output.getNumChannels(), numSamples);
+        insertMidi.clear();
+        getInserts().processBlock(block, insertMidi);
+    }
+
+    track.compensationDelay->process(output, 0, numSamples, track.compensationSamples);
+
+    // Volume and pan
+    output.applyGain(0, 0, numSamples, track.leftGain);
+    output.applyGain(1, 0, numSamples, track.rightGain);
+}
+
+void TrackAudioSource::addClip(const RenderPlan::Clip& clip, int offset, int numSamples, juce::int64 positionInClip)
+{
+    const auto fadeOutStart = clip.getLength() - clip.fadeOutSamples;
+    const bool inFadeIn = clip.fadeInSamples > 0 && positionInClip < clip.fadeInSamples;
+    const bool inFadeOut = clip.fadeOutSamples > 0 && positionInClip + numSamples > fadeOutStart;
+
+    // No fade here: one gain for the whole stretch, none at unity
+    if (!inFadeIn && !inFadeOut)
+    {
+        if (clip.gain == 0.0f)
+            return;
+
+        for (int ch = 0; ch < output.getNumChannels(); ++ch)
+        {
+            if (clip.gain == 1.0f)
+                output.addFrom(ch, offset, clipBuffer, ch, offset, numSamples);
+            else
+                output.addFrom(ch, offset, clipBuffer, ch, offset, numSamples, clip.gain);
+        }
+
+        return;
+    }
+
+    // Gain ramp, computed once and applied to every channel
+    float* gain = gains.get();
+    juce::FloatVectorOperations::fill(gain, clip.gain, numSamples);
+
+    if (inFadeIn)
+    {
+        const auto fadeLength = static_cast<double>(clip.fadeInSamples);
+        const int count = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples),
+                                                      clip.fadeInSamples - positionInClip));
+
+        FadeCurve::multiplyRamp(clip.fadeInCurve, gain, count,
+                                static_cast<double>(positionInClip) / fadeLength, 1.0 / fadeLength);
+    }
+
+    if (inFadeOut)
+    {
+        const auto fadeLength = static_cast<double>(clip.fadeOutSamples);
+        const auto first = juce::jmax(positionInClip, fadeOutStart);
+        const int skip = static_cast<int>(first - positionInClip);
+
+        FadeCurve::multiplyRamp(clip.fadeOutCurve, gain + skip, numSamples - skip,
+                                1.0 - static_cast<double>(first - fadeOutStart) / fadeLength, -1.0 / fadeLength);
+    }
+
+    for (int ch = 0; ch < output.getNumChannels(); ++ch)
+        juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(ch, offset),
+                                                     clipBuffer.getReadPointer(ch, offset), gain, numSamples);
+}
+
+void TrackAudioSource::cue(const RenderPlan& plan, const RenderPlan::Track& track, juce::int64 timelinePosition)
+{
+    for (int i = track.firstClip; i < track.firstClip + track.numClips; ++i)
+    {
+        const auto& clip = plan.clips[static_cast<size_t>(i)];
+
+        if (clip.source != nullptr)
+        {
+            clip.source->cue(clip, timelinePosition);
+            clip.source->parkLoopStart();
+        }
+    }
+}
+
+void TrackAudioSource::cueLoopStart(const RenderPlan& plan, const RenderPlan::Track& track, juce::int64 loopStart)
+{
+    plan.forEachClipOverlapping(track, loopStart, loopStart + plan.cueAheadSamples, [loopStart](const RenderPlan::Clip& clip)
+    {
+        if (clip.source != nullptr)
+            clip.source->cueLoopStart(clip, loopStart);
+    });
+}
+
+//==============================================================================
+// MultiTrackAudioSource Implementation
+//==============================================================================
+
+MultiTrackAudioSource::MultiTrackAudioSource(juce::AudioFormatManager& fm)
+    : formatManager(fm)
+    , audioCache(fm)
+{
+    // A changed chain can change the latency to compensate for
+    masterInserts.onChainChanged = [this]() { scheduleCompile(); };
+
+    startTimer(500);
+}
+
+MultiTrackAudioSource::~MultiTrackAudioSource()
+{
+    stopTimer();
+    cancelPendingUpdate();
+
+    if (projectState.isValid())
+        projectState.removeListener(this);
+
+    delete pendingPlan.exchange(nullptr);
+    delete activePlan;
+    activePlan = nullptr;
+    freeRetiredPlans();
+
+    lastPlan.reset();
+    trackSources.clear();
+    clipSources.clear();
+}
+
+void MultiTrackAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    const juce::ScopedLock cl(compileLock);
+    const juce::ScopedLock rl(renderLock);
+
+    samplesPerBlock = samplesPerBlockExpected;
+    currentSampleRate = sampleRate;
+    meters.setSampleRate(sampleRate);
+
+    // Take the latest plan now; its sources are exactly the ones below
+    if (auto* plan = pendingPlan.exchange(nullptr))
+    {
+        delete activePlan;
+        activePlan = plan;
+    }
+
+    for (auto& entry : trackSources)
+        entry.second->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    for (auto& entry : clipSources)
+        entry.second->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    masterInserts.prepareToPlay(sampleRate, samplesPerBlockExpected);
+    masterMidi.ensureSize(2048);
+
+    // File positions for the current timeline position may have moved
+    pendingSeek = currentPosition.load();
+}
+
+void MultiTrackAudioSource::releaseResources()
+{
+    const juce::ScopedLock cl(compileLock);
+    const juce::ScopedLock rl(renderLock);
+
+    for (auto& entry : trackSources)
+        entry.second->releaseResources();
+
+    for (auto& entry : clipSources)
+        entry.second->releaseResources();
+
+    masterInserts.releaseResources();
+}
+
+void MultiTrackAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // Marked before anything is read, so waitForBlockInProgress() can't
+    // miss a block that saw the old state
+    struct BlockMark
+    {
+        explicit BlockMark(std::atomic<juce::uint32>& e) : epoch(e) { ++epoch; }
+        ~BlockMark() { ++epoch; }
+        std::atomic<juce::uint32>& epoch;
+    } blockMark(blockEpoch);
+
+    // Clear output buffer
+    bufferToFill.clearActiveBufferRegion();
+
+    // Silent while prepareToPlay() is running
+    const juce::ScopedTryLock stl(renderLock);
+    if (!stl.isLocked())
+        return;
+
+    // Clips new to an adopted plan start streaming from the current position;
+    // a patched plan only moved the clips it lists
+    bool needsCue = adoptPendingPlan();
+    bool needsPatchedCue = needsCue && activePlan != nullptr && activePlan->patched;
+    needsCue = needsCue && !needsPatchedCue;
+    auto position = currentPosition.load();
+
+    auto seek = pendingSeek.exchange(-1);
+    if (seek >= 0)
+    {
+        position = seek;
+        needsCue = true;
+    }
+
+    if (activePlan == nullptr || activePlan->tracks.empty())
+    {
+        currentPosition = position;
+        return;
+    }
+
+    for (int done = 0; done < bufferToFill.numSamples;)
+    {
+        // Handle looping
+        auto end = loopEnd.load();
+        if (looping && end > loopStart.load() && position >= end)
+        {
+            position = loopStart.load();
+            needsCue = true;
+        }
+
+        if (needsCue)
+        {
+            for (const auto& track : activePlan->tracks)
+                track.source->cue(*activePlan, track, position);
+
+            needsCue = false;
+            needsPatchedCue = false;
+        }
+        else if (needsPatchedCue)
+        {
+            for (auto index : activePlan->patchedClips)
+            {
+                const auto& clip = activePlan->clips[static_cast<size_t>(index)];
+                if (clip.source != nullptr)
+                    clip.source->cue(clip, position);
+            }
+
+            needsPatchedCue = false;
+        }
+
+        // Track buffers hold one prepared block
+        int numThisTime = juce::jmin(samplesPerBlock, bufferToFill.numSamples - done);
+
+        // Nearing the loop end: have the streams at the loop start filled by
+        // the time it wraps, rather than re-priming them all at once then
+        if (looping && end > loopStart.load() && position + numThisTime + activePlan->cueAheadSamples >= end)
+        {
+            for (const auto& track : activePlan->tracks)
+                track.source->cueLoopStart(*activePlan, track, loopStart.load());
+        }
+
+        renderPlan(juce::AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + done, numThisTime),
+                   position);
+
+        position += numThisTime;
+        done += numThisTime;
+    }
+
+    currentPosition = position;
+}
+
+void MultiTrackAudioSource::renderPlan(const juce::AudioSourceChannelInfo& bufferToFill, juce::int64 position)
+{
+    const auto& plan = *activePlan;
+    auto& buffer = *bufferToFill.buffer;
+
+    // Render all tracks
+    trackRenderJob.plan = &plan;
+    trackRenderJob.meters = offlineRendering ? nullptr : &meters;
+    trackRenderJob.position = position;
+    trackRenderJob.numSamples = bufferToFill.numSamples;
+
+    const int numTracks = static_cast<int>(plan.tracks.size());
+
+    if (numTracks >= minTracksForParallelRender)
+    {
+        renderPool.run(trackRenderJob, numTracks);
+    }
+    else
     {
-        bufferToFill.buffer->applyGain(bufferToFill.startSample,
-            bufferToFill.numSamples, masterVolume);
+        for (int i = 0; i < numTracks; ++i)
+            trackRenderJob.perform(i);
     }
 
+    // Mix them
+    for (const auto& track : plan.tracks)
+    {
+        if (!track.audible)
+            continue;
+
+        const auto& trackOutput = track.source->getOutput();
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            int srcCh = ch < trackOutput.getNumChannels() ? ch : 0;
+            buffer.addFrom(ch, bufferToFill.startSample, trackOutput, srcCh, 0, bufferToFill.numSamples);
+        }
+    }
+
+    // Master inserts (on the first two channels)
+    if (buffer.getNumChannels() >= 2 && !masterInsertsHeld.load())
+    {
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2,
+                                       bufferToFill.startSample, bufferToFill.numSamples);
+        masterMidi.clear();
+        getActiveMasterInserts().processBlock(block, masterMidi);
+    }
+
+    // Apply master volume
+    float volume = masterVolume.load();
+    if (volume != 1.0f)
+        buffer.applyGain(bufferToFill.startSample, bufferToFill.numSamples, volume);
+
     // Apply master pan
-    if (masterPan != 0.0f)
+    float pan = masterPan.load();
+    if (pan != 0.0f)
+        applyMasterPan(buffer, bufferToFill.startSample, bufferToFill.numSamples, pan);
+
+    if (!offlineRendering)
+        meters.measure(TrackMeterBank::masterIndex, buffer, bufferToFill.startSample, bufferToFill.numSamples);
+}
+
+void MultiTrackAudioSource::TrackRenderJob::perform(int taskIndex) noexcept
+{
+    const auto& track = plan->tracks[static_cast<size_t>(taskIndex)];
+    track.source->render(*plan, track, position, numSamples);
+
+    // Post-fader, on the thread that rendered it
+    if (meters != nullptr)
+        meters->measure(track.meterIndex, track.source->getOutput(), 0, numSamples);
+}
+
+bool MultiTrackAudioSource::adoptPendingPlan()
+{
+    if (pendingPlan.load() == nullptr)
+        return false;
+
+    // No room to retire the current plan: try again next block
+    if (activePlan != nullptr && retiredFifo.getFreeSpace() == 0)
+        return false;
+
+    auto* plan = pendingPlan.exchange(nullptr);
+    if (plan == nullptr)
+        return false;
+
+    if (activePlan != nullptr)
     {
-        applyMasterPan(*bufferToFill.buffer);
+        int start1, size1, start2, size2;
+        retiredFifo.prepareToWrite(1, start1, size1, start2, size2);
+        retiredPlans[static_cast<size_t>(size1 > 0 ? start1 : start2)] = activePlan;
+        retiredFifo.finishedWrite(1);
     }
 
-    currentPosition += bufferToFill.numSamples;
+    activePlan = plan;
+    return true;
 }
 
 void MultiTrackAudioSource::setNextReadPosition(juce::int64 newPosition)
 {
-    juce::ScopedLock sl(lock);
-
     currentPosition = newPosition;
-
-    for (auto* track : tracks)
-        track->setNextReadPosition(newPosition);
+    pendingSeek = newPosition;
 }
 
 juce::int64 MultiTrackAudioSource::getNextReadPosition() const
 {
-    return currentPosition;
+    return currentPosition.load();
 }
 
 juce::int64 MultiTrackAudioSource::getTotalLength() const
 {
-    juce::int64 maxLength = 0;
+    return totalLength.load();
+}
+
+//==============================================================================
+// Plan compilation
+//==============================================================================
+
+std::unique_ptr<RenderPlan> MultiTrackAudioSource::compilePlan()
+{
+    auto plan = std::make_unique<RenderPlan>();
+    plan->cueAheadSamples = static_cast<juce::int64>(currentSampleRate * DiskStreamer::defaultReadAheadSeconds / 2.0);
+
+    std::map<juce::String, std::shared_ptr<TrackAudioSource>> newTrackSources;
+    std::map<juce::String, std::shared_ptr<ClipAudioSource>> newClipSources;
+
+    lastPlanClipIds.clear();
+    lastPlanClipIndices.clear();
+    clipIdsUnique = true;
+
+    if (projectState.isValid())
+    {
+        bool anySoloed = false;
+
+        for (int i = 0; i < projectState.getNumChildren(); ++i)
+        {
+            auto child = projectState.getChild(i);
+            if (child.hasType(IDs::TRACK) && static_cast<bool>(child[IDs::solo]))
+                anySoloed = true;
+        }
+
+        for (int i = 0; i < projectState.getNumChildren(); ++i)
+        {
+            auto trackState = projectState.getChild(i);
+            if (!trackState.hasType(IDs::TRACK))
+                continue;
+
+            // Reuse the track's source, or make one (a duplicate ID gets its own)
+            auto trackId = trackState[IDs::trackId].toString();
+            std::shared_ptr<TrackAudioSource> trackSource;
+            auto existingTrack = trackSources.find(trackId);
+
+            if (existingTrack != trackSources.end() && newTrackSources.count(trackId) == 0)
+            {
+                trackSource = existingTrack->second;
+            }
+            else
+            {
+                trackSource = std::make_shared<TrackAudioSource>(trackId);
+                trackSource->prepareToPlay(samplesPerBlock, currentSampleRate);
+                trackSource->getInserts().onChainChanged = [this]() { scheduleCompile(); };
+                trackSource->getInserts().onStateChanged = [this, trackId]()
+                {
+                    if (onTrackInsertsStateChanged != nullptr)
+                        onTrackInsertsStateChanged(trackId);
+                };
+
+                auto borrowed = borrowedTrackInserts.find(trackId);
+                if (borrowed != borrowedTrackInserts.end())
+                    trackSource->setBorrowedInserts(borrowed->second);
+            }
+
+            if (newTrackSources.count(trackId) == 0)
+                newTrackSources[trackId] = trackSource;
+
+            plan->trackSources.push_back(trackSource);
+
+            // A frozen track plays its render instead of its clips
+            TrackModel trackModel(trackState);
+            const bool frozen = trackModel.isFrozen() && trackModel.getFreezeFile().existsAsFile();
+
+            // Volume and equal-power pan law in one gain per side
+            float volume = static_cast<float>(trackState[IDs::volume]);
+            float pan = static_cast<float>(trackState[IDs::pan]);
+            bool muted = static_cast<bool>(trackState[IDs::mute]);
+            bool soloed = static_cast<bool>(trackState[IDs::solo]);
+
+            RenderPlan::Track track;
+            track.source = trackSource.get();
+            track.firstClip = static_cast<int>(plan->clips.size());
+            track.numClips = 0;
+            track.clipTreeRoot = -1;
+            track.leftGain = volume;
+            track.rightGain = volume;
+            track.audible = !muted && (!anySoloed || soloed);
+            track.insertsActive = !frozen;
+
+            // A duplicate ID isn't metered; its meter belongs to the first
+            track.meterIndex = newTrackSources[trackId] == trackSource ? meters.assign(trackId) : -1;
+
+            trackSource->getInserts().updateLatency();
+            track.latencySamples = frozen ? 0 : trackSource->getInserts().getLatencySamples();
+            track.compensationSamples = 0;
+            track.compensationDelay = nullptr;
+
+            if (pan != 0.0f)
+            {
+                track.leftGain *= std::cos((pan + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
+                track.rightGain *= std::sin((pan + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
+            }
+
+            juce::Array<juce::ValueTree> clipStates;
+
+            if (frozen)
+            {
+                // The render as one clip, at unity gain
+                auto freezePath = trackModel.getFreezeFile().getFullPathName();
+                audioCache.getReaderSource(freezePath);
+
+                juce::ValueTree freezeClip(IDs::CLIP);
+                freezeClip.setProperty(IDs::clipId, "freeze:" + trackId, nullptr);
+                freezeClip.setProperty(IDs::audioFilePath, freezePath, nullptr);
+                freezeClip.setProperty(IDs::timelineStart, trackModel.getFreezeStart(), nullptr);
+                freezeClip.setProperty(IDs::length, audioCache.getLengthInSamples(freezePath), nullptr);
+                freezeClip.setProperty(IDs::gain, 1.0f, nullptr);
+                clipStates.add(freezeClip);
+            }
+            else
+            {
+                clipStates = trackModel.getClipsSortedByTime();
+            }
+
+            for (const auto& clipState : clipStates)
+            {
+                auto clipId = clipState[IDs::clipId].toString();
+                auto filePath = clipState[IDs::audioFilePath].toString();
+
+                // Keep the clip's stream and resampler while it stays on its file
+                std::shared_ptr<ClipAudioSource> clipSource;
+                auto existingClip = clipSources.find(clipId);
+
+                if (existingClip != clipSources.end() && newClipSources.count(clipId) == 0
+                    && existingClip->second->getAudioFilePath() == filePath)
+                {
+                    clipSource = existingClip->second;
+                }
+                else
+                {
+                    clipSource = std::make_shared<ClipAudioSource>(audioCache, diskStreamer, filePath);
+                    clipSource->setOfflineRendering(offlineRendering);
+                    clipSource->prepareToPlay(samplesPerBlock, currentSampleRate);
+                }
+
+                if (newClipSources.count(clipId) == 0)
+                    newClipSources[clipId] = clipSource;
+
+                plan->clipSources.push_back(clipSource);
+
+                RenderPlan::Clip clip;
+                clip.source = clipSource->isLoaded() ? clipSource.get() : nullptr;
+                readClipPlacement(clipState, clip);
+
+                // Where clip edits get patched in (not if an ID is shared)
+                clipIdsUnique = clipIdsUnique && lastPlanClipIndices.count(clipId) == 0;
+                lastPlanClipIndices[clipId] = static_cast<int>(plan->clips.size());
+                lastPlanClipIds.push_back(clipId);
+
+                plan->clips.push_back(clip);
+                ++track.numClips;
+            }
+
+            plan->tracks.push_back(track);
+        }
+    }
+
+    plan->indexClips();
+
+    // Delay every track to the slowest one's latency. A line too short for
+    // its track's delay is replaced by a longer one in this plan (rare: only
+    // when the latency to cover goes up), so playback never waits on it.
+    int maxTrackLatency = 0;
+    for (const auto& track : plan->tracks)
+        maxTrackLatency = juce::jmax(maxTrackLatency, track.latencySamples);
+
+    for (auto& track : plan->tracks)
+    {
+        track.compensationSamples = maxTrackLatency - track.latencySamples;
+
+        auto line = track.source->getCompensationDelay(track.compensationSamples);
+        track.compensationDelay = line.get();
+        plan->compensationDelays.push_back(std::move(line));
+    }
+
+    getActiveMasterInserts().updateLatency();
+    latencySamples = maxTrackLatency + getActiveMasterInserts().getLatencySamples();
+
+    // Meters of removed tracks can be handed out again
+    juce::StringArray meteredTracks;
+    for (const auto& entry : newTrackSources)
+        meteredTracks.add(entry.first);
+
+    meters.retainOnly(meteredTracks);
+
+    // Sources no longer used go when the last plan holding them is freed
+    if (onTrackInsertsReleased != nullptr)
+    {
+        for (auto& entry : trackSources)
+        {
+            auto kept = newTrackSources.find(entry.first);
+            if (kept == newTrackSources.end() || kept->second != entry.second)
+                onTrackInsertsReleased(entry.second->getInserts());
+        }
+    }
+
+    trackSources = std::move(newTrackSources);
+    clipSources = std::move(newClipSources);
+
+    editedClips.clear();
+    needsCompile = false;
+    unadoptedFullCompile = true;
+    unadoptedPatchIds.clear();
+
+    return plan;
+}
+
+void MultiTrackAudioSource::readClipPlacement(const juce::ValueTree& clipState, RenderPlan::Clip& clip)
+{
+    clip.timelineStart = static_cast<juce::int64>(clipState[IDs::timelineStart]);
+    clip.timelineEnd = clip.timelineStart + static_cast<juce::int64>(clipState[IDs::length]);
+    clip.sourceStart = static_cast<juce::int64>(clipState[IDs::sourceStart]);
+    clip.fadeInSamples = static_cast<juce::int64>(clipState[IDs::fadeInSamples]);
+    clip.fadeOutSamples = static_cast<juce::int64>(clipState[IDs::fadeOutSamples]);
+    clip.fadeInCurve = FadeCurve::fromInt(static_cast<int>(clipState[IDs::fadeInCurve]));
+    clip.fadeOutCurve = FadeCurve::fromInt(static_cast<int>(clipState[IDs::fadeOutCurve]));
+    clip.gain = static_cast<float>(clipState[IDs::gain]);
+}
+
+std::unique_ptr<RenderPlan> MultiTrackAudioSource::patchPlan()
+{
+    if (lastPlan == nullptr || !clipIdsUnique)
+        return nullptr;
 
-    for (auto* track : tracks)
+    // Changes in a plan the audio thread hasn't picked up yet carry over
+    // into this one, which replaces it
+    if (pendingPlan.load() == nullptr)
     {
-        juce::int64 trackLength = track->getTotalLength();
-        if (trackLength > maxLength)
-            maxLength = trackLength;
+        unadoptedFullCompile = false;
+        unadoptedPatchIds.clear();
+    }
+
+    auto plan = std::make_unique<RenderPlan>(*lastPlan);
+
+    std::vector<bool> tracksEdited(plan->tracks.size(), false);
+
+    for (const auto& clipState : editedClips)
+    {
+        TrackModel track(clipState.getParent());
+
+        // Removed since (a compile follows), or on a frozen track, which
+        // plays its freeze file instead
+        if (!track.isValid())
+            return nullptr;
+
+        if (track.isFrozen())
+            continue;
+
+        auto clipId = clipState[IDs::clipId].toString();
+        auto found = lastPlanClipIndices.find(clipId);
+        if (found == lastPlanClipIndices.end())
+            return nullptr;
+
+        readClipPlacement(clipState, plan->clips[static_cast<size_t>(found->second)]);
+        unadoptedPatchIds.addIfNotAlreadyThere(clipId);
+
+        for (size_t t = 0; t < plan->tracks.size(); ++t)
+        {
+            const auto& planTrack = plan->tracks[t];
+            if (found->second >= planTrack.firstClip && found->second < planTrack.firstClip + planTrack.numClips)
+                tracksEdited[t] = true;
+        }
+    }
+
+    // Re-sort only the edited tracks' clips
+    for (size_t t = 0; t < plan->tracks.size(); ++t)
+    {
+        if (!tracksEdited[t])
+            continue;
+
+        const auto& planTrack = plan->tracks[t];
+        const auto first = static_cast<size_t>(planTrack.firstClip);
+        const auto count = static_cast<size_t>(planTrack.numClips);
+
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; ++i)
+            order[i] = first + i;
+
+        std::stable_sort(order.begin(), order.end(), [&plan](size_t a, size_t b)
+        {
+            return plan->clips[a].timelineStart < plan->clips[b].timelineStart;
+        });
+
+        std::vector<RenderPlan::Clip> sortedClips;
+        std::vector<juce::String> sortedIds;
+        sortedClips.reserve(count);
+        sortedIds.reserve(count);
+
+        for (auto index : order)
+        {
+            sortedClips.push_back(plan->clips[index]);
+            sortedIds.push_back(lastPlanClipIds[index]);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            plan->clips[first + i] = sortedClips[i];
+            lastPlanClipIds[first + i] = sortedIds[i];
+            lastPlanClipIndices[sortedIds[i]] = static_cast<int>(first + i);
+        }
     }
 
-    return maxLength;
+    plan->indexClips();
+
+    // Only the edited clips need re-aiming when it's picked up, unless a
+    // full compile is still waiting to be
+    plan->patched = !unadoptedFullCompile;
+    plan->patchedClips.clear();
+
+    for (const auto& clipId : unadoptedPatchIds)
+    {
+        auto found = lastPlanClipIndices.find(clipId);
+        if (found != lastPlanClipIndices.end())
+            plan->patchedClips.push_back(found->second);
+    }
+
+    editedClips.clear();
+    return plan;
 }
 
-void MultiTrackAudioSource::loadProject(const juce::ValueTree& newProjectState)
+void MultiTrackAudioSource::publishPlan(std::unique_ptr<RenderPlan> plan)
+{
+    totalLength = plan->totalLength;
+
+    // Kept for patching the next clip edits into
+    lastPlan = std::make_unique<RenderPlan>(*plan);
+
+    // A plan the audio thread never picked up is simply replaced
+    delete pendingPlan.exchange(plan.release());
+
+    freeRetiredPlans();
+}
+
+void MultiTrackAudioSource::freeRetiredPlans()
+{
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToRead(retiredFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        delete retiredPlans[static_cast<size_t>(start1 + i)];
+
+    for (int i = 0; i < size2; ++i)
+        delete retiredPlans[static_cast<size_t>(start2 + i)];
+
+    retiredFifo.finishedRead(size1 + size2);
+}
+
+void MultiTrackAudioSource::handleAsyncUpdate()
+{
+    const juce::ScopedLock sl(compileLock);
+
+    if (!needsCompile && editedClips.isEmpty())
+        return;
+
+    // Clip placement edits (drags, trims, fades) patch the last plan;
+    // anything else, or a patch that can't be made, compiles a new one
+    std::unique_ptr<RenderPlan> plan;
+
+    if (!needsCompile)
+        plan = patchPlan();
+
+    publishPlan(plan != nullptr ? std::move(plan) : compilePlan());
+}
+
+void MultiTrackAudioSource::scheduleCompile()
+{
+    needsCompile = true;
+    triggerAsyncUpdate();
+}
+
+void MultiTrackAudioSource::timerCallback()
+{
+    freeRetiredPlans();
+    checkInsertLatencies();
+}
+
+void MultiTrackAudioSource::checkInsertLatencies()
+{
+    // Plugins may report a new latency at any time (a lookahead setting,
+    // say); recompile to move the compensation with it
+    bool changed = getActiveMasterInserts().updateLatency();
+
+    for (auto& entry : trackSources)
+        changed = entry.second->getInserts().updateLatency() || changed;
+
+    if (changed)
+        scheduleCompile();
+}
+
+EffectChain* MultiTrackAudioSource::getTrackInserts(const juce::String& trackId)
+{
+    auto it = trackSources.find(trackId);
+    return it != trackSources.end() ? &it->second->getInserts() : nullptr;
+}
+
+std::shared_ptr<EffectChain> MultiTrackAudioSource::holdTrackInserts(const juce::String& trackId)
+{
+    auto it = trackSources.find(trackId);
+    if (it == trackSources.end())
+        return nullptr;
+
+    auto source = it->second;
+    if (source->areInsertsHeld())
+        return nullptr;
+
+    source->setInsertsHeld(true);
+
+    // A block already past the check finishes first
+    waitForBlockInProgress();
+
+    return std::shared_ptr<EffectChain>(&source->getInserts(),
+                                        [source](EffectChain*) { source->setInsertsHeld(false); });
+}
+
+std::shared_ptr<EffectChain> MultiTrackAudioSource::holdMasterInserts()
+{
+    if (masterInsertsHeld.exchange(true))
+        return nullptr;
+
+    // As for a track's: a block already past the check finishes first
+    waitForBlockInProgress();
+
+    return std::shared_ptr<EffectChain>(&masterInserts, [this](EffectChain*) { masterInsertsHeld = false; });
+}
+
+void MultiTrackAudioSource::waitForBlockInProgress() const
+{
+    const auto epoch = blockEpoch.load();
+
+    if ((epoch & 1) == 0)
+        return;
+
+    while (blockEpoch.load() == epoch)
+        juce::Thread::yield();
+}
+
+void MultiTrackAudioSource::borrowInserts(std::map<juce::String, std::shared_ptr<EffectChain>> trackChains,
+                                          std::shared_ptr<EffectChain> masterChain)
 {
-    juce::ScopedLock sl(lock);
+    const juce::ScopedLock sl(compileLock);
+
+    borrowedTrackInserts = std::move(trackChains);
+    borrowedMasterInserts = std::move(masterChain);
+}
+
+//==============================================================================
+// Project management
+//==============================================================================
 
+void MultiTrackAudioSource::loadProject(const juce::ValueTree& newProjectState)
+{
     // Remove listener from old state
     if (projectState.isValid())
         projectState.removeListener(this);
@@ -586,81 +1630,98 @@ void MultiTrackAudioSource::loadProject(const juce::ValueTree& newProjectState)
 
 void MultiTrackAudioSource::unloadProject()
 {
-    juce::ScopedLock sl(lock);
-
     if (projectState.isValid())
         projectState.removeListener(this);
 
     projectState = juce::ValueTree();
-    tracks.clear();
+    cancelPendingUpdate();
+    rebuildFromProject();
+
+    // Playing clips keep their own references to the readers
     audioCache.clearCache();
-    currentPosition = 0;
+    setNextReadPosition(0);
 }
 
 void MultiTrackAudioSource::rebuildFromProject()
 {
-    juce::ScopedLock sl(lock);
+    const juce::ScopedLock sl(compileLock);
+    publishPlan(compilePlan());
+}
 
-    tracks.clear();
+double MultiTrackAudioSource::getProjectSampleRate() const
+{
+    return projectSampleRate;
+}
 
-    if (!projectState.isValid())
-        return;
+void MultiTrackAudioSource::setResamplingQuality(SincResampler::Quality quality)
+{
+    const juce::ScopedLock sl(compileLock);
 
-    for (int i = 0; i < projectState.getNumChildren(); ++i)
-    {
-        auto child = projectState.getChild(i);
-        if (child.hasType(IDs::TRACK))
-        {
-            auto* track = new TrackAudioSource(audioCache, child);
-            track->prepareToPlay(samplesPerBlock, currentSampleRate);
-            tracks.add(track);
-        }
-    }
+    audioCache.setResamplingQuality(quality);
 
-    updateSoloState();
+    // Playing clips can't be re-prepared under the audio thread; new ones
+    // pick up the new kernel and take over with the next plan
+    clipSources.clear();
+    publishPlan(compilePlan());
 }
 
-double MultiTrackAudioSource::getProjectSampleRate() const
+void MultiTrackAudioSource::setConvertedAudioCacheEnabled(bool shouldCache)
 {
-    return projectSampleRate;
+    const juce::ScopedLock sl(compileLock);
+
+    audioCache.setConvertedAudioCacheEnabled(shouldCache);
+
+    clipSources.clear();
+    publishPlan(compilePlan());
 }
 
-void MultiTrackAudioSource::setLoopRange(juce::int64 startSample, juce::int64 endSample)
+void MultiTrackAudioSource::setOfflineRendering(bool shouldRenderOffline)
 {
-    loopStart = startSample;
-    loopEnd = endSample;
+    const juce::ScopedLock sl(compileLock);
+
+    offlineRendering = shouldRenderOffline;
+
+    clipSources.clear();
+    publishPlan(compilePlan());
 }
 
-void MultiTrackAudioSource::updateSoloState()
+void MultiTrackAudioSource::setDecodedAudioBudget(juce::int64 bytes)
 {
-    bool anySoloed = false;
+    const juce::ScopedLock sl(compileLock);
 
-    for (auto* track : tracks)
-    {
-        if (track->isSoloed())
-        {
-            anySoloed = true;
-            break;
-        }
-    }
+    audioCache.setDecodedAudioBudget(bytes);
 
-    for (auto* track : tracks)
-    {
-        track->setSoloActiveInProject(anySoloed);
-    }
+    clipSources.clear();
+    publishPlan(compilePlan());
 }
 
-void MultiTrackAudioSource::applyMasterPan(juce::AudioBuffer<float>& buffer)
+void MultiTrackAudioSource::setFilePinned(const juce::String& filePath, bool shouldPin)
+{
+    const juce::ScopedLock sl(compileLock);
+
+    audioCache.setPinned(filePath, shouldPin);
+
+    clipSources.clear();
+    publishPlan(compilePlan());
+}
+
+void MultiTrackAudioSource::setLoopRange(juce::int64 startSample, juce::int64 endSample)
+{
+    loopStart = startSample;
+    loopEnd = endSample;
+}
+
+void MultiTrackAudioSource::applyMasterPan(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float pan)
 {
     if (buffer.getNumChannels() < 2)
         return;
 
     // Simple equal-power pan law
-    float leftGain = std::cos((masterPan + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
-    float rightGain = std::sin((masterPan + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
+    float leftGain = std::cos((pan + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
+    float rightGain = std::sin((pan + 1.0f) * juce::MathConstants<float>::halfPi / 2.0f);
 
-    buffer.applyGain(0, 0, buffer.getNumSamples(), leftGain);
-    buffer.applyGain(1, 0, buffer.getNumSamples(), rightGain);
+    buffer.applyGain(0, startSample, numSamples, leftGain);
+    buffer.applyGain(1, startSample, numSamples, rightGain);
 }
 
 //==============================================================================
@@ -670,112 +1731,64 @@ void MultiTrackAudioSource::applyMasterPan(juce::AudioBuffer<float>& buffer)
 void MultiTrackAudioSource::valueTreePropertyChanged(juce::ValueTree& tree,
                                                       const juce::Identifier& property)
 {
-    juce::ScopedLock sl(lock);
-
-    if (tree.hasType(IDs::TRACK))
+    if (tree.hasType(IDs::MASTER))
     {
-        // Find and update the track
-        juce::String trackId = tree[IDs::trackId].toString();
-        for (auto* track : tracks)
-        {
-            if (track->getTrackId() == trackId)
-            {
-                track->updateFromState();
-
-                if (property == IDs::solo || property == IDs::mute)
-                    updateSoloState();
-
-                break;
-            }
-        }
+        if (property == IDs::masterVolume)
+            masterVolume = static_cast<float>(tree[IDs::masterVolume]);
+        else if (property == IDs::masterPan)
+            masterPan = static_cast<float>(tree[IDs::masterPan]);
     }
     else if (tree.hasType(IDs::CLIP))
     {
-        // Find the track containing this clip and rebuild its clips
-        auto parentTrack = tree.getParent();
-        if (parentTrack.isValid() && parentTrack.hasType(IDs::TRACK))
+        // Edits often come in bursts (drags, undo); apply them once for all
+        if (isClipPlacement(property))
         {
-            juce::String trackId = parentTrack[IDs::trackId].toString();
-            for (auto* track : tracks)
-            {
-                if (track->getTrackId() == trackId)
-                {
-                    track->rebuildClips();
-                    break;
-                }
-            }
+            if (!editedClips.contains(tree))
+                editedClips.add(tree);
+
+            triggerAsyncUpdate();
+        }
+        else if (!isDisplayOnly(property))
+        {
+            scheduleCompile();
         }
     }
-    else if (tree.hasType(IDs::MASTER))
+    else if (tree.hasType(IDs::TRACK) && !isDisplayOnly(property))
     {
-        if (property == IDs::masterVolume)
-            masterVolume = static_cast<float>(tree[IDs::masterVolume]);
-        else if (property == IDs::masterPan)
-            masterPan = static_cast<float>(tree[IDs::masterPan]);
+        scheduleCompile();
     }
 }
 
+bool MultiTrackAudioSource::isClipPlacement(const juce::Identifier& property)
+{
+    return property == IDs::timelineStart || property == IDs::length || property == IDs::sourceStart
+        || property == IDs::gain || property == IDs::fadeInSamples || property == IDs::fadeOutSamples
+        || property == IDs::fadeInCurve || property == IDs::fadeOutCurve;
+}
+
+bool MultiTrackAudioSource::isDisplayOnly(const juce::Identifier& property)
+{
+    return property == IDs::name || property == IDs::color || property == IDs::order
+        || property == IDs::clipName || property == IDs::clipColor || property == IDs::locked;
+}
+
 void MultiTrackAudioSource::valueTreeChildAdded(juce::ValueTree& parent,
                                                  juce::ValueTree& child)
 {
-    juce::ScopedLock sl(lock);
+    juce::ignoreUnused(parent);
 
-    if (child.hasType(IDs::TRACK))
-    {
-        auto* track = new TrackAudioSource(audioCache, child);
-        track->prepareToPlay(samplesPerBlock, currentSampleRate);
-        tracks.add(track);
-        updateSoloState();
-    }
-    else if (child.hasType(IDs::CLIP))
-    {
-        // Find the track and rebuild its clips
-        juce::String trackId = parent[IDs::trackId].toString();
-        for (auto* track : tracks)
-        {
-            if (track->getTrackId() == trackId)
-            {
-                track->rebuildClips();
-                break;
-            }
-        }
-    }
+    if (child.hasType(IDs::TRACK) || child.hasType(IDs::CLIP))
+        scheduleCompile();
 }
 
 void MultiTrackAudioSource::valueTreeChildRemoved(juce::ValueTree& parent,
                                                    juce::ValueTree& child,
                                                    int index)
 {
-    juce::ignoreUnused(index);
-    juce::ScopedLock sl(lock);
+    juce::ignoreUnused(parent, index);
 
-    if (child.hasType(IDs::TRACK))
-    {
-        // Find and remove the track
-        juce::String trackId = child[IDs::trackId].toString();
-        for (int i = 0; i < tracks.size(); ++i)
-        {
-            if (tracks[i]->getTrackId() == trackId)
-            {
-                tracks.remove(i);
-                break;
-            }
-        }
-        updateSoloState();
-    }
-    else if (child.hasType(IDs::CLIP))
-    {
-        // Find the track and rebuild its clips
-        juce::String trackId = parent[IDs::trackId].toString();
-        for (auto* track : tracks)
-        {
-            if (track->getTrackId() == trackId)
-            {
-                track->rebuildClips();
-                break;
-            }
-        }
-    }
+    if (child.hasType(IDs::TRACK) || child.hasType(IDs::CLIP))
+        scheduleCompile();
 }
 
 void MultiTrackAudioSource::valueTreeChildOrderChanged(juce::ValueTree& parent,
@@ -14,6 +14,17 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 #include "ProjectModel.h"
+#include "DiskStreamer.h"
+#include "RenderPlan.h"
+#include "TrackRenderPool.h"
+#include "TrackMeterBank.h"
+#include "EffectChain.h"
+#include "../DSP/SincResampler.h"
+#include "../DSP/CompensationDelay.h"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
 
 //==============================================================================
 // Forward declarations
@@ -29,12 +40,25 @@ class AudioFileCache
 {
 public:
     AudioFileCache(juce::AudioFormatManager& formatManager);
-    ~AudioFileCache() = default;
+    ~AudioFileCache();
 
     // Get or load an audio reader source for a file
     // Returns nullptr if file cannot be loaded
     juce::AudioFormatReaderSource* getReaderSource(const juce::String& filePath);
 
+    // A reader of the file for one clip's use. Memory-mapped files (WAV /
+    // AIFF) have a single reader shared by every clip: mapped reads keep no
+    // read position, so clips on the same file never seek each other.
+    // Streamed formats get a reader of their own from a per-file pool, which
+    // it goes back to when the lease is released. nullptr if the file cannot
+    // be loaded. May be called from any thread but the audio thread.
+    using ReaderLease = std::shared_ptr<juce::AudioFormatReader>;
+
+    ReaderLease acquireReader(const juce::String& filePath);
+
+    // Released streaming readers kept per file for the next clip
+    static constexpr int maxIdleReadersPerFile = 4;
+
     // Get the sample rate of a cached file
     double getSampleRate(const juce::String& filePath) const;
 
@@ -50,11 +74,73 @@ class AudioFileCache
     // Remove a specific file from cache
     void removeFromCache(const juce::String& filePath);
 
+    //==========================================================================
+    // Sample-rate conversion for clips whose file rate differs from the device
+
+    void setResamplingQuality(SincResampler::Quality quality) { resamplingQuality = quality; }
+    SincResampler::Quality getResamplingQuality() const { return resamplingQuality; }
+
+    // Keep one fully converted copy of such files in memory, shared by every
+    // clip on the file, instead of a resampler per playing clip. Pays off
+    // when clips are reused (loops, copies). Off by default.
+    void setConvertedAudioCacheEnabled(bool shouldCache);
+    bool isConvertedAudioCacheEnabled() const { return convertedAudioCacheEnabled; }
+
+    struct ConvertedAudio
+    {
+        juce::AudioBuffer<float> buffer;  // Stereo, at the target rate
+        std::atomic<bool> ready { false };
+
+        bool isReady() const noexcept { return ready.load(std::memory_order_acquire); }
+    };
+
+    // The file converted to targetSampleRate with the current quality. The
+    // conversion runs on a background thread; don't read the buffer until
+    // isReady(). nullptr if caching is off or the file is too long.
+    std::shared_ptr<const ConvertedAudio> getConvertedAudio(const juce::String& filePath, double targetSampleRate);
+
+    // Longest file converted in full
+    static constexpr double maxConvertedSeconds = 300.0;
+
+    //==========================================================================
+    // Decoded-audio RAM cache: whole files kept as float PCM, so heavily
+    // reused short files (loops, one-shots) are decoded once and clips read
+    // them straight from memory instead of through a disk stream
+
+    // Memory budget in bytes; 0 (the default) turns the cache off. Least
+    // recently requested files are dropped first when it's exceeded.
+    void setDecodedAudioBudget(juce::int64 bytes);
+    juce::int64 getDecodedAudioBudget() const;
+
+    // Pinned files are decoded whenever asked for and never dropped
+    void setPinned(const juce::String& filePath, bool shouldPin);
+    bool isPinned(const juce::String& filePath) const;
+
+    struct DecodedAudio
+    {
+        juce::AudioBuffer<float> buffer;  // The file's first one or two channels, at its own rate
+        std::atomic<bool> ready { false };
+
+        bool isReady() const noexcept { return ready.load(std::memory_order_acquire); }
+    };
+
+    // The decoded file, if the cache is on and it fits the budget (or is
+    // pinned). Decoding runs on a background thread; don't read the buffer
+    // until isReady(). Clips holding one keep it after it leaves the cache.
+    std::shared_ptr<const DecodedAudio> getDecodedAudio(const juce::String& filePath);
+
+    // Bytes held by the cache
+    juce::int64 getDecodedAudioSize() const;
+
 private:
+    struct ReaderPool;
+
     struct CachedFile
     {
-        std::unique_ptr<juce::AudioFormatReader> reader;
+        std::shared_ptr<juce::AudioFormatReader> reader;  // Shared with clips if mapped
         std::unique_ptr<juce::AudioFormatReaderSource> source;
+        std::shared_ptr<ReaderPool> readerPool;           // Streamed formats only
+        bool mapped { false };
         double sampleRate { 0.0 };
         juce::int64 lengthInSamples { 0 };
         int numChannels { 0 };
@@ -64,151 +150,215 @@ class AudioFileCache
     std::map<juce::String, CachedFile> cache;
     juce::CriticalSection cacheLock;
 
+    SincResampler::Quality resamplingQuality { SincResampler::Quality::high };
+    bool convertedAudioCacheEnabled { false };
+    std::map<juce::String, std::shared_ptr<ConvertedAudio>> convertedCache;
+
+    struct DecodedEntry
+    {
+        std::shared_ptr<DecodedAudio> audio;
+        juce::int64 bytes { 0 };
+        juce::uint64 lastUsed { 0 };
+    };
+
+    juce::int64 decodedAudioBudget { 0 };
+    juce::int64 decodedAudioSize { 0 };
+    juce::uint64 decodedUseCounter { 0 };
+    std::map<juce::String, DecodedEntry> decodedCache;
+    juce::StringArray pinnedFiles;
+
+    // Drops least recently used unpinned files until bytesToAdd more fit.
+    // Returns false if they can't (call with cacheLock held).
+    bool trimDecodedCache(juce::int64 bytesToAdd = 0);
+
+    // Declared last so running conversions stop before the rest is destroyed
+    class ConversionJob;
+    class DecodeJob;
+    juce::ThreadPool conversionPool { 1 };
+
+    // Loads the file into the cache if needed (call with cacheLock held)
+    CachedFile* findOrLoad(const juce::String& filePath);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioFileCache)
 };
 
 //==============================================================================
-// Clip Audio Source - Handles playback of a single clip
+// Clip Audio Source - Reads the audio of a single clip
 //==============================================================================
 
-class ClipAudioSource : public juce::PositionableAudioSource
+// Survives plan recompiles while the clip keeps its file, so its read-ahead
+// ring and resampler state carry on. Placement, gain and fades come from
+// the RenderPlan::Clip passed in.
+class ClipAudioSource
 {
 public:
-    ClipAudioSource(AudioFileCache& cache, const juce::ValueTree& clipState);
-    ~ClipAudioSource() override = default;
+    ClipAudioSource(AudioFileCache& cache, DiskStreamer& streamer, const juce::String& audioFilePath);
+    ~ClipAudioSource() = default;
 
-    //==========================================================================
-    // PositionableAudioSource interface
-    //==========================================================================
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-    void releaseResources() override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    // Not on the audio thread
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
 
-    void setNextReadPosition(juce::int64 newPosition) override;
-    juce::int64 getNextReadPosition() const override;
-    juce::int64 getTotalLength() const override;
-    bool isLooping() const override { return false; }
-
-    //==========================================================================
-    // Clip-specific methods
-    //==========================================================================
+    const juce::String& getAudioFilePath() const { return audioFilePath; }
+    bool isLoaded() const { return stream != nullptr; }
 
-    // Check if this clip plays at the given timeline position
-    bool isActiveAt(juce::int64 timelinePosition) const;
+    // Offline: read the file synchronously instead of through the stream,
+    // so rendering faster than real time never underruns
+    void setOfflineRendering(bool shouldReadDirectly);
 
-    // Get the clip's timeline start position
-    juce::int64 getTimelineStart() const;
-
-    // Get the clip's timeline end position
-    juce::int64 getTimelineEnd() const;
+    //==========================================================================
+    // Audio thread
 
-    // Get the clip's gain
-    float getGain() const;
+    // Keep the read-ahead ring filled from shortly before the clip starts
+    // until it ends, and let it go otherwise. Picks up the loop-start ring
+    // if it was primed for timelinePosition.
+    void cue(const RenderPlan::Clip& clip, juce::int64 timelinePosition);
 
-    // Update from ValueTree state
-    void updateFromState();
+    // Nearing the loop end: fill a second ring from where the clip plays at
+    // loopStart, so the wrap switches rings instead of re-priming. Parked
+    // again by parkLoopStart().
+    void cueLoopStart(const RenderPlan::Clip& clip, juce::int64 loopStart);
+    void parkLoopStart();
 
-    // Get clip ID
-    juce::String getClipId() const;
+    // Source audio for timeline samples [timelinePosition, + numSamples),
+    // without gain or fades
+    void read(const RenderPlan::Clip& clip, juce::AudioBuffer<float>& buffer,
+              int startSample, int numSamples, juce::int64 timelinePosition);
 
 private:
     AudioFileCache& audioCache;
-    juce::ValueTree state;
+    DiskStreamer& diskStreamer;
+    const juce::String audioFilePath;
 
-    // Cached properties from state
-    juce::String audioFilePath;
-    juce::int64 sourceStart { 0 };
-    juce::int64 length { 0 };
-    juce::int64 timelineStart { 0 };
-    float gain { 1.0f };
-    juce::int64 fadeInSamples { 0 };
-    juce::int64 fadeOutSamples { 0 };
+    // Offline only: the reader read directly. Otherwise the stream holds a
+    // reader only while the clip is cued.
+    AudioFileCache::ReaderLease offlineReader;
+
+    // Read-ahead ring for the clip's file; nullptr if the file can't be
+    // loaded. The second one is primed at the loop start ahead of a wrap.
+    std::unique_ptr<DiskStreamer::Stream> stream;
+    std::unique_ptr<DiskStreamer::Stream> loopStartStream;
 
     // Playback state
-    juce::int64 currentPosition { 0 };
     double currentSampleRate { 44100.0 };
     int samplesPerBlock { 512 };
+    bool offline { false };
 
     // Temporary buffer for resampling if needed
     juce::AudioBuffer<float> tempBuffer;
 
-    // Calculate fade gain at a position within the clip
-    float calculateFadeGain(juce::int64 positionInClip) const;
+    // Sample-rate conversion from the file rate to the device rate
+    SincResampler resampler;
+    double resampleRatio { 1.0 };             // File rate / device rate
+    juce::int64 resampledSourceStart { -1 };  // Clip mapping the resampler continues from
+    juce::int64 resampledPosition { -1 };     // Position in clip it continues from
+    juce::int64 sourceReadPosition { 0 };     // Next file sample the resampler takes
+    std::shared_ptr<const AudioFileCache::ConvertedAudio> converted;
+    std::shared_ptr<const AudioFileCache::DecodedAudio> decoded;
+
+    bool needsResampling() const { return resampleRatio != 1.0; }
+    bool usesConvertedAudio() const { return converted != nullptr && converted->isReady(); }
+    bool usesDecodedAudio() const { return decoded != nullptr && decoded->isReady(); }
+
+    // File position the stream has to deliver from for timelinePosition
+    // (before the clip: its start), or -1 if it needn't stream there
+    juce::int64 getStreamPosition(const RenderPlan::Clip& clip, juce::int64 timelinePosition) const;
+
+    // File samples from the decoded copy if it's ready, otherwise the
+    // stream (or the reader itself, offline)
+    void readSource(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                    juce::int64 sourcePosition);
+
+    // Fill numSamples of the buffer from the resampler or the converted copy
+    void readConverted(const RenderPlan::Clip& clip, juce::AudioBuffer<float>& buffer,
+                       int startSample, int numSamples, juce::int64 positionInClip);
+    void readResampled(const RenderPlan::Clip& clip, juce::AudioBuffer<float>& buffer,
+                       int startSample, int numSamples, juce::int64 positionInClip);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipAudioSource)
 };
 
 //==============================================================================
-// Track Audio Source - Handles playback of a single track with multiple clips
+// Track Audio Source - Renders the clips of a single track
 //==============================================================================
 
-class TrackAudioSource : public juce::PositionableAudioSource
+// Survives plan recompiles; owns the track's render buffers and insert
+// chain. Volume, pan, mute / solo, the clip list and the latency
+// compensation delay come from the RenderPlan::Track passed in.
+class TrackAudioSource
 {
 public:
-    TrackAudioSource(AudioFileCache& cache, const juce::ValueTree& trackState);
-    ~TrackAudioSource() override = default;
+    explicit TrackAudioSource(const juce::String& trackId);
+    ~TrackAudioSource() = default;
 
-    //==========================================================================
-    // PositionableAudioSource interface
-    //==========================================================================
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-    void releaseResources() override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    // Not on the audio thread
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
 
-    void setNextReadPosition(juce::int64 newPosition) override;
-    juce::int64 getNextReadPosition() const override;
-    juce::int64 getTotalLength() const override;
-    bool isLooping() const override { return false; }
+    const juce::String& getTrackId() const { return trackId; }
 
-    //==========================================================================
-    // Track-specific methods
-    //==========================================================================
+    // Insert effects, run pre-fader (message thread edits them): the
+    // track's own, or the ones borrowed
+    EffectChain& getInserts() { return borrowedInserts != nullptr ? *borrowedInserts : inserts; }
 
-    // Get track properties
-    float getVolume() const;
-    float getPan() const;
-    bool isMuted() const;
-    bool isSoloed() const;
+    // Offline copies: run another engine's chain (held from it) instead of
+    // the track's own. Message thread, before the track is rendered.
+    void setBorrowedInserts(std::shared_ptr<EffectChain> chain) { borrowedInserts = std::move(chain); }
 
-    // Set whether solo is active anywhere (affects mute behavior)
-    void setSoloActiveInProject(bool soloActive);
+    // While held, the track renders without its inserts, so another thread
+    // can run them (a freeze). The audio thread may still be in them when
+    // this returns; see MultiTrackAudioSource::holdTrackInserts().
+    // Sequentially consistent, as the hold is paired with blockEpoch.
+    void setInsertsHeld(bool shouldHold) { insertsHeld.store(shouldHold); }
+    bool areInsertsHeld() const { return insertsHeld.load(); }
 
-    // Update from ValueTree state
-    void updateFromState();
+    // The track's compensation delay line, for a plan (message thread).
+    // One too short for delaySamples is replaced by a longer line, allocated
+    // here; the audio thread moves to it with the plan, never while a
+    // block uses the old one.
+    std::shared_ptr<CompensationDelay> getCompensationDelay(int delaySamples);
 
-    // Get track ID
-    juce::String getTrackId() const;
+    //==========================================================================
+    // Audio thread
 
-    // Rebuild clip sources from state
-    void rebuildClips();
+    // Renders [timelinePosition, + numSamples) into getOutput() (stereo,
+    // from sample 0) through the inserts, delayed to line up with the
+    // latest track, with volume and pan applied. Each clip overlapping the
+    // block is read for exactly the samples it covers; clips starting soon
+    // after it are primed. An inaudible track renders silence (skipping
+    // its inserts) but keeps its clip streams moving.
+    void render(const RenderPlan& plan, const RenderPlan::Track& track,
+                juce::int64 timelinePosition, int numSamples);
 
-private:
-    AudioFileCache& audioCache;
-    juce::ValueTree state;
+    // Re-aims every clip of the track at a new position (seeks, loop wraps
+    // and plan changes; visits all the track's clips)
+    void cue(const RenderPlan& plan, const RenderPlan::Track& track, juce::int64 timelinePosition);
 
-    // Clip sources
-    juce::OwnedArray<ClipAudioSource> clips;
+    // Primes the clips playing just after loopStart for the next wrap
+    void cueLoopStart(const RenderPlan& plan, const RenderPlan::Track& track, juce::int64 loopStart);
 
-    // Track properties
-    float volume { 1.0f };
-    float pan { 0.0f };
-    bool muted { false };
-    bool soloed { false };
-    bool soloActiveInProject { false };
+    const juce::AudioBuffer<float>& getOutput() const { return output; }
 
-    // Playback state
-    juce::int64 currentPosition { 0 };
-    double currentSampleRate { 44100.0 };
-    int samplesPerBlock { 512 };
+private:
+    const juce::String trackId;
 
-    // Temporary buffer for mixing clips
-    juce::AudioBuffer<float> mixBuffer;
+    // Track mix, and one clip at a time before fades and gain
+    juce::AudioBuffer<float> output;
+    juce::AudioBuffer<float> clipBuffer;
 
-    // Apply pan to a stereo buffer
-    void applyPan(juce::AudioBuffer<float>& buffer, float panValue);
+    // Per-sample clip gain where a fade is running
+    juce::HeapBlock<float> gains;
 
-    // Check if this track should play (considering mute/solo)
-    bool shouldPlay() const;
+    EffectChain inserts;
+    std::shared_ptr<EffectChain> borrowedInserts;
+    juce::MidiBuffer insertMidi;
+    std::atomic<bool> insertsHeld { false };
+    std::shared_ptr<CompensationDelay> compensationDelay;  // The latest; message thread's
+    int samplesPerBlock { 512 };
+
+    // Adds clipBuffer [offset, + numSamples) to the output with the clip's
+    // gain and fades; unfaded stretches skip the per-sample gain
+    void addClip(const RenderPlan::Clip& clip, int offset, int numSamples, juce::int64 positionInClip);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAudioSource)
 };
@@ -217,8 +367,14 @@ class TrackAudioSource : public juce::PositionableAudioSource
 // Multi-Track Audio Source - Main mixer for all tracks
 //==============================================================================
 
+// The project ValueTree is compiled into a RenderPlan on the message thread
+// and published through an atomic pointer; the audio thread picks it up at
+// the next block and hands the previous plan back through a FIFO to be
+// freed on the message thread. Mixing never waits on the message thread.
 class MultiTrackAudioSource : public juce::PositionableAudioSource,
-                               public juce::ValueTree::Listener
+                               public juce::ValueTree::Listener,
+                               private juce::AsyncUpdater,
+                               private juce::Timer
 {
 public:
     MultiTrackAudioSource(juce::AudioFormatManager& formatManager);
@@ -234,8 +390,8 @@ class MultiTrackAudioSource : public juce::PositionableAudioSource,
     void setNextReadPosition(juce::int64 newPosition) override;
     juce::int64 getNextReadPosition() const override;
     juce::int64 getTotalLength() const override;
-    bool isLooping() const override { return looping; }
-    void setLooping(bool shouldLoop) { looping = shouldLoop; }
+    bool isLooping() const override { return looping.load(); }
+    void setLooping(bool shouldLoop) override { looping.store(shouldLoop); }
 
     //==========================================================================
     // Project management
@@ -247,30 +403,106 @@ class MultiTrackAudioSource : public juce::PositionableAudioSource,
     // Unload current project
     void unloadProject();
 
-    // Rebuild all track sources from current project state
+    // Compile and publish a new render plan from the current project state
     void rebuildFromProject();
 
     // Get the project sample rate
     double getProjectSampleRate() const;
 
+    // Clip reads that found no data buffered (disk too slow), since construction
+    juce::int64 getNumStreamUnderruns() const { return diskStreamer.getNumUnderruns(); }
+
+    // Conversion of clips recorded at another rate (see AudioFileCache)
+    void setResamplingQuality(SincResampler::Quality quality);
+    SincResampler::Quality getResamplingQuality() const { return audioCache.getResamplingQuality(); }
+
+    void setConvertedAudioCacheEnabled(bool shouldCache);
+    bool isConvertedAudioCacheEnabled() const { return audioCache.isConvertedAudioCacheEnabled(); }
+
+    // Offline rendering (bounces): clips read their files synchronously, so
+    // blocks can be pulled as fast as they render. Set before loading.
+    void setOfflineRendering(bool shouldRenderOffline);
+    bool isOfflineRendering() const { return offlineRendering; }
+
+    // Decoded-audio RAM cache (see AudioFileCache)
+    void setDecodedAudioBudget(juce::int64 bytes);
+    juce::int64 getDecodedAudioBudget() const { return audioCache.getDecodedAudioBudget(); }
+
+    void setFilePinned(const juce::String& filePath, bool shouldPin);
+    bool isFilePinned(const juce::String& filePath) const { return audioCache.isPinned(filePath); }
+
+    // Closes the cache's reader of a file that's about to be deleted or
+    // rewritten (clips still playing it keep their own)
+    void forgetFile(const juce::String& filePath) { audioCache.removeFromCache(filePath); }
+
     //==========================================================================
     // Transport control
     //==========================================================================
 
     // Get/set loop range (in samples)
     void setLoopRange(juce::int64 startSample, juce::int64 endSample);
-    juce::int64 getLoopStart() const { return loopStart; }
-    juce::int64 getLoopEnd() const { return loopEnd; }
+    juce::int64 getLoopStart() const { return loopStart.load(); }
+    juce::int64 getLoopEnd() const { return loopEnd.load(); }
 
     //==========================================================================
     // Master output
     //==========================================================================
 
-    float getMasterVolume() const { return masterVolume; }
-    void setMasterVolume(float volume) { masterVolume = juce::jlimit(0.0f, 2.0f, volume); }
+    float getMasterVolume() const { return masterVolume.load(); }
+    void setMasterVolume(float volume) { masterVolume.store(juce::jlimit(0.0f, 2.0f, volume)); }
+
+    float getMasterPan() const { return masterPan.load(); }
+    void setMasterPan(float pan) { masterPan.store(juce::jlimit(-1.0f, 1.0f, pan)); }
+
+    //==========================================================================
+    // Metering
+    //==========================================================================
+
+    // Post-fader levels of every track and the master; poll from the
+    // message thread (not measured while rendering offline)
+    TrackMeterBank& getMeters() { return meters; }
+
+    //==========================================================================
+    // Insert effects
+    //==========================================================================
+
+    // A track's insert chain (message thread); nullptr until the track has
+    // been compiled into a plan. Tracks with less latency than the slowest
+    // one are delayed to match it, so the mix stays sample-aligned.
+    EffectChain* getTrackInserts(const juce::String& trackId);
+
+    // Runs on the summed tracks, before master volume and pan
+    EffectChain& getMasterInserts() { return masterInserts; }
+
+    // Output delay behind the timeline: the slowest track's inserts plus
+    // the master's
+    int getLatencySamples() const { return latencySamples.load(); }
+
+    // Takes a track's inserts off the audio thread, which renders the
+    // track dry until the returned pointer is let go of; the track's source
+    // stays alive until then too. For running the chain offline (freezes,
+    // bounces). nullptr until the track has been compiled into a plan, or
+    // while its inserts are already held.
+    std::shared_ptr<EffectChain> holdTrackInserts(const juce::String& trackId);
+
+    // The same for the master inserts; nullptr while already held
+    std::shared_ptr<EffectChain> holdMasterInserts();
 
-    float getMasterPan() const { return masterPan; }
-    void setMasterPan(float pan) { masterPan = juce::jlimit(-1.0f, 1.0f, pan); }
+    // Offline copies: render tracks (by ID) and the master through chains
+    // held from the live engine instead of their own, so the render sounds
+    // like playback, with the same delay compensation. Call before
+    // loadProject(). The chains stay prepared for the live device, so
+    // render at their rate and block size.
+    void borrowInserts(std::map<juce::String, std::shared_ptr<EffectChain>> trackChains,
+                       std::shared_ptr<EffectChain> masterChain);
+
+    // Message thread, when a removed track's chain is dropped (it's freed
+    // once playback lets go of it); close its plugin editors here
+    std::function<void(EffectChain&)> onTrackInsertsReleased;
+
+    // Message thread, when a track's chain may have a new saved state (see
+    // EffectChain::onStateChanged)
+    std::function<void(const juce::String& trackId)> onTrackInsertsStateChanged;
 
     //==========================================================================
     // ValueTree::Listener
@@ -283,38 +515,138 @@ class MultiTrackAudioSource : public juce::PositionableAudioSource,
 
 private:
     juce::AudioFormatManager& formatManager;
+
+    // Declared first so it outlives every clip stream
+    DiskStreamer diskStreamer;
     AudioFileCache audioCache;
 
-    // Project state
+    // Project state (message thread)
     juce::ValueTree projectState;
 
-    // Track sources
-    juce::OwnedArray<TrackAudioSource> tracks;
+    //==========================================================================
+    // Plan compilation (message thread)
+    std::unique_ptr<RenderPlan> compilePlan();
+    void publishPlan(std::unique_ptr<RenderPlan> plan);
+    void freeRetiredPlans();
+
+    void handleAsyncUpdate() override;  // Coalesces ValueTree changes into one compile or patch
+    void timerCallback() override;      // Frees retired plans
+
+    // Changes that need a full compile (tracks, clips added or removed,
+    // files, inserts)
+    void scheduleCompile();
+    bool needsCompile { false };
+
+    // Clip edits that only move, trim, fade or change the gain of existing
+    // clips are patched into a copy of the last plan: the edited clips'
+    // fields are updated and only their tracks re-sorted. Every clip keeps
+    // its source, and playback re-aims only the edited ones.
+    std::unique_ptr<RenderPlan> patchPlan();  // nullptr if it can't be patched
+
+    static void readClipPlacement(const juce::ValueTree& clipState, RenderPlan::Clip& clip);
+    static bool isClipPlacement(const juce::Identifier& property);
+    static bool isDisplayOnly(const juce::Identifier& property);  // Names, colours: no recompile
+
+    juce::Array<juce::ValueTree> editedClips;
+
+    // Last published plan, with its clips' IDs (plan order)
+    std::unique_ptr<RenderPlan> lastPlan;
+    std::vector<juce::String> lastPlanClipIds;
+    std::map<juce::String, int> lastPlanClipIndices;
+    bool clipIdsUnique { true };
+
+    // Since the audio thread last picked up a plan: whether a full compile
+    // is among the ones it skipped, and the clips patched
+    bool unadoptedFullCompile { false };
+    juce::StringArray unadoptedPatchIds;
+
+    bool offlineRendering { false };
+
+    // Sources by track / clip ID, reused across compiles
+    std::map<juce::String, std::shared_ptr<TrackAudioSource>> trackSources;
+    std::map<juce::String, std::shared_ptr<ClipAudioSource>> clipSources;
+
+    //==========================================================================
+    // Plan hand-over
+    std::atomic<RenderPlan*> pendingPlan { nullptr };  // Published, not yet picked up
+    RenderPlan* activePlan { nullptr };                // Audio thread's
 
+    static constexpr int maxRetiredPlans = 32;
+    juce::AbstractFifo retiredFifo { maxRetiredPlans };
+    std::array<RenderPlan*, maxRetiredPlans> retiredPlans {};
+
+    // Audio thread: swap in a pending plan if there's room to retire the old
+    // one. Returns true if the plan changed.
+    bool adoptPendingPlan();
+
+    //==========================================================================
     // Playback state
-    juce::int64 currentPosition { 0 };
+    std::atomic<juce::int64> currentPosition { 0 };
+    std::atomic<juce::int64> pendingSeek { -1 };    // -1: none
+    std::atomic<juce::int64> totalLength { 0 };
     double currentSampleRate { 44100.0 };
     double projectSampleRate { 44100.0 };
     int samplesPerBlock { 512 };
-    bool looping { false };
-    juce::int64 loopStart { 0 };
-    juce::int64 loopEnd { 0 };
+    std::atomic<bool> looping { false };
+    std::atomic<juce::int64> loopStart { 0 };
+    std::atomic<juce::int64> loopEnd { 0 };
 
     // Master output
-    float masterVolume { 1.0f };
-    float masterPan { 0.0f };
+    std::atomic<float> masterVolume { 1.0f };
+    std::atomic<float> masterPan { 0.0f };
+
+    TrackMeterBank meters;
+
+    EffectChain masterInserts;
+    std::atomic<bool> masterInsertsHeld { false };
+    juce::MidiBuffer masterMidi;
+    std::atomic<int> latencySamples { 0 };
+
+    // Chains run instead of the tracks' and the master's own (offline copies)
+    std::map<juce::String, std::shared_ptr<EffectChain>> borrowedTrackInserts;
+    std::shared_ptr<EffectChain> borrowedMasterInserts;
+
+    EffectChain& getActiveMasterInserts() { return borrowedMasterInserts != nullptr ? *borrowedMasterInserts : masterInserts; }
 
-    // Temporary buffer for mixing
-    juce::AudioBuffer<float> mixBuffer;
+    // Picks up plugin latency changes (timer)
+    void checkInsertLatencies();
 
-    // Thread safety
-    juce::CriticalSection lock;
+    // compileLock keeps compiles and prepareToPlay apart. renderLock keeps
+    // prepareToPlay away from the audio thread, which only ever try-locks
+    // it (and outputs silence while a prepare is in progress); nothing else
+    // takes it while the device runs.
+    juce::CriticalSection compileLock;
+    juce::CriticalSection renderLock;
+
+    // Odd while the audio thread is in getNextAudioBlock()
+    std::atomic<juce::uint32> blockEpoch { 0 };
+
+    // Message thread: returns once a block in progress (which may have
+    // seen state from before the call) has finished. Spins; a block is short.
+    void waitForBlockInProgress() const;
+
+    // Render a block of the active plan from a timeline position (audio thread)
+    void renderPlan(const juce::AudioSourceChannelInfo& bufferToFill, juce::int64 position);
+
+    // Tracks render in parallel into their own buffers and are then summed
+    // in plan order, so the mix doesn't depend on which thread did what.
+    // Small sessions render serially; waking workers would cost more.
+    struct TrackRenderJob : public TrackRenderPool::Job
+    {
+        const RenderPlan* plan { nullptr };
+        TrackMeterBank* meters { nullptr };  // nullptr: offline
+        juce::int64 position { 0 };
+        int numSamples { 0 };
+
+        void perform(int taskIndex) noexcept override;
+    };
 
-    // Update solo state across all tracks
-    void updateSoloState();
+    static constexpr int minTracksForParallelRender = 4;
+    TrackRenderJob trackRenderJob;
+    TrackRenderPool renderPool;
 
     // Apply master pan
-    void applyMasterPan(juce::AudioBuffer<float>& buffer);
+    void applyMasterPan(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float pan);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiTrackAudioSource)
 };
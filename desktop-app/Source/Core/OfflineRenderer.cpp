@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+
+    Offline render to file implementation
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+#include "../DSP/SincResampler.h"
+#include <cmath>
+
+namespace
+{
+    constexpr int writerFifoSize = 1 << 18;  // Samples per channel
+    constexpr int writerWaitMs = 5;
+    constexpr int numOutputChannels = 2;
+
+    juce::String getDeviceChangedMessage(const juce::String& jobName)
+    {
+        return "The audio device changed during the " + jobName.toLowerCase();
+    }
+}
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer()
+    : juce::Thread("Offline Render")
+{
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+    cancelPendingUpdate();
+    stopThread(10000);
+
+    writer.reset();
+    writerThread.stopThread(2000);
+
+    // Still set: the render never finished
+    if (job.source != nullptr)
+        job.outputFile.deleteFile();
+
+    job = {};
+}
+
+//==============================================================================
+juce::String OfflineRenderer::start(Job newJob)
+{
+    jassert(!isThreadRunning() && newJob.source != nullptr && newJob.format != nullptr);
+
+    if (isThreadRunning())
+        return "A render is already running";
+
+    newJob.outputFile.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream(newJob.outputFile.createOutputStream());
+
+    if (stream == nullptr)
+        return "Can't write to " + newJob.outputFile.getFullPathName();
+
+    std::unique_ptr<juce::AudioFormatWriter> fileWriter(newJob.format->createWriterFor(stream.get(), newJob.outputSampleRate,
+                                                                                       numOutputChannels, newJob.bitDepth,
+                                                                                       {}, 0));
+    if (fileWriter == nullptr)
+    {
+        stream.reset();
+        newJob.outputFile.deleteFile();
+        return "Can't create a " + newJob.format->getFormatName() + " writer";
+    }
+
+    stream.release();  // Owned by the writer now
+
+    if (!writerThread.isThreadRunning())
+        writerThread.startThread();
+
+    writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(fileWriter.release(), writerThread, writerFifoSize);
+
+    job = std::move(newJob);
+    progress = 0.0;
+
+    chainGenerations.clear();
+    for (auto& chain : job.chains)
+        chainGenerations.push_back(chain->getPrepareGeneration());
+
+    startThread();
+    return {};
+}
+
+void OfflineRenderer::cancel()
+{
+    signalThreadShouldExit();
+}
+
+//==============================================================================
+void OfflineRenderer::run()
+{
+    for (auto& chain : job.chains)
+    {
+        chain->setNonRealtime(true);
+        chain->reset();
+    }
+
+    resultMessage = render();
+    succeeded = resultMessage.isEmpty();
+
+    // Playback picks up the live chains from a cleared state
+    for (auto& chain : job.chains)
+    {
+        chain->reset();
+        chain->setNonRealtime(false);
+    }
+
+    // Writes out what's still queued and closes the file
+    writer.reset();
+
+    if (!succeeded)
+        job.outputFile.deleteFile();
+
+    triggerAsyncUpdate();
+}
+
+juce::String OfflineRenderer::render()
+{
+    auto& source = *job.source;
+    const auto cancelled = job.name + " cancelled";
+    const auto deviceChanged = getDeviceChangedMessage(job.name);
+
+    // The source renders at renderSampleRate and the output is converted
+    const bool resampling = std::abs(job.outputSampleRate - job.renderSampleRate) > 1.0e-6;
+    SincResampler resampler;
+    int mixSize = blockSize;
+
+    if (resampling)
+    {
+        resampler.prepare(numOutputChannels, job.renderSampleRate / job.outputSampleRate,
+                          SincResampler::Quality::best, blockSize);
+        mixSize = resampler.getMaxInputSamplesPerCall();
+    }
+
+    // The source splits bigger reads into blocks of renderBlockSize
+    source.prepareToPlay(job.renderBlockSize, job.renderSampleRate);
+    source.setNextReadPosition(job.startSample - (resampling ? resampler.getInputLatency() : 0));
+
+    juce::AudioBuffer<float> mix(numOutputChannels, mixSize);
+    juce::AudioBuffer<float> output(numOutputChannels, blockSize);
+
+    // The inserts' output runs their latency behind the timeline; render
+    // that much first and drop it, so the file starts at startSample
+    for (juce::int64 skipped = 0, latency = source.getLatencySamples(); skipped < latency;)
+    {
+        if (threadShouldExit())
+            return cancelled;
+
+        const int numThisTime = (int)juce::jmin((juce::int64)mixSize, latency - skipped);
+        source.getNextAudioBlock(juce::AudioSourceChannelInfo(&mix, 0, numThisTime));
+        skipped += numThisTime;
+
+        if (chainsChanged())
+            return deviceChanged;
+    }
+
+    const auto rangeLength = job.endSample - job.startSample;
+    const auto totalSamples = resampling
+        ? (juce::int64)std::llround((double)rangeLength * job.outputSampleRate / job.renderSampleRate)
+        : rangeLength;
+
+    for (juce::int64 done = 0; done < totalSamples;)
+    {
+        if (threadShouldExit())
+            return cancelled;
+
+        const int numThisTime = (int)juce::jmin((juce::int64)blockSize, totalSamples - done);
+
+        if (resampling)
+        {
+            const int numInput = resampler.getNumInputSamplesNeeded(numThisTime);
+
+            if (numInput > 0)
+                source.getNextAudioBlock(juce::AudioSourceChannelInfo(&mix, 0, numInput));
+
+            resampler.process(mix.getArrayOfReadPointers(), output.getArrayOfWritePointers(), numThisTime);
+        }
+        else
+        {
+            source.getNextAudioBlock(juce::AudioSourceChannelInfo(&output, 0, numThisTime));
+        }
+
+        // Checked before the block is written: it may have gone through a
+        // chain unprocessed, or at the wrong block size
+        if (chainsChanged())
+            return deviceChanged;
+
+        // Writer FIFO full: let the disk catch up
+        while (!writer->write(output.getArrayOfReadPointers(), numThisTime))
+        {
+            if (threadShouldExit())
+                return cancelled;
+
+            wait(writerWaitMs);
+        }
+
+        done += numThisTime;
+        progress = (double)done / (double)totalSamples;
+    }
+
+    source.releaseResources();
+    return {};
+}
+
+void OfflineRenderer::handleAsyncUpdate()
+{
+    // The thread has finished; the source has to go on the message thread
+    stopThread(1000);
+    job.source.reset();
+
+    // Re-prepared after the last block was checked
+    if (succeeded && chainsChanged())
+    {
+        succeeded = false;
+        resultMessage = getDeviceChangedMessage(job.name);
+        job.outputFile.deleteFile();
+    }
+
+    job = {};
+    chainGenerations.clear();
+
+    if (onFinished != nullptr)
+        onFinished(succeeded, resultMessage);
+}
+
+bool OfflineRenderer::chainsChanged() const
+{
+    for (size_t i = 0; i < job.chains.size(); ++i)
+        if (job.chains[i]->getPrepareGeneration() != chainGenerations[i])
+            return true;
+
+    return false;
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+
+    Renders a private, offline MultiTrackAudioSource into an audio file on a
+    background thread, for bounces and track freezes. Blocks go through a
+    threaded writer so file I/O overlaps rendering, and the output is
+    converted with SincResampler when the file's rate differs from the one
+    the source renders at. The source's latency is rendered first and
+    dropped, so the file starts at the start of the range.
+
+    Live insert chains the source borrows are handed over with the job;
+    they're switched to offline processing for the render, and released
+    when it ends. The device can still re-prepare or release them
+    meanwhile; the render fails as soon as one has been (see
+    EffectChain::getPrepareGeneration), as its blocks are no longer what
+    the chains were prepared for.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "MultiTrackAudioSource.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class OfflineRenderer : private juce::Thread,
+                        private juce::AsyncUpdater
+{
+public:
+    //==========================================================================
+    struct Job
+    {
+        juce::String name;                                  // "Bounce", "Freeze": for messages
+        std::unique_ptr<MultiTrackAudioSource> source;      // Offline, with its project loaded
+        std::vector<std::shared_ptr<EffectChain>> chains;   // Held live chains the source borrows
+        double renderSampleRate { 44100.0 };
+        int renderBlockSize { 512 };
+        juce::int64 startSample { 0 };                      // Timeline range
+        juce::int64 endSample { 0 };
+
+        juce::File outputFile;
+        juce::AudioFormat* format { nullptr };              // Must outlive the render
+        double outputSampleRate { 44100.0 };
+        int bitDepth { 24 };
+    };
+
+    OfflineRenderer();
+
+    // Stops a render in progress and deletes its file
+    ~OfflineRenderer() override;
+
+    //==========================================================================
+    // Message thread. Opens the file and starts rendering; returns an error
+    // message, or an empty string if the render has started. On an error
+    // the job's source and chains are let go of.
+    juce::String start(Job job);
+
+    // The file is deleted; onFinished is still called
+    void cancel();
+
+    bool isRunning() const { return isThreadRunning(); }
+
+    // 0 to 1
+    double getProgress() const { return progress.load(); }
+
+    // Message thread, when a render ends. The source and chains have been
+    // let go of; on failure or cancellation the message says why and the
+    // output file has been removed.
+    std::function<void(bool success, const juce::String& message)> onFinished;
+
+    // Written per block
+    static constexpr int blockSize = 8192;
+
+private:
+    //==========================================================================
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    // Renders the whole range into the writer; returns an error message
+    juce::String render();
+
+    // Whether the device has re-prepared or released a chain since start()
+    bool chainsChanged() const;
+
+    juce::TimeSliceThread writerThread { "Offline Render Writer" };
+
+    // Set up by start(), used by the render thread
+    Job job;
+    std::vector<juce::uint32> chainGenerations;  // At start()
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> writer;
+
+    std::atomic<double> progress { 0.0 };
+    juce::String resultMessage;
+    bool succeeded { false };
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    PluginLoadMeter.cpp
+
+    Per-plugin DSP load statistics implementation
+
+  ==============================================================================
+*/
+
+#include "PluginLoadMeter.h"
+
+//==============================================================================
+void PluginLoadMeter::addBlock(juce::int64 ticks, int numSamples, double sampleRate) noexcept
+{
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    if (resetPending.exchange(false))
+        clear();
+
+    const double blockSeconds = numSamples / sampleRate;
+    const auto percent = static_cast<float>(juce::Time::highResolutionTicksToSeconds(ticks) / blockSeconds * 100.0);
+
+    // The only writer: plain loads and stores are enough
+    const auto count = numBlocks.load(std::memory_order_relaxed);
+
+    if (count == 0 || percent < minPercent.load(std::memory_order_relaxed))
+        minPercent.store(percent, std::memory_order_relaxed);
+
+    if (percent > maxPercent.load(std::memory_order_relaxed))
+        maxPercent.store(percent, std::memory_order_relaxed);
+
+    sumPercent.store(sumPercent.load(std::memory_order_relaxed) + percent, std::memory_order_relaxed);
+
+    if (percent > spikeThreshold.load(std::memory_order_relaxed))
+        numSpikes.store(numSpikes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    const int bin = juce::jlimit(0, numBins - 1, static_cast<int>(percent / histogramResolution));
+    histogram[static_cast<size_t>(bin)].fetch_add(1, std::memory_order_relaxed);
+
+    // Last, so a reader that sees the count sees the block
+    numBlocks.store(count + 1, std::memory_order_release);
+}
+
+void PluginLoadMeter::clear() noexcept
+{
+    numBlocks.store(0, std::memory_order_relaxed);
+    minPercent.store(0.0f, std::memory_order_relaxed);
+    maxPercent.store(0.0f, std::memory_order_relaxed);
+    sumPercent.store(0.0, std::memory_order_relaxed);
+    numSpikes.store(0, std::memory_order_relaxed);
+
+    for (auto& bin : histogram)
+        bin.store(0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+PluginLoadMeter::Stats PluginLoadMeter::getStats() const noexcept
+{
+    Stats stats;
+
+    if (resetPending.load())
+        return stats;
+
+    stats.numBlocks = numBlocks.load(std::memory_order_acquire);
+    if (stats.numBlocks == 0)
+        return stats;
+
+    stats.minPercent = minPercent.load(std::memory_order_relaxed);
+    stats.maxPercent = maxPercent.load(std::memory_order_relaxed);
+    stats.meanPercent = static_cast<float>(sumPercent.load(std::memory_order_relaxed) / static_cast<double>(stats.numBlocks));
+    stats.numSpikes = numSpikes.load(std::memory_order_relaxed);
+
+    // The upper edge of the bin holding the 99th percentile block (the
+    // histogram may be a block or two ahead of the count; close enough)
+    const auto target = stats.numBlocks - stats.numBlocks / 100;
+    juce::int64 seen = 0;
+
+    for (int i = 0; i < numBins; ++i)
+    {
+        seen += histogram[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+
+        if (seen >= target)
+        {
+            stats.p99Percent = juce::jmin(stats.maxPercent, (i + 1) * histogramResolution);
+            break;
+        }
+    }
+
+    return stats;
+}
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    PluginLoadMeter.h
+
+    DSP load of one plugin: how long each block it processes takes, as a
+    percentage of the block's duration at the sample rate. Keeps the
+    minimum, mean, 99th percentile and maximum since the last reset, and
+    counts spikes over a threshold. The audio thread adds a block at a
+    time with relaxed atomics; the display reads at its own rate. The
+    percentile comes from a fixed histogram, so nothing is allocated or
+    sorted on either side.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+class PluginLoadMeter
+{
+public:
+    PluginLoadMeter() = default;
+    ~PluginLoadMeter() = default;
+
+    struct Stats
+    {
+        float minPercent { 0.0f };
+        float meanPercent { 0.0f };
+        float p99Percent { 0.0f };     // To histogramResolution
+        float maxPercent { 0.0f };
+        juce::int64 numBlocks { 0 };
+        juce::int64 numSpikes { 0 };   // Blocks over the spike threshold
+    };
+
+    static constexpr float defaultSpikeThreshold = 50.0f;    // Percent of the block
+    static constexpr float histogramResolution = 0.5f;       // Percent per bin
+    static constexpr float histogramRange = 200.0f;          // Percent; longer blocks share the last bin
+
+    //==========================================================================
+    // Audio thread (one at a time)
+
+    // A block of numSamples that took the given ticks
+    // (juce::Time::getHighResolutionTicks()) to process
+    void addBlock(juce::int64 ticks, int numSamples, double sampleRate) noexcept;
+
+    //==========================================================================
+    // Any thread
+
+    Stats getStats() const noexcept;
+
+    // Taken up by the audio thread on its next block
+    void reset() noexcept { resetPending.store(true); }
+
+    void setSpikeThreshold(float percent) noexcept { spikeThreshold.store(percent); }
+    float getSpikeThreshold() const noexcept { return spikeThreshold.load(); }
+
+private:
+    //==========================================================================
+    static constexpr int numBins = static_cast<int>(histogramRange / histogramResolution) + 1;
+
+    void clear() noexcept;
+
+    std::atomic<float> minPercent { 0.0f };
+    std::atomic<float> maxPercent { 0.0f };
+    std::atomic<double> sumPercent { 0.0 };
+    std::atomic<juce::int64> numBlocks { 0 };
+    std::atomic<juce::int64> numSpikes { 0 };
+    std::array<std::atomic<juce::uint32>, numBins> histogram {};
+
+    std::atomic<float> spikeThreshold { defaultSpikeThreshold };
+    std::atomic<bool> resetPending { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginLoadMeter)
+};
@@ -10,6 +10,17 @@
 
 #include "PluginManager.h"
 
+namespace
+{
+    constexpr int scanCacheVersion = 1;
+    constexpr int scannerPollMs = 20;
+    constexpr int maxScannerProcesses = 8;
+
+    // runScanner()'s exit code when it couldn't scan through no fault of the
+    // plugin's. Not 1, which a plugin quitting the process is likely to use.
+    constexpr int scannerFailedExitCode = 3;
+}
+
 //==============================================================================
 PluginManager::PluginManager()
 {
@@ -18,6 +29,10 @@ PluginManager::PluginManager()
 
     // Set default search paths
     setDefaultPluginPaths();
+
+    // Plugins found by earlier scans are available straight away
+    loadScanCache();
+    rebuildKnownList();
 }
 
 PluginManager::~PluginManager()
@@ -55,6 +70,15 @@ void PluginManager::setDefaultPluginPaths()
 }
 
 //==============================================================================
+struct PluginManager::ScanJob
+{
+    juce::String bundlePath;
+    std::unique_ptr<BundleRecord> record;
+    std::unique_ptr<juce::ChildProcess> process;
+    juce::File resultFile;
+    juce::uint32 startTime { 0 };
+};
+
 void PluginManager::scanForPlugins()
 {
     if (scanning)
@@ -66,64 +90,371 @@ void PluginManager::scanForPlugins()
     if (onScanStarted)
         onScanStarted();
 
-    // Clear existing list
-    knownPluginList.clear();
+    scanPaths(pluginSearchPaths);
+
+    scanning = false;
+    scanProgress = 1.0f;
+
+    if (onScanFinished)
+        onScanFinished();
+}
+
+void PluginManager::scanDirectory(const juce::File& directory)
+{
+    if (!directory.exists() || !directory.isDirectory())
+        return;
+
+    scanPaths(juce::FileSearchPath(directory.getFullPathName()));
+}
+
+void PluginManager::scanPaths(const juce::FileSearchPath& paths)
+{
+    std::vector<std::unique_ptr<ScanJob>> jobs;
 
-    // Get all paths to scan
-    juce::StringArray paths;
-    for (int i = 0; i < pluginSearchPaths.getNumPaths(); ++i)
     {
-        auto path = pluginSearchPaths[i];
-        if (path.exists())
-            paths.add(path.getFullPathName());
+        const juce::ScopedLock sl(cacheLock);
+
+        for (auto* format : formatManager.getFormats())
+        {
+            for (const auto& identifier : format->searchPathsForPlugins(paths, true, false))
+            {
+                juce::int64 size = 0, modified = 0;
+
+                if (juce::File::isAbsolutePath(identifier))
+                    getBundleStamp(juce::File(identifier), size, modified);
+
+                // Unchanged: its plugins (or its blacklisting) stand
+                auto cached = scanCache.find(identifier);
+                if (cached != scanCache.end() && cached->second->size == size && cached->second->modified == modified)
+                    continue;
+
+                auto job = std::make_unique<ScanJob>();
+                job->bundlePath = identifier;
+                job->record = std::make_unique<BundleRecord>();
+                job->record->formatName = format->getName();
+                job->record->size = size;
+                job->record->modified = modified;
+                jobs.push_back(std::move(job));
+            }
+        }
+    }
+
+    runScanners(jobs);
+
+    {
+        const juce::ScopedLock sl(cacheLock);
+
+        for (auto& job : jobs)
+            scanCache[job->bundlePath] = std::move(job->record);
+
+        // Bundles deleted since
+        for (auto it = scanCache.begin(); it != scanCache.end();)
+        {
+            if (juce::File::isAbsolutePath(it->first) && !juce::File(it->first).exists())
+                it = scanCache.erase(it);
+            else
+                ++it;
+        }
     }
 
-    int totalPaths = paths.size();
-    int currentPath = 0;
+    saveScanCache();
+    rebuildKnownList();
+}
 
-    for (const auto& pathStr : paths)
+void PluginManager::runScanners(std::vector<std::unique_ptr<ScanJob>>& jobs)
+{
+    if (jobs.empty())
+        return;
+
+    const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+    const auto tempFolder = juce::File::getSpecialLocation(juce::File::tempDirectory);
+    const int maxRunning = numScannerProcesses > 0
+        ? numScannerProcesses
+        : juce::jlimit(1, maxScannerProcesses, juce::SystemStats::getNumCpus());
+
+    std::vector<ScanJob*> running;
+    size_t nextJob = 0;
+    size_t numFinished = 0;
+
+    auto finish = [this, &numFinished, &jobs](ScanJob& job)
     {
-        juce::File path(pathStr);
-        scanDirectory(path);
+        job.process.reset();
+        job.resultFile.deleteFile();
 
-        currentPath++;
-        scanProgress = (float)currentPath / (float)totalPaths;
+        ++numFinished;
+        scanProgress = (float)numFinished / (float)jobs.size();
 
         if (onScanProgress)
             onScanProgress(scanProgress);
+    };
+
+    while (numFinished < jobs.size())
+    {
+        // Keep the pool full
+        while ((int)running.size() < maxRunning && nextJob < jobs.size())
+        {
+            auto& job = *jobs[nextJob++];
+            job.resultFile = tempFolder.getNonexistentChildFile("SoundmanPluginScan", ".xml", false);
+            job.process = std::make_unique<juce::ChildProcess>();
+
+            juce::StringArray arguments { executable.getFullPathName(), scanPluginOption,
+                                          job.record->formatName, job.bundlePath,
+                                          job.resultFile.getFullPathName() };
+
+            // The scanner's output isn't read; plugins can be chatty
+            if (!job.process->start(arguments, 0))
+            {
+                // Not the plugin's fault: cached as unscanned, so it's tried again
+                job.record->modified = -1;
+                finish(job);
+                continue;
+            }
+
+            job.startTime = juce::Time::getMillisecondCounter();
+            running.push_back(&job);
+        }
+
+        juce::Thread::sleep(scannerPollMs);
+
+        for (auto it = running.begin(); it != running.end();)
+        {
+            auto& job = **it;
+            const bool timedOut = juce::Time::getMillisecondCounter() - job.startTime > (juce::uint32)scanTimeoutMs;
+
+            if (job.process->isRunning() && !timedOut)
+            {
+                ++it;
+                continue;
+            }
+
+            if (job.process->isRunning())
+            {
+                job.process->kill();
+                job.record->blacklisted = true;
+                job.record->reason = "Timed out while being scanned";
+            }
+            else if (auto result = juce::XmlDocument::parse(job.resultFile);
+                     result != nullptr && result->hasTagName("ScanResult"))
+            {
+                for (auto* typeXml : result->getChildIterator())
+                {
+                    auto type = std::make_unique<juce::PluginDescription>();
+
+                    if (type->loadFromXml(*typeXml))
+                    {
+                        if (onPluginFound)
+                            onPluginFound(type->name);
+
+                        job.record->types.add(type.release());
+                    }
+                }
+            }
+            else if (job.process->getExitCode() == (juce::uint32)scannerFailedExitCode)
+            {
+                // The scanner gave up (the format isn't available, the
+                // result couldn't be written): cached as unscanned, so it's
+                // tried again
+                job.record->modified = -1;
+            }
+            else
+            {
+                // Ended some other way without writing its result: killed by
+                // a signal or an exception (reported as 0 on POSIX), or quit
+                // by the plugin
+                job.record->blacklisted = true;
+                job.record->reason = "Crashed while being scanned";
+            }
+
+            finish(job);
+            it = running.erase(it);
+        }
     }
+}
 
-    scanning = false;
-    scanProgress = 1.0f;
+//==============================================================================
+bool PluginManager::isScannerCommandLine(const juce::StringArray& arguments)
+{
+    return arguments.contains(scanPluginOption);
+}
 
-    if (onScanFinished)
-        onScanFinished();
+int PluginManager::runScanner(const juce::StringArray& arguments)
+{
+    const int option = arguments.indexOf(scanPluginOption);
+    if (option < 0 || arguments.size() < option + 4)
+        return scannerFailedExitCode;
+
+    const auto formatName = arguments[option + 1];
+    const auto bundlePath = arguments[option + 2];
+    const juce::File resultFile(arguments[option + 3]);
+
+    juce::AudioPluginFormatManager formats;
+    formats.addDefaultFormats();
+
+    for (auto* format : formats.getFormats())
+    {
+        if (format->getName() != formatName)
+            continue;
+
+        // The part that may crash or hang, and the reason this is a process
+        juce::OwnedArray<juce::PluginDescription> types;
+        format->findAllTypesForFile(types, bundlePath);
+
+        juce::XmlElement result("ScanResult");
+        for (auto* type : types)
+            result.addChildElement(type->createXml().release());
+
+        return result.writeTo(resultFile) ? 0 : scannerFailedExitCode;
+    }
+
+    return scannerFailedExitCode;
 }
 
-void PluginManager::scanDirectory(const juce::File& directory)
+//==============================================================================
+void PluginManager::setNumScannerProcesses(int numProcesses)
 {
-    if (!directory.exists() || !directory.isDirectory())
+    numScannerProcesses = juce::jmax(0, numProcesses);
+}
+
+juce::StringArray PluginManager::getBlacklistedBundles() const
+{
+    const juce::ScopedLock sl(cacheLock);
+
+    juce::StringArray bundles;
+    for (const auto& entry : scanCache)
+        if (entry.second->blacklisted)
+            bundles.add(entry.first);
+
+    return bundles;
+}
+
+void PluginManager::clearBlacklist()
+{
+    {
+        const juce::ScopedLock sl(cacheLock);
+
+        // Forgotten, so the next scan tries them again
+        for (auto it = scanCache.begin(); it != scanCache.end();)
+        {
+            if (it->second->blacklisted)
+                it = scanCache.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    saveScanCache();
+    rebuildKnownList();
+}
+
+juce::File PluginManager::getScanCacheFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Soundman")
+        .getChildFile("PluginScanCache.xml");
+}
+
+void PluginManager::rebuildKnownList()
+{
+    const juce::ScopedLock sl(cacheLock);
+
+    knownPluginList.clear();
+    knownPluginList.clearBlacklistedFiles();
+
+    for (const auto& entry : scanCache)
+    {
+        if (entry.second->blacklisted)
+        {
+            knownPluginList.addToBlacklist(entry.first);
+            continue;
+        }
+
+        for (auto* type : entry.second->types)
+            knownPluginList.addType(*type);
+    }
+}
+
+void PluginManager::loadScanCache()
+{
+    auto xml = juce::XmlDocument::parse(getScanCacheFile());
+
+    if (xml == nullptr || !xml->hasTagName("PluginScanCache")
+        || xml->getIntAttribute("version") != scanCacheVersion)
         return;
 
-    // Find VST3 files
-    for (const auto& format : formatManager.getFormats())
+    const juce::ScopedLock sl(cacheLock);
+
+    for (auto* bundleXml : xml->getChildWithTagNameIterator("Bundle"))
     {
-        juce::PluginDirectoryScanner scanner(
-            knownPluginList,
-            *format,
-            juce::FileSearchPath(directory.getFullPathName()),
-            true,  // recursive
-            juce::File(),  // dead mans pedal file
-            false  // allow plugins requiring async instantiation
-        );
+        auto record = std::make_unique<BundleRecord>();
+        record->formatName = bundleXml->getStringAttribute("format");
+        record->size = bundleXml->getStringAttribute("size").getLargeIntValue();
+        record->modified = bundleXml->getStringAttribute("modified").getLargeIntValue();
+        record->blacklisted = bundleXml->getBoolAttribute("blacklisted", false);
+        record->reason = bundleXml->getStringAttribute("reason");
+
+        for (auto* typeXml : bundleXml->getChildIterator())
+        {
+            auto type = std::make_unique<juce::PluginDescription>();
+            if (type->loadFromXml(*typeXml))
+                record->types.add(type.release());
+        }
+
+        scanCache[bundleXml->getStringAttribute("path")] = std::move(record);
+    }
+}
+
+void PluginManager::saveScanCache()
+{
+    juce::XmlElement xml("PluginScanCache");
+    xml.setAttribute("version", scanCacheVersion);
+
+    {
+        const juce::ScopedLock sl(cacheLock);
 
-        juce::String pluginName;
-        while (scanner.scanNextFile(true, pluginName))
+        for (const auto& entry : scanCache)
         {
-            if (pluginName.isNotEmpty() && onPluginFound)
-                onPluginFound(pluginName);
+            const auto& record = *entry.second;
+
+            auto* bundleXml = xml.createNewChildElement("Bundle");
+            bundleXml->setAttribute("path", entry.first);
+            bundleXml->setAttribute("format", record.formatName);
+            bundleXml->setAttribute("size", juce::String(record.size));
+            bundleXml->setAttribute("modified", juce::String(record.modified));
+
+            if (record.blacklisted)
+            {
+                bundleXml->setAttribute("blacklisted", true);
+                bundleXml->setAttribute("reason", record.reason);
+            }
+
+            for (auto* type : record.types)
+                bundleXml->addChildElement(type->createXml().release());
         }
     }
+
+    auto file = getScanCacheFile();
+    file.getParentDirectory().createDirectory();
+    xml.writeTo(file);
+}
+
+void PluginManager::getBundleStamp(const juce::File& bundle, juce::int64& size, juce::int64& modified)
+{
+    size = 0;
+    modified = 0;
+
+    if (!bundle.isDirectory())
+    {
+        size = bundle.getSize();
+        modified = bundle.getLastModificationTime().toMilliseconds();
+        return;
+    }
+
+    // A bundle changes when any file in it does
+    for (const auto& entry : juce::RangedDirectoryIterator(bundle, true, "*", juce::File::findFiles))
+    {
+        size += entry.getFileSize();
+        modified = juce::jmax(modified, entry.getModificationTime().toMilliseconds());
+    }
 }
 
 //==============================================================================
@@ -155,6 +486,46 @@ std::unique_ptr<juce::AudioPluginInstance> PluginManager::loadPlugin(
     );
 }
 
+void PluginManager::loadPluginAsync(
+    const juce::PluginDescription& description,
+    double sampleRate,
+    int blockSize,
+    LoadCallback callback)
+{
+    juce::WeakReference<PluginManager> weakThis(this);
+
+    formatManager.createPluginInstanceAsync(description, sampleRate, blockSize,
+        [weakThis, sampleRate, blockSize, callback](std::unique_ptr<juce::AudioPluginInstance> instance,
+                                                    const juce::String& error)
+    {
+        auto* manager = weakThis.get();
+        if (manager == nullptr)
+            return;
+
+        if (instance == nullptr)
+        {
+            callback(nullptr, error);
+            return;
+        }
+
+        // Held in a shared_ptr only so the lambdas can be copied
+        auto plugin = std::make_shared<std::unique_ptr<juce::AudioPluginInstance>>(std::move(instance));
+
+        manager->loaderPool.addJob([weakThis, plugin, sampleRate, blockSize, callback]
+        {
+            // As EffectChain prepares its plugins; the chain sees it's ready
+            (*plugin)->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+            (*plugin)->prepareToPlay(sampleRate, blockSize);
+
+            juce::MessageManager::callAsync([weakThis, plugin, callback]
+            {
+                if (weakThis.get() != nullptr)
+                    callback(std::move(*plugin), {});
+            });
+        });
+    });
+}
+
 //==============================================================================
 void PluginManager::addPluginPath(const juce::File& path)
 {
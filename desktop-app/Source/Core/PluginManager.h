@@ -5,6 +5,13 @@
 
     VST3 Plugin hosting and management
 
+    Scanning runs each plugin bundle in a scanner subprocess (this binary
+    started with --scan-plugin), several at a time, so a plugin that
+    crashes or hangs while being scanned only takes its scanner down; it
+    is then blacklisted. Results are cached on disk by bundle path, size
+    and modification time, and only new or changed bundles are scanned
+    again.
+
   ==============================================================================
 */
 
@@ -12,6 +19,7 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_devices/juce_audio_devices.h>
+#include <map>
 #include <vector>
 #include <memory>
 
@@ -23,12 +31,41 @@ class PluginManager
     ~PluginManager();
 
     //==========================================================================
-    // Plugin scanning
+    // Plugin scanning (blocking; call from a background thread). The list
+    // is rebuilt from the cache and the bundles that had to be scanned.
     void scanForPlugins();
     void scanDirectory(const juce::File& directory);
     bool isScanning() const { return scanning; }
     float getScanProgress() const { return scanProgress; }
 
+    // Scanner subprocesses run at once (default: one per core, up to 8)
+    void setNumScannerProcesses(int numProcesses);
+
+    // A scanner that runs this long is killed and its bundle blacklisted
+    static constexpr int scanTimeoutMs = 60000;
+
+    // Bundles whose scanner crashed or hung; skipped until they change on
+    // disk or the blacklist is cleared
+    juce::StringArray getBlacklistedBundles() const;
+    void clearBlacklist();
+
+    // Scan cache location
+    static juce::File getScanCacheFile();
+
+    //==========================================================================
+    // Scanner subprocess. The app's startup checks for the option and, if
+    // it's there, runs the scan and exits with its result instead of
+    // opening a window.
+    static constexpr const char* scanPluginOption = "--scan-plugin";
+
+    static bool isScannerCommandLine(const juce::StringArray& arguments);
+
+    // Arguments: --scan-plugin <format name> <bundle path> <result file>.
+    // Writes the plugin descriptions found to the result file; returns the
+    // process exit code. A scanner that couldn't scan exits with a code of
+    // its own, so its bundle is tried again rather than blacklisted.
+    static int runScanner(const juce::StringArray& arguments);
+
     // Get plugin list
     juce::KnownPluginList& getKnownPluginList() { return knownPluginList; }
     const juce::KnownPluginList& getKnownPluginList() const { return knownPluginList; }
@@ -45,6 +82,18 @@ class PluginManager
         int blockSize,
         juce::String& errorMessage);
 
+    // Message thread. Creates the plugin (asynchronously, where the format
+    // allows it), then prepares it at the given settings on a loader
+    // thread, so neither the UI nor the audio thread sits through a slow
+    // plugin's setup. The callback comes on the message thread, with the
+    // plugin or an error message; not after the manager is gone.
+    using LoadCallback = std::function<void(std::unique_ptr<juce::AudioPluginInstance>, const juce::String& error)>;
+
+    void loadPluginAsync(const juce::PluginDescription& description,
+                         double sampleRate,
+                         int blockSize,
+                         LoadCallback callback);
+
     //==========================================================================
     // Plugin paths
     void addPluginPath(const juce::File& path);
@@ -74,5 +123,43 @@ class PluginManager
     float scanProgress { 0.0f };
 
     //==========================================================================
+    // Scan cache, by bundle path
+    struct BundleRecord
+    {
+        juce::String formatName;
+        juce::int64 size { 0 };
+        juce::int64 modified { 0 };   // Milliseconds since the epoch
+        bool blacklisted { false };
+        juce::String reason;          // Why it's blacklisted
+        juce::OwnedArray<juce::PluginDescription> types;
+    };
+
+    std::map<juce::String, std::unique_ptr<BundleRecord>> scanCache;
+    juce::CriticalSection cacheLock;
+    int numScannerProcesses { 0 };
+
+    // Scans the bundles under the paths that aren't cached (or changed),
+    // then rebuilds the list from the cache
+    void scanPaths(const juce::FileSearchPath& paths);
+
+    // One bundle for a scanner subprocess
+    struct ScanJob;
+
+    // Runs the jobs on up to numScannerProcesses subprocesses at a time;
+    // blocks until every one has a record
+    void runScanners(std::vector<std::unique_ptr<ScanJob>>& jobs);
+
+    void rebuildKnownList();
+    void loadScanCache();
+    void saveScanCache();
+
+    // Total size and latest modification time of a file or bundle directory
+    static void getBundleStamp(const juce::File& bundle, juce::int64& size, juce::int64& modified);
+
+    // Prepares loaded plugins; declared last so it's stopped first
+    juce::ThreadPool loaderPool { 1 };
+
+    //==========================================================================
+    JUCE_DECLARE_WEAK_REFERENCEABLE(PluginManager)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginManager)
 };
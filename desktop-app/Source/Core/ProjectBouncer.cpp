@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    ProjectBouncer.cpp
+
+    Offline multi-track mixdown implementation
+
+  ==============================================================================
+*/
+
+#include "ProjectBouncer.h"
+
+//==============================================================================
+ProjectBouncer::ProjectBouncer(MultiTrackAudioSource& e, juce::AudioFormatManager& fm)
+    : engine(e),
+      formatManager(fm)
+{
+    renderer.onFinished = [this](bool success, const juce::String& message)
+    {
+        if (onFinished != nullptr)
+            onFinished(success, success ? "Bounced to " + outputFile.getFileName() : message);
+    };
+}
+
+ProjectBouncer::~ProjectBouncer()
+{
+    renderer.onFinished = nullptr;
+}
+
+//==============================================================================
+juce::String ProjectBouncer::start(const juce::ValueTree& projectState, const Settings& settings)
+{
+    if (renderer.isRunning())
+        return "A bounce is already running";
+
+    // Format from the file extension
+    auto* format = formatManager.findFormatForFileExtension(settings.outputFile.getFileExtension());
+    if (format == nullptr || !format->canDoStereo())
+        return "Unsupported output format: " + settings.outputFile.getFileExtension();
+
+    if (!format->getPossibleBitDepths().contains(settings.bitDepth))
+        return format->getFormatName() + " can't be written at " + juce::String(settings.bitDepth) + " bits";
+
+    if (!holdInserts(projectState))
+        return "A track's inserts are in use by a freeze";
+
+    // Private, offline copy of the project, through the live inserts
+    OfflineRenderer::Job job;
+    job.name = "Bounce";
+    job.source = std::make_unique<MultiTrackAudioSource>(formatManager);
+    job.source->setOfflineRendering(true);
+    job.source->borrowInserts(trackChains, masterChain);
+    job.source->loadProject(projectState.createCopy());
+
+    const double projectSampleRate = job.source->getProjectSampleRate() > 0.0 ? job.source->getProjectSampleRate() : 44100.0;
+    job.outputSampleRate = settings.sampleRate > 0.0 ? settings.sampleRate : projectSampleRate;
+
+    // The chains stay prepared for the device: render at its rate and in
+    // blocks no longer than its
+    job.renderSampleRate = projectSampleRate;
+    job.renderBlockSize = OfflineRenderer::blockSize;
+
+    auto heldChain = getAnyHeldChain();
+
+    if (heldChain != nullptr && heldChain->getSampleRate() > 0.0)
+    {
+        job.renderSampleRate = heldChain->getSampleRate();
+        job.renderBlockSize = juce::jlimit(1, OfflineRenderer::blockSize, heldChain->getBlockSize());
+    }
+
+    if (!format->getPossibleSampleRates().contains((int)job.outputSampleRate))
+    {
+        releaseInserts();
+        return format->getFormatName() + " can't be written at " + juce::String(job.outputSampleRate) + " Hz";
+    }
+
+    job.startSample = juce::jmax((juce::int64)0, settings.startSample);
+    job.endSample = settings.endSample < 0 ? job.source->getTotalLength() : settings.endSample;
+
+    if (job.endSample <= job.startSample)
+    {
+        releaseInserts();
+        return "Nothing to bounce";
+    }
+
+    job.outputFile = settings.outputFile;
+    job.format = format;
+    job.bitDepth = settings.bitDepth;
+
+    for (auto& entry : trackChains)
+        job.chains.push_back(entry.second);
+
+    if (masterChain != nullptr)
+        job.chains.push_back(masterChain);
+
+    // The renderer holds the chains from here on
+    releaseInserts();
+
+    outputFile = settings.outputFile;
+    return renderer.start(std::move(job));
+}
+
+void ProjectBouncer::cancel()
+{
+    renderer.cancel();
+}
+
+bool ProjectBouncer::holdInserts(const juce::ValueTree& projectState)
+{
+    for (const auto& child : projectState)
+    {
+        if (!child.hasType(IDs::TRACK))
+            continue;
+
+        auto trackId = child[IDs::trackId].toString();
+        auto* trackChain = engine.getTrackInserts(trackId);
+
+        if (trackChain == nullptr || trackChain->getNumPlugins() == 0)
+            continue;
+
+        auto held = engine.holdTrackInserts(trackId);
+        if (held == nullptr)
+        {
+            releaseInserts();
+            return false;
+        }
+
+        trackChains[trackId] = std::move(held);
+    }
+
+    if (engine.getMasterInserts().getNumPlugins() > 0)
+    {
+        masterChain = engine.holdMasterInserts();
+
+        if (masterChain == nullptr)
+        {
+            releaseInserts();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ProjectBouncer::releaseInserts()
+{
+    trackChains.clear();
+    masterChain.reset();
+}
+
+std::shared_ptr<EffectChain> ProjectBouncer::getAnyHeldChain() const
+{
+    if (masterChain != nullptr)
+        return masterChain;
+
+    return trackChains.empty() ? nullptr : trackChains.begin()->second;
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    ProjectBouncer.h
+
+    Offline mixdown of a multi-track project to a WAV or FLAC file. A
+    private MultiTrackAudioSource renders a copy of the project in offline
+    mode (clips read their files synchronously, tracks render on the
+    parallel pool) as fast as the machine allows, through OfflineRenderer.
+
+    Tracks and the master run through the live engine's insert chains,
+    borrowed for the bounce as TrackFreezer does, so the file sounds like
+    playback, delay compensation included; the engine plays them dry until
+    it's done. With inserts the project renders at the device's rate, which
+    the chains are prepared for, otherwise at its own.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "MultiTrackAudioSource.h"
+#include "OfflineRenderer.h"
+#include <functional>
+#include <map>
+#include <memory>
+
+class ProjectBouncer
+{
+public:
+    //==========================================================================
+    struct Settings
+    {
+        juce::File outputFile;          // .wav or .flac
+        double sampleRate { 0.0 };      // 0: the project's rate
+        int bitDepth { 24 };            // 16, 24, or 32 (float; WAV only)
+        juce::int64 startSample { 0 };  // Timeline range
+        juce::int64 endSample { -1 };   // < 0: the end of the last clip
+    };
+
+    ProjectBouncer(MultiTrackAudioSource& engine, juce::AudioFormatManager& formatManager);
+    ~ProjectBouncer();
+
+    //==========================================================================
+    // Message thread. Bounces a copy of the project, so it can be edited
+    // while this runs. Returns an error message, or an empty string if the
+    // bounce has started.
+    juce::String start(const juce::ValueTree& projectState, const Settings& settings);
+
+    // The file is deleted; onFinished is still called
+    void cancel();
+
+    bool isRunning() const { return renderer.isRunning(); }
+
+    // 0 to 1
+    double getProgress() const { return renderer.getProgress(); }
+
+    // Message thread, when a bounce ends. On failure or cancellation the
+    // message says why and the output file has been removed.
+    std::function<void(bool success, const juce::String& message)> onFinished;
+
+private:
+    //==========================================================================
+    // Holds the live chains that have plugins; false if one is in use
+    bool holdInserts(const juce::ValueTree& projectState);
+    void releaseInserts();
+
+    // All held chains are prepared alike, for the device; nullptr if none
+    std::shared_ptr<EffectChain> getAnyHeldChain() const;
+
+    MultiTrackAudioSource& engine;
+    juce::AudioFormatManager& formatManager;
+    OfflineRenderer renderer;
+
+    // Held by start(), then handed to the renderer
+    std::map<juce::String, std::shared_ptr<EffectChain>> trackChains;
+    std::shared_ptr<EffectChain> masterChain;
+
+    juce::File outputFile;  // Of the bounce running
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProjectBouncer)
+};
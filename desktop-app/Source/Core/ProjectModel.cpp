@@ -145,6 +145,50 @@ juce::ValueTree TrackModel::findClipAt(juce::int64 timelineSamples) const
     return juce::ValueTree();
 }
 
+void TrackModel::setFrozen(const juce::File& file, juce::int64 startSample,
+                           const juce::String& clipHash, const juce::String& chainHash)
+{
+    state.setProperty(IDs::freezeStart, startSample, nullptr);
+    state.setProperty(IDs::freezeClipHash, clipHash, nullptr);
+    state.setProperty(IDs::freezeChainHash, chainHash, nullptr);
+
+    // Last: the engine switches over on this one
+    state.setProperty(IDs::freezeFile, file.getFullPathName(), nullptr);
+}
+
+void TrackModel::clearFrozen()
+{
+    state.removeProperty(IDs::freezeFile, nullptr);
+    state.removeProperty(IDs::freezeStart, nullptr);
+    state.removeProperty(IDs::freezeClipHash, nullptr);
+    state.removeProperty(IDs::freezeChainHash, nullptr);
+}
+
+juce::String TrackModel::computeClipHash() const
+{
+    juce::MemoryOutputStream clips;
+
+    for (int i = 0; i < state.getNumChildren(); ++i)
+    {
+        auto child = state.getChild(i);
+        if (child.hasType(IDs::CLIP))
+            child.writeToStream(clips);
+    }
+
+    return hashOf(clips.getMemoryBlock());
+}
+
+juce::String TrackModel::hashOf(const juce::MemoryBlock& data)
+{
+    auto hash = static_cast<juce::uint64>(14695981039346656037ULL);
+    auto* bytes = static_cast<const juce::uint8*>(data.getData());
+
+    for (size_t i = 0; i < data.getSize(); ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+
+    return juce::String::toHexString(static_cast<juce::int64>(hash));
+}
+
 juce::Array<juce::ValueTree> TrackModel::getClipsSortedByTime() const
 {
     juce::Array<juce::ValueTree> clips;
@@ -48,6 +48,10 @@ namespace IDs
     const juce::Identifier armed           { "armed" };
     const juce::Identifier inputChannel    { "inputChannel" };
     const juce::Identifier outputChannel   { "outputChannel" };
+    const juce::Identifier freezeFile      { "freezeFile" };       // Frozen: the rendered track
+    const juce::Identifier freezeStart     { "freezeStart" };      // In samples
+    const juce::Identifier freezeClipHash  { "freezeClipHash" };   // Clips and inserts it was rendered from
+    const juce::Identifier freezeChainHash { "freezeChainHash" };
 
     // Clip properties
     const juce::Identifier clipId          { "clipId" };
@@ -59,7 +63,7 @@ namespace IDs
     const juce::Identifier gain            { "gain" };             // Linear 0.0 - 2.0
     const juce::Identifier fadeInSamples   { "fadeInSamples" };
     const juce::Identifier fadeOutSamples  { "fadeOutSamples" };
-    const juce::Identifier fadeInCurve     { "fadeInCurve" };      // 0=linear, 1=exp, 2=log
+    const juce::Identifier fadeInCurve     { "fadeInCurve" };      // 0=linear, 1=exp, 2=log, 3=equal power
     const juce::Identifier fadeOutCurve    { "fadeOutCurve" };
     const juce::Identifier clipName        { "clipName" };
     const juce::Identifier clipColor       { "clipColor" };
@@ -116,6 +120,14 @@ class ClipModel
     void setFadeOutSamples(juce::int64 samples, juce::UndoManager* undo = nullptr)
     { state.setProperty(IDs::fadeOutSamples, samples, undo); }
 
+    int getFadeInCurve() const { return static_cast<int>(state[IDs::fadeInCurve]); }
+    void setFadeInCurve(int curve, juce::UndoManager* undo = nullptr)
+    { state.setProperty(IDs::fadeInCurve, curve, undo); }
+
+    int getFadeOutCurve() const { return static_cast<int>(state[IDs::fadeOutCurve]); }
+    void setFadeOutCurve(int curve, juce::UndoManager* undo = nullptr)
+    { state.setProperty(IDs::fadeOutCurve, curve, undo); }
+
     juce::String getClipName() const { return state[IDs::clipName].toString(); }
     void setClipName(const juce::String& name, juce::UndoManager* undo = nullptr)
     { state.setProperty(IDs::clipName, name, undo); }
@@ -203,6 +215,24 @@ class TrackModel
 
     juce::String getTrackId() const { return state[IDs::trackId].toString(); }
 
+    // Freeze: the track plays a render of its clips through its inserts
+    // (see TrackFreezer). Not undoable: the file goes with the freeze.
+    bool isFrozen() const { return state.hasProperty(IDs::freezeFile); }
+    juce::File getFreezeFile() const { return juce::File(state[IDs::freezeFile].toString()); }
+    juce::int64 getFreezeStart() const { return static_cast<juce::int64>(state[IDs::freezeStart]); }
+    juce::String getFreezeClipHash() const { return state[IDs::freezeClipHash].toString(); }
+    juce::String getFreezeChainHash() const { return state[IDs::freezeChainHash].toString(); }
+
+    void setFrozen(const juce::File& file, juce::int64 startSample,
+                   const juce::String& clipHash, const juce::String& chainHash);
+    void clearFrozen();
+
+    // Identifies the clips as they are now
+    juce::String computeClipHash() const;
+
+    // 64-bit FNV-1a of the data, in hex
+    static juce::String hashOf(const juce::MemoryBlock& data);
+
     // Clip management
     int getNumClips() const { return state.getNumChildren(); }
 
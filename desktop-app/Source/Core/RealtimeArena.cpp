@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    RealtimeArena.cpp
+
+    Per-callback scratch memory implementation
+
+  ==============================================================================
+*/
+
+#include "RealtimeArena.h"
+#include <array>
+#include <cstdint>
+
+//==============================================================================
+void RealtimeArena::prepare(int maxChannels, int maxBlockSize, int maxBuffers)
+{
+    auto samplesPerChannel = ((size_t)juce::jmax(1, maxBlockSize) + alignmentInFloats - 1)
+                                 / alignmentInFloats * alignmentInFloats;
+    auto totalFloats = samplesPerChannel * (size_t)juce::jmax(1, maxChannels) * (size_t)juce::jmax(1, maxBuffers);
+
+    storage.assign(totalFloats + alignmentInFloats, 0.0f);
+
+    // Start on a cache-line boundary so every block is SIMD friendly
+    auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+    auto alignmentBytes = alignmentInFloats * sizeof(float);
+    alignedStart = ((alignmentBytes - (address % alignmentBytes)) % alignmentBytes) / sizeof(float);
+
+    usedFloats = 0;
+}
+
+void RealtimeArena::release()
+{
+    storage.clear();
+    storage.shrink_to_fit();
+    alignedStart = 0;
+    usedFloats = 0;
+}
+
+//==============================================================================
+float* RealtimeArena::allocate(int numFloats) noexcept
+{
+    if (numFloats <= 0)
+        return nullptr;
+
+    auto rounded = ((size_t)numFloats + alignmentInFloats - 1) / alignmentInFloats * alignmentInFloats;
+
+    if (storage.empty() || alignedStart + usedFloats + rounded > storage.size())
+    {
+        // Arena too small for this callback: prepare() was given a smaller block size
+        jassertfalse;
+        return nullptr;
+    }
+
+    float* block = storage.data() + alignedStart + usedFloats;
+    usedFloats += rounded;
+    return block;
+}
+
+juce::AudioBuffer<float> RealtimeArena::allocateBuffer(int numChannels, int numSamples) noexcept
+{
+    if (numChannels <= 0 || numChannels > maxChannelsPerBuffer || numSamples <= 0)
+        return {};
+
+    auto samplesPerChannel = ((size_t)numSamples + alignmentInFloats - 1) / alignmentInFloats * alignmentInFloats;
+    float* block = allocate((int)(samplesPerChannel * (size_t)numChannels));
+
+    if (block == nullptr)
+        return {};
+
+    std::array<float*, maxChannelsPerBuffer> channels {};
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[(size_t)ch] = block + samplesPerChannel * (size_t)ch;
+
+    // Referring constructor: copies the pointers into the buffer's own
+    // preallocated channel space, no heap allocation
+    juce::AudioBuffer<float> buffer(channels.data(), numChannels, numSamples);
+    buffer.clear();
+    return buffer;
+}
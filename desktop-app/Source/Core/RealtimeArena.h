@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    RealtimeArena.h
+
+    Per-callback scratch memory for the audio thread. Storage is allocated
+    once in prepare(); each device callback calls reset() and carves its
+    temporary buffers out of the arena with a bump pointer, so the real-time
+    path never touches the heap.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+class RealtimeArena
+{
+public:
+    //==========================================================================
+    RealtimeArena() = default;
+    ~RealtimeArena() = default;
+
+    //==========================================================================
+    // Message thread, while the device is stopped.
+    // Reserves room for maxBuffers buffers of maxChannels x maxBlockSize samples.
+    void prepare(int maxChannels, int maxBlockSize, int maxBuffers);
+    void release();
+
+    //==========================================================================
+    // Audio thread
+
+    // Hand back everything allocated during the previous callback
+    void reset() noexcept { usedFloats = 0; }
+
+    // Returns numFloats of uninitialised storage, or nullptr if the arena is full
+    float* allocate(int numFloats) noexcept;
+
+    // Returns a cleared buffer referring to arena storage. If the request does
+    // not fit, the returned buffer has no channels and callers should skip the
+    // work that needed it.
+    juce::AudioBuffer<float> allocateBuffer(int numChannels, int numSamples) noexcept;
+
+    size_t getCapacity() const noexcept { return storage.size(); }
+    size_t getNumUsed() const noexcept { return usedFloats; }
+
+    // Maximum channels per buffer (AudioBuffer's preallocated channel space)
+    static constexpr int maxChannelsPerBuffer = 32;
+
+private:
+    //==========================================================================
+    static constexpr size_t alignmentInFloats = 16;  // 64-byte aligned blocks
+
+    std::vector<float> storage;
+    size_t alignedStart { 0 };
+    size_t usedFloats { 0 };
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeArena)
+};
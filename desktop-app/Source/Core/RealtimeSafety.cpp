@@ -0,0 +1,388 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.cpp
+
+    Audio thread allocation / lock checker implementation.
+
+    On Linux (glibc) malloc, calloc, realloc, free, the aligned allocators
+    and pthread_mutex_lock are interposed, which also covers operator new,
+    HeapBlock, juce::CriticalSection and std::mutex. On other platforms the
+    global operator new / delete are replaced instead and locks are not
+    intercepted.
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafety.h"
+#include <atomic>
+
+#if SOUNDMAN_RT_SAFETY_CHECKS
+ #include <cerrno>
+ #include <cstdlib>
+ #include <new>
+
+ #if defined(__GLIBC__)
+  #define SOUNDMAN_RT_SAFETY_INTERPOSE_LIBC 1
+  #include <dlfcn.h>
+  #include <pthread.h>
+ #else
+  #define SOUNDMAN_RT_SAFETY_INTERPOSE_LIBC 0
+ #endif
+
+ #if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+  #define SOUNDMAN_RT_SAFETY_BACKTRACE 1
+  #include <execinfo.h>
+ #else
+  #define SOUNDMAN_RT_SAFETY_BACKTRACE 0
+ #endif
+#endif
+
+#if SOUNDMAN_RT_SAFETY_CHECKS
+namespace
+{
+    //==========================================================================
+    // Thread state. Plain thread_locals with constant initialisers, so reading
+    // them from inside malloc never triggers dynamic TLS initialisation.
+    thread_local bool realtimeThread = false;
+    thread_local bool insideHook = false;
+
+    //==========================================================================
+    // Fixed-size violation queue: written by real-time threads, drained by the
+    // message thread. Slots still waiting to be logged are never overwritten;
+    // further violations are only counted.
+    constexpr juce::uint32 queueSize = 256;
+
+    struct Slot
+    {
+        std::atomic<bool> ready { false };
+        RealtimeSafety::Violation violation;
+    };
+
+    Slot violationQueue[queueSize];
+    std::atomic<juce::uint32> queueWriteCount { 0 };
+    juce::uint32 queueReadCount = 0;  // Message thread only
+    std::atomic<int> totalViolations { 0 };
+
+    // Frames belonging to reportViolation() and the interposed function
+    constexpr int checkerFrames = 2;
+
+   #if SOUNDMAN_RT_SAFETY_BACKTRACE
+    // The first backtrace() call loads the unwinder, which allocates.
+    // Do that during static initialisation, never on the audio thread.
+    struct BacktracePrimer
+    {
+        BacktracePrimer()
+        {
+            void* frames[2];
+            backtrace(frames, 2);
+        }
+    };
+
+    BacktracePrimer backtracePrimer;
+   #endif
+
+    const char* getTypeName(RealtimeSafety::ViolationType type)
+    {
+        switch (type)
+        {
+            case RealtimeSafety::ViolationType::Allocation:   return "allocation";
+            case RealtimeSafety::ViolationType::Deallocation: return "deallocation";
+            case RealtimeSafety::ViolationType::MutexLock:    return "mutex lock";
+        }
+
+        return "unknown";
+    }
+}
+#endif
+
+//==============================================================================
+RealtimeSafety::ScopedRealtimeContext::ScopedRealtimeContext() noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    wasRealtime = realtimeThread;
+    realtimeThread = true;
+   #endif
+}
+
+RealtimeSafety::ScopedRealtimeContext::~ScopedRealtimeContext() noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    realtimeThread = wasRealtime;
+   #endif
+}
+
+RealtimeSafety::ScopedAllowance::ScopedAllowance() noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    wasRealtime = realtimeThread;
+    realtimeThread = false;
+   #endif
+}
+
+RealtimeSafety::ScopedAllowance::~ScopedAllowance() noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    realtimeThread = wasRealtime;
+   #endif
+}
+
+//==============================================================================
+bool RealtimeSafety::isRealtimeThread() noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    return realtimeThread;
+   #else
+    return false;
+   #endif
+}
+
+void RealtimeSafety::reportViolation(ViolationType type, size_t size) noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    if (!realtimeThread || insideHook)
+        return;
+
+    insideHook = true;
+    totalViolations.fetch_add(1);
+
+    auto& slot = violationQueue[queueWriteCount.fetch_add(1) % queueSize];
+
+    if (!slot.ready.load(std::memory_order_acquire))
+    {
+        auto& violation = slot.violation;
+        violation.type = type;
+        violation.size = size;
+        violation.numFrames = 0;
+
+       #if SOUNDMAN_RT_SAFETY_BACKTRACE
+        void* frames[maxStackFrames + checkerFrames];
+        int numFrames = backtrace(frames, maxStackFrames + checkerFrames);
+
+        for (int i = checkerFrames; i < numFrames; ++i)
+            violation.frames[violation.numFrames++] = frames[i];
+       #endif
+
+        slot.ready.store(true, std::memory_order_release);
+    }
+
+    insideHook = false;
+   #else
+    juce::ignoreUnused(type, size);
+   #endif
+}
+
+int RealtimeSafety::getNumViolations() noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    return totalViolations.load();
+   #else
+    return 0;
+   #endif
+}
+
+void RealtimeSafety::clearViolations() noexcept
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    totalViolations.store(0);
+   #endif
+}
+
+int RealtimeSafety::logPendingViolations()
+{
+   #if SOUNDMAN_RT_SAFETY_CHECKS
+    int numLogged = 0;
+    auto written = queueWriteCount.load();
+
+    // Skip slots that were claimed while the queue was full
+    if (written - queueReadCount > queueSize)
+        queueReadCount = written - queueSize;
+
+    while (queueReadCount != written)
+    {
+        auto& slot = violationQueue[queueReadCount % queueSize];
+
+        // Claimed but still being filled in: pick it up next time
+        if (!slot.ready.load(std::memory_order_acquire))
+            break;
+
+        const auto& violation = slot.violation;
+
+        juce::String message;
+        message << "RT-safety violation on audio thread: " << getTypeName(violation.type);
+        if (violation.type == ViolationType::Allocation)
+            message << " (" << (juce::int64)violation.size << " bytes)";
+
+       #if SOUNDMAN_RT_SAFETY_BACKTRACE
+        if (auto** symbols = backtrace_symbols(violation.frames, violation.numFrames))
+        {
+            for (int i = 0; i < violation.numFrames; ++i)
+                message << juce::newLine << "    " << symbols[i];
+
+            std::free(symbols);
+        }
+       #endif
+
+        juce::Logger::writeToLog(message);
+
+        slot.ready.store(false, std::memory_order_release);
+        ++queueReadCount;
+        ++numLogged;
+    }
+
+    return numLogged;
+   #else
+    return 0;
+   #endif
+}
+
+//==============================================================================
+// Interception hooks
+#if SOUNDMAN_RT_SAFETY_CHECKS
+ #if SOUNDMAN_RT_SAFETY_INTERPOSE_LIBC
+
+namespace
+{
+    using PthreadMutexLockFunction = int (*)(pthread_mutex_t*);
+    std::atomic<PthreadMutexLockFunction> realPthreadMutexLock { nullptr };
+}
+
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void  __libc_free(void* ptr);
+    void* __libc_memalign(size_t alignment, size_t size);
+
+    void* malloc(size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, size);
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+            RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Deallocation, 0);
+
+        __libc_free(ptr);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, size);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, size);
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        void* ptr = __libc_memalign(alignment, size);
+        if (ptr == nullptr)
+            return ENOMEM;
+
+        *result = ptr;
+        return 0;
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        // No function-local static here: its guard could itself take a lock
+        auto realLock = realPthreadMutexLock.load(std::memory_order_acquire);
+
+        if (realLock == nullptr)
+        {
+            realLock = (PthreadMutexLockFunction)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+            realPthreadMutexLock.store(realLock, std::memory_order_release);
+        }
+
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::MutexLock, 0);
+        return realLock(mutex);
+    }
+}
+
+namespace
+{
+    // Resolve the real pthread_mutex_lock before any audio thread exists
+    struct MutexHookPrimer
+    {
+        MutexHookPrimer()
+        {
+            pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+            pthread_mutex_lock(&mutex);
+            pthread_mutex_unlock(&mutex);
+        }
+    };
+
+    MutexHookPrimer mutexHookPrimer;
+}
+
+ #else
+
+//==============================================================================
+// Portable fallback: replace the global allocation functions
+void* operator new(std::size_t size)
+{
+    RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, size);
+
+    if (auto* ptr = std::malloc(size != 0 ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation, size);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Deallocation, 0);
+
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept                        { operator delete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept             { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept           { operator delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept   { operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+
+ #endif
+#endif
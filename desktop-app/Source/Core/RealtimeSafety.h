@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.h
+
+    Debug-build checker for the audio thread. While a ScopedRealtimeContext
+    is alive on a thread, heap allocations, frees and mutex locks made by
+    that thread are recorded with their call stack and logged later from the
+    message thread.
+
+    Compiled in only when SOUNDMAN_RT_SAFETY_CHECKS=1 (CMake enables it for
+    Debug builds). In other builds every call here is a no-op.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#ifndef SOUNDMAN_RT_SAFETY_CHECKS
+ #define SOUNDMAN_RT_SAFETY_CHECKS 0
+#endif
+
+class RealtimeSafety
+{
+public:
+    //==========================================================================
+    enum class ViolationType
+    {
+        Allocation,
+        Deallocation,
+        MutexLock
+    };
+
+    static constexpr int maxStackFrames = 12;
+
+    struct Violation
+    {
+        ViolationType type { ViolationType::Allocation };
+        size_t size { 0 };                    // Bytes requested (allocations only)
+        int numFrames { 0 };
+        void* frames[maxStackFrames] {};      // frames[0] is the call site
+    };
+
+    //==========================================================================
+    /** Marks the current thread as real-time for the lifetime of this object. */
+    class ScopedRealtimeContext
+    {
+    public:
+        ScopedRealtimeContext() noexcept;
+        ~ScopedRealtimeContext() noexcept;
+
+    private:
+        bool wasRealtime { false };
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeContext)
+    };
+
+    /** Suspends checking on this thread, for known and accepted exceptions. */
+    class ScopedAllowance
+    {
+    public:
+        ScopedAllowance() noexcept;
+        ~ScopedAllowance() noexcept;
+
+    private:
+        bool wasRealtime { false };
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllowance)
+    };
+
+    //==========================================================================
+    static constexpr bool isEnabled() noexcept { return SOUNDMAN_RT_SAFETY_CHECKS != 0; }
+    static bool isRealtimeThread() noexcept;
+
+    // Called by the interception hooks on the offending thread
+    static void reportViolation(ViolationType type, size_t size) noexcept;
+
+    // Total violations since start-up or the last clearViolations()
+    static int getNumViolations() noexcept;
+    static void clearViolations() noexcept;
+
+    // Message thread: writes queued violations to juce::Logger with a
+    // symbolised stack. Returns the number of violations logged.
+    static int logPendingViolations();
+
+private:
+    RealtimeSafety() = delete;
+};
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    RecordingWriter.cpp
+
+    Lock-free recording handoff implementation
+
+  ==============================================================================
+*/
+
+#include "RecordingWriter.h"
+
+//==============================================================================
+RecordingWriter::RecordingWriter(std::unique_ptr<juce::AudioFormatWriter> writerToUse,
+                                 int fifoSizeInSamples)
+    : writer(std::move(writerToUse)),
+      fifo(juce::jmax(1024, fifoSizeInSamples))
+{
+    jassert(writer != nullptr);
+
+    numFileChannels = writer != nullptr ? (int)writer->getNumChannels() : 0;
+    fifoBuffer.setSize(juce::jmax(1, numFileChannels), fifo.getTotalSize());
+    fifoBuffer.clear();
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    flush();
+
+    if (writer != nullptr)
+        writer->flush();
+}
+
+//==============================================================================
+bool RecordingWriter::write(const float* const* data, int numChannels, int numSamples) noexcept
+{
+    if (numSamples <= 0 || numFileChannels <= 0)
+        return true;
+
+    // AbstractFifo only uses atomics: no locks, no allocation
+    const auto scope = fifo.write(numSamples);
+
+    auto copyRange = [&](int fifoStart, int count, int sourceOffset)
+    {
+        for (int ch = 0; ch < numFileChannels; ++ch)
+        {
+            if (ch < numChannels && data != nullptr && data[ch] != nullptr)
+                fifoBuffer.copyFrom(ch, fifoStart, data[ch] + sourceOffset, count);
+            else
+                fifoBuffer.clear(ch, fifoStart, count);
+        }
+    };
+
+    if (scope.blockSize1 > 0)
+        copyRange(scope.startIndex1, scope.blockSize1, 0);
+    if (scope.blockSize2 > 0)
+        copyRange(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+
+    int written = scope.blockSize1 + scope.blockSize2;
+    if (written < numSamples)
+    {
+        droppedSamples.fetch_add(numSamples - written);
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+int RecordingWriter::useTimeSlice()
+{
+    flush();
+    return pollIntervalMs;
+}
+
+void RecordingWriter::flush()
+{
+    if (writer == nullptr)
+        return;
+
+    while (fifo.getNumReady() > 0)
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+
+        if (scope.blockSize1 > 0)
+            writer->writeFromAudioSampleBuffer(fifoBuffer, scope.startIndex1, scope.blockSize1);
+        if (scope.blockSize2 > 0)
+            writer->writeFromAudioSampleBuffer(fifoBuffer, scope.startIndex2, scope.blockSize2);
+    }
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    RecordingWriter.h
+
+    Lock-free recording handoff. The audio thread copies blocks into a
+    single-producer / single-consumer FIFO without locking or signalling;
+    a TimeSliceThread polls the FIFO and writes to the AudioFormatWriter.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <memory>
+
+class RecordingWriter : public juce::TimeSliceClient
+{
+public:
+    //==========================================================================
+    static constexpr int defaultFifoSize = 1 << 16;  // samples per channel
+
+    RecordingWriter(std::unique_ptr<juce::AudioFormatWriter> writerToUse,
+                    int fifoSizeInSamples = defaultFifoSize);
+
+    // Writes out anything still queued. Remove the client from its
+    // TimeSliceThread before destroying it.
+    ~RecordingWriter() override;
+
+    //==========================================================================
+    // Audio thread (wait-free). Channels beyond the file's channel count are
+    // ignored; missing channels are written as silence. Returns false if the
+    // FIFO overflowed and samples were dropped.
+    bool write(const float* const* data, int numChannels, int numSamples) noexcept;
+
+    //==========================================================================
+    // Writer thread
+    int useTimeSlice() override;
+
+    // Writes everything currently queued (any single consumer thread)
+    void flush();
+
+    juce::int64 getNumDroppedSamples() const noexcept { return droppedSamples.load(); }
+    int getNumChannels() const noexcept { return numFileChannels; }
+
+private:
+    //==========================================================================
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    int numFileChannels { 0 };
+
+    juce::AbstractFifo fifo;
+    juce::AudioBuffer<float> fifoBuffer;
+    std::atomic<juce::int64> droppedSamples { 0 };
+
+    static constexpr int pollIntervalMs = 10;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RecordingWriter)
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    RenderPlan.cpp
+
+    Interval index over a plan's clips
+
+  ==============================================================================
+*/
+
+#include "RenderPlan.h"
+
+//==============================================================================
+void RenderPlan::indexClips()
+{
+    clipTree.clear();
+    clipsByStart.clear();
+    clipsByEnd.clear();
+    totalLength = 0;
+
+    std::vector<int> clipIndices;
+
+    for (auto& track : tracks)
+    {
+        // Empty clips can't overlap anything, so they aren't indexed
+        clipIndices.clear();
+        for (int i = track.firstClip; i < track.firstClip + track.numClips; ++i)
+        {
+            const auto& clip = clips[static_cast<size_t>(i)];
+            totalLength = juce::jmax(totalLength, clip.timelineEnd);
+
+            if (clip.timelineEnd > clip.timelineStart)
+                clipIndices.push_back(i);
+        }
+
+        track.clipTreeRoot = buildClipTree(clipIndices);
+    }
+}
+
+int RenderPlan::buildClipTree(std::vector<int>& clipIndices)
+{
+    if (clipIndices.empty())
+        return -1;
+
+    // Centre on the median of the clips' starts and ends: neither side can
+    // then get every clip, so each level has fewer than the one above
+    std::vector<juce::int64> edges;
+    edges.reserve(clipIndices.size() * 2);
+
+    for (auto index : clipIndices)
+    {
+        edges.push_back(clips[static_cast<size_t>(index)].timelineStart);
+        edges.push_back(clips[static_cast<size_t>(index)].timelineEnd);
+    }
+
+    auto median = edges.begin() + static_cast<std::ptrdiff_t>(clipIndices.size() - 1);
+    std::nth_element(edges.begin(), median, edges.end());
+    const auto centre = *median;
+
+    std::vector<int> before, spanning, after;
+
+    for (auto index : clipIndices)
+    {
+        const auto& clip = clips[static_cast<size_t>(index)];
+
+        if (clip.timelineEnd <= centre)
+            before.push_back(index);
+        else if (clip.timelineStart > centre)
+            after.push_back(index);
+        else
+            spanning.push_back(index);
+    }
+
+    const int node = static_cast<int>(clipTree.size());
+    clipTree.push_back({ centre, -1, -1, static_cast<int>(clipsByStart.size()), static_cast<int>(spanning.size()) });
+
+    std::stable_sort(spanning.begin(), spanning.end(), [this](int a, int b)
+    {
+        return clips[static_cast<size_t>(a)].timelineStart < clips[static_cast<size_t>(b)].timelineStart;
+    });
+    clipsByStart.insert(clipsByStart.end(), spanning.begin(), spanning.end());
+
+    std::stable_sort(spanning.begin(), spanning.end(), [this](int a, int b)
+    {
+        return clips[static_cast<size_t>(a)].timelineEnd > clips[static_cast<size_t>(b)].timelineEnd;
+    });
+    clipsByEnd.insert(clipsByEnd.end(), spanning.begin(), spanning.end());
+
+    // Children are appended after this node, so it's updated by index
+    const int left = buildClipTree(before);
+    const int right = buildClipTree(after);
+    clipTree[static_cast<size_t>(node)].left = left;
+    clipTree[static_cast<size_t>(node)].right = right;
+
+    return node;
+}
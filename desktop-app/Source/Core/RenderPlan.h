@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    RenderPlan.h
+
+    Immutable, flat snapshot of a project for the audio thread. The message
+    thread compiles the project ValueTree into a RenderPlan (tracks, clips,
+    gains and fades as plain arrays, with mute / solo and pan laws already
+    resolved) and hands it over by pointer swap; the audio thread never
+    touches the ValueTree or takes a lock to mix.
+
+    The stateful parts of playback (clip streams and resamplers, track
+    buffers) live in ClipAudioSource / TrackAudioSource objects that outlive
+    individual plans. A plan holds references to the ones it uses, so they
+    stay alive until the plan itself is freed, on the message thread.
+
+    Each track's clips are sorted by start, and indexed by a centred
+    interval tree kept in flat arrays: every node holds the clips spanning
+    its centre, sorted by start and by end, so the clips overlapping a block
+    are found in O(log n + k) whatever their lengths - a long clip early on
+    doesn't make every later block walk the clips it spans.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "../DSP/FadeCurve.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+class ClipAudioSource;
+class TrackAudioSource;
+class CompensationDelay;
+
+struct RenderPlan
+{
+    //==========================================================================
+    struct Clip
+    {
+        ClipAudioSource* source;       // nullptr if the file couldn't be loaded
+        juce::int64 timelineStart;     // Timeline samples
+        juce::int64 timelineEnd;
+        juce::int64 sourceStart;       // File samples
+        juce::int64 fadeInSamples;
+        juce::int64 fadeOutSamples;
+        FadeCurve::Shape fadeInCurve;
+        FadeCurve::Shape fadeOutCurve;
+        float gain;
+
+        juce::int64 getLength() const noexcept { return timelineEnd - timelineStart; }
+    };
+
+    struct Track
+    {
+        TrackAudioSource* source;
+        int firstClip;                 // Range in clips, sorted by timelineStart
+        int numClips;
+        int clipTreeRoot;              // In clipTree; -1: no clips
+        float leftGain;                // Volume and pan law combined
+        float rightGain;
+        bool audible;                  // Mute and solo resolved
+        bool insertsActive;            // False when frozen: the clips were rendered through them
+        int meterIndex;                // In the TrackMeterBank; -1: not metered
+        int latencySamples;            // Of the track's inserts (0 if inactive)
+        int compensationSamples;       // Delay that lines it up with the latest track
+        CompensationDelay* compensationDelay;  // The track's delay line, long enough for it
+    };
+
+    // Node of a track's interval tree: the clips containing centre
+    // (timelineStart <= centre < timelineEnd); those wholly before it are
+    // under left, those wholly after under right
+    struct ClipTreeNode
+    {
+        juce::int64 centre;
+        int left;                      // In clipTree; -1: none
+        int right;
+        int firstEntry;                // Range in clipsByStart / clipsByEnd
+        int numEntries;
+    };
+
+    //==========================================================================
+    std::vector<Track> tracks;
+    std::vector<Clip> clips;
+    juce::int64 totalLength { 0 };
+
+    // The tracks' interval trees. Per node, indices in clips of the clips it
+    // holds, by timelineStart (earliest first) and by timelineEnd (latest
+    // first)
+    std::vector<ClipTreeNode> clipTree;
+    std::vector<int> clipsByStart;
+    std::vector<int> clipsByEnd;
+
+    // Clips starting this soon after a block get their streams primed
+    juce::int64 cueAheadSamples { 0 };
+
+    // Patched from the previous plan by clip edits alone: only the clips
+    // listed (indices in clips) need re-cueing when it's picked up
+    bool patched { false };
+    std::vector<int> patchedClips;
+
+    // (Re)builds every track's interval tree, and totalLength, from the
+    // clips. Message thread: it allocates.
+    void indexClips();
+
+    // Calls callback(const Clip&) for each of the track's clips overlapping
+    // [start, end), in no particular order. O(log n + k), no allocation.
+    template <typename Callback>
+    void forEachClipOverlapping(const Track& track, juce::int64 start, juce::int64 end, Callback&& callback) const;
+
+    // Index of the track's first clip starting at or after position, or the
+    // end of its range (O(log n))
+    int findFirstClipStartingFrom(const Track& track, juce::int64 position) const noexcept;
+
+    // Owners of the sources the arrays point at
+    std::vector<std::shared_ptr<TrackAudioSource>> trackSources;
+    std::vector<std::shared_ptr<ClipAudioSource>> clipSources;
+
+    // And of the tracks' delay lines: a line replaced by a longer one is
+    // freed with the last plan using it
+    std::vector<std::shared_ptr<CompensationDelay>> compensationDelays;
+
+private:
+    int buildClipTree(std::vector<int>& clipIndices);
+
+    template <typename Callback>
+    void visitClipTree(int node, juce::int64 start, juce::int64 end, Callback& callback) const;
+};
+
+//==============================================================================
+template <typename Callback>
+void RenderPlan::forEachClipOverlapping(const Track& track, juce::int64 start, juce::int64 end,
+                                        Callback&& callback) const
+{
+    visitClipTree(track.clipTreeRoot, start, end, callback);
+}
+
+template <typename Callback>
+void RenderPlan::visitClipTree(int node, juce::int64 start, juce::int64 end, Callback& callback) const
+{
+    while (node >= 0)
+    {
+        const auto& treeNode = clipTree[static_cast<size_t>(node)];
+        const int* byStart = clipsByStart.data() + treeNode.firstEntry;
+        const int* byEnd = clipsByEnd.data() + treeNode.firstEntry;
+
+        if (end <= treeNode.centre)
+        {
+            // All of the node's clips end after the range: those starting
+            // before its end overlap it, and only the left can hold more
+            for (int i = 0; i < treeNode.numEntries && clips[static_cast<size_t>(byStart[i])].timelineStart < end; ++i)
+                callback(clips[static_cast<size_t>(byStart[i])]);
+
+            node = treeNode.left;
+        }
+        else if (start > treeNode.centre)
+        {
+            // All of them start before it: those ending after its start
+            for (int i = 0; i < treeNode.numEntries && clips[static_cast<size_t>(byEnd[i])].timelineEnd > start; ++i)
+                callback(clips[static_cast<size_t>(byEnd[i])]);
+
+            node = treeNode.right;
+        }
+        else
+        {
+            // The range spans the centre: every clip here overlaps it
+            for (int i = 0; i < treeNode.numEntries; ++i)
+                callback(clips[static_cast<size_t>(byStart[i])]);
+
+            visitClipTree(treeNode.left, start, end, callback);
+            node = treeNode.right;
+        }
+    }
+}
+
+inline int RenderPlan::findFirstClipStartingFrom(const Track& track, juce::int64 position) const noexcept
+{
+    auto begin = clips.begin() + track.firstClip;
+    auto end = begin + track.numClips;
+
+    auto found = std::partition_point(begin, end, [position](const Clip& clip) { return clip.timelineStart < position; });
+    return static_cast<int>(found - clips.begin());
+}
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    SincResamplingSource.cpp
+
+    Sample-rate converting PositionableAudioSource implementation
+
+  ==============================================================================
+*/
+
+#include "SincResamplingSource.h"
+#include <cmath>
+
+//==============================================================================
+SincResamplingSource::SincResamplingSource(juce::PositionableAudioSource* inputSource, bool deleteInputWhenDeleted,
+                                           double sourceSampleRate, int numChannelsToUse,
+                                           SincResampler::Quality qualityToUse)
+    : input(inputSource, deleteInputWhenDeleted),
+      inputSampleRate(sourceSampleRate),
+      numChannels(juce::jlimit(1, SincResampler::maxChannels, numChannelsToUse)),
+      quality(qualityToUse)
+{
+    jassert(inputSource != nullptr);
+}
+
+//==============================================================================
+void SincResamplingSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // Where the input is now, so a rate change keeps the play position
+    const double inputPosition = bypass ? (double)input->getNextReadPosition() : (double)position * ratio;
+
+    blockSize = juce::jmax(1, samplesPerBlockExpected);
+    bypass = inputSampleRate <= 0.0 || sampleRate <= 0.0 || std::abs(inputSampleRate - sampleRate) < 1.0e-6;
+
+    if (bypass)
+    {
+        ratio = 1.0;
+        inputBuffer.setSize(0, 0);
+        outputBuffer.setSize(0, 0);
+
+        input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        input->setNextReadPosition((juce::int64)inputPosition);
+        return;
+    }
+
+    ratio = inputSampleRate / sampleRate;
+    resampler.prepare(numChannels, ratio, quality, blockSize);
+
+    inputBuffer.setSize(numChannels, resampler.getMaxInputSamplesPerCall());
+    outputBuffer.setSize(numChannels, blockSize);
+
+    input->prepareToPlay(resampler.getMaxInputSamplesPerCall(), inputSampleRate);
+
+    position = (juce::int64)std::llround(inputPosition / ratio);
+    needsResync = true;
+}
+
+void SincResamplingSource::releaseResources()
+{
+    input->releaseResources();
+    inputBuffer.setSize(0, 0);
+    outputBuffer.setSize(0, 0);
+}
+
+//==============================================================================
+void SincResamplingSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (bypass)
+    {
+        input->getNextAudioBlock(bufferToFill);
+        return;
+    }
+
+    if (needsResync)
+        resync();
+
+    auto& dest = *bufferToFill.buffer;
+
+    for (int done = 0; done < bufferToFill.numSamples;)
+    {
+        const int numThisTime = juce::jmin(blockSize, bufferToFill.numSamples - done);
+        const int numInput = resampler.getNumInputSamplesNeeded(numThisTime);
+
+        if (numInput > 0)
+            input->getNextAudioBlock(juce::AudioSourceChannelInfo(&inputBuffer, 0, numInput));
+
+        resampler.process(inputBuffer.getArrayOfReadPointers(), outputBuffer.getArrayOfWritePointers(), numThisTime);
+
+        const int destStart = bufferToFill.startSample + done;
+
+        for (int ch = 0; ch < dest.getNumChannels(); ++ch)
+        {
+            if (ch < numChannels)
+                dest.copyFrom(ch, destStart, outputBuffer, ch, 0, numThisTime);
+            else if (numChannels == 1)
+                dest.copyFrom(ch, destStart, outputBuffer, 0, 0, numThisTime);
+            else
+                dest.clear(ch, destStart, numThisTime);
+        }
+
+        done += numThisTime;
+    }
+
+    position += bufferToFill.numSamples;
+}
+
+void SincResamplingSource::resync()
+{
+    // Feed from the resampler's latency before the exact input position;
+    // negative positions read as silence
+    const double inputPosition = (double)position * ratio;
+    const auto whole = (juce::int64)std::floor(inputPosition);
+
+    resampler.reset(inputPosition - (double)whole);
+    input->setNextReadPosition(whole - resampler.getInputLatency());
+    needsResync = false;
+}
+
+//==============================================================================
+void SincResamplingSource::setNextReadPosition(juce::int64 newPosition)
+{
+    if (bypass)
+    {
+        input->setNextReadPosition(newPosition);
+        return;
+    }
+
+    position = newPosition;
+    needsResync = true;
+}
+
+juce::int64 SincResamplingSource::getNextReadPosition() const
+{
+    if (bypass)
+        return input->getNextReadPosition();
+
+    auto total = getTotalLength();
+    return (isLooping() && total > 0) ? position % total : position;
+}
+
+juce::int64 SincResamplingSource::getTotalLength() const
+{
+    return bypass ? input->getTotalLength()
+                  : (juce::int64)((double)input->getTotalLength() / ratio);
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    SincResamplingSource.h
+
+    PositionableAudioSource that converts another source to the rate it is
+    prepared with, using SincResampler. Positions and lengths are in output
+    samples, so it can sit under an AudioTransportSource (or anything else
+    that counts device samples) without a rate correction of its own.
+
+    When the input rate already matches, blocks pass straight through.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../DSP/SincResampler.h"
+
+class SincResamplingSource : public juce::PositionableAudioSource
+{
+public:
+    //==========================================================================
+    // numChannels is the number of input channels to convert; a mono input
+    // is copied to every output channel
+    SincResamplingSource(juce::PositionableAudioSource* input, bool deleteInputWhenDeleted,
+                         double inputSampleRate, int numChannels,
+                         SincResampler::Quality quality = SincResampler::Quality::high);
+    ~SincResamplingSource() override = default;
+
+    // Takes effect at the next prepareToPlay()
+    void setQuality(SincResampler::Quality newQuality) { quality = newQuality; }
+    SincResampler::Quality getQuality() const { return quality; }
+
+    double getInputSampleRate() const { return inputSampleRate; }
+
+    //==========================================================================
+    // PositionableAudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override { return input->isLooping(); }
+    void setLooping(bool shouldLoop) override { input->setLooping(shouldLoop); }
+
+private:
+    //==========================================================================
+    // Restarts the conversion at the current output position
+    void resync();
+
+    juce::OptionalScopedPointer<juce::PositionableAudioSource> input;
+    const double inputSampleRate;
+    const int numChannels;
+    SincResampler::Quality quality;
+
+    SincResampler resampler;
+    juce::AudioBuffer<float> inputBuffer;
+    juce::AudioBuffer<float> outputBuffer;
+    double ratio { 1.0 };  // Input rate / output rate
+    bool bypass { true };
+    int blockSize { 0 };
+
+    juce::int64 position { 0 };  // Output samples
+    bool needsResync { true };
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SincResamplingSource)
+};
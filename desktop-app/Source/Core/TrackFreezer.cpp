@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+    TrackFreezer.cpp
+
+    Track freeze implementation
+
+  ==============================================================================
+*/
+
+#include "TrackFreezer.h"
+#include <limits>
+
+namespace
+{
+    constexpr int freezeBitDepth = 32;  // Float: the render isn't a master
+    constexpr int deletionRetryIntervalMs = 1000;
+}
+
+//==============================================================================
+TrackFreezer::TrackFreezer(ProjectManager& pm, MultiTrackAudioSource& e, juce::AudioFormatManager& fm)
+    : projectManager(pm),
+      engine(e),
+      formatManager(fm)
+{
+    projectManager.addListener(this);
+    engine.onTrackInsertsStateChanged = [this](const juce::String& trackId) { checkChain(trackId); };
+    renderer.onFinished = [this](bool success, const juce::String& message) { renderFinished(success, message); };
+}
+
+TrackFreezer::~TrackFreezer()
+{
+    stopTimer();
+    projectManager.removeListener(this);
+    engine.onTrackInsertsStateChanged = nullptr;
+    renderer.onFinished = nullptr;
+}
+
+juce::File TrackFreezer::getFreezeFolder(const juce::File& projectFile)
+{
+    if (projectFile.existsAsFile())
+        return projectFile.getParentDirectory().getChildFile("Freeze");
+
+    return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("Soundman Freeze");
+}
+
+//==============================================================================
+juce::String TrackFreezer::freeze(const juce::String& trackId)
+{
+    if (renderer.isRunning())
+        return "A track is already being frozen";
+
+    auto trackState = projectManager.getProject().findTrackById(trackId);
+    TrackModel track(trackState);
+
+    if (!track.isValid())
+        return "No such track";
+
+    if (track.isFrozen())
+        return "The track is already frozen";
+
+    // Range: the first clip's start to the last one's end
+    juce::int64 endSample = 0;
+    juce::int64 rangeStart = std::numeric_limits<juce::int64>::max();
+
+    for (const auto& clip : track.getClipsSortedByTime())
+    {
+        ClipModel clipModel(clip);
+        rangeStart = juce::jmin(rangeStart, clipModel.getTimelineStart());
+        endSample = juce::jmax(endSample, clipModel.getTimelineEnd());
+    }
+
+    if (endSample <= rangeStart)
+        return "Nothing to freeze";
+
+    // The live chain runs in the render until it's done; it stays prepared
+    // for the device, so the track renders at the device's rate and block size
+    auto chain = engine.holdTrackInserts(trackId);
+    if (chain == nullptr)
+        return "The track isn't loaded yet, or its inserts are in use by a bounce";
+
+    OfflineRenderer::Job job;
+    job.name = "Freeze";
+    job.renderSampleRate = chain->getSampleRate() > 0.0 ? chain->getSampleRate() : 44100.0;
+    job.renderBlockSize = juce::jmax(1, chain->getBlockSize());
+    job.outputSampleRate = job.renderSampleRate;
+    job.startSample = rangeStart;
+
+    const double tailSeconds = juce::jmin(maxTailSeconds, chain->getTailLengthSeconds());
+    job.endSample = endSample + static_cast<juce::int64>(tailSeconds * job.renderSampleRate);
+
+    const auto newClipHash = track.computeClipHash();
+    const auto newChainHash = computeChainHash(*chain);
+
+    // A copy of the project with just this track, at unity gain and
+    // without its freeze
+    auto projectCopy = projectManager.getProjectState().createCopy();
+
+    for (int i = projectCopy.getNumChildren(); --i >= 0;)
+    {
+        auto child = projectCopy.getChild(i);
+        if (child.hasType(IDs::TRACK) && child[IDs::trackId].toString() != trackId)
+            projectCopy.removeChild(i, nullptr);
+    }
+
+    TrackModel trackCopy(projectCopy.getChildWithProperty(IDs::trackId, trackId));
+    trackCopy.setVolume(1.0f);
+    trackCopy.setPan(0.0f);
+    trackCopy.setMuted(false);
+    trackCopy.setSoloed(false);
+    trackCopy.clearFrozen();
+
+    // A new file each time: the engine's cache may still know the last one
+    auto folder = getFreezeFolder(projectManager.getProjectFile());
+    if (folder.createDirectory().failed())
+        return "Can't create " + folder.getFullPathName();
+
+    job.outputFile = folder.getNonexistentChildFile(trackId, ".wav", false);
+    job.format = &wavFormat;
+    job.bitDepth = freezeBitDepth;
+
+    job.source = std::make_unique<MultiTrackAudioSource>(formatManager);
+    job.source->setOfflineRendering(true);
+    job.source->borrowInserts({ { trackId, chain } }, nullptr);
+    job.source->loadProject(projectCopy);
+    job.chains.push_back(std::move(chain));
+
+    const auto file = job.outputFile;
+    auto error = renderer.start(std::move(job));
+
+    if (error.isEmpty())
+    {
+        trackBeingFrozen = trackId;
+        outputFile = file;
+        clipHash = newClipHash;
+        chainHash = newChainHash;
+        startSample = rangeStart;
+    }
+
+    return error;
+}
+
+void TrackFreezer::unfreeze(const juce::String& trackId)
+{
+    TrackModel track(projectManager.getProject().findTrackById(trackId));
+
+    if (!track.isValid() || !track.isFrozen())
+        return;
+
+    auto file = track.getFreezeFile();
+    track.clearFrozen();
+
+    engine.forgetFile(file.getFullPathName());
+    pendingDeletions.addIfNotAlreadyThere(file.getFullPathName());
+    chainsKnown.removeString(trackId);
+
+    if (!isTimerRunning())
+        startTimer(deletionRetryIntervalMs);
+}
+
+void TrackFreezer::cancel()
+{
+    renderer.cancel();
+}
+
+//==============================================================================
+void TrackFreezer::renderFinished(bool success, const juce::String& message)
+{
+    auto trackId = trackBeingFrozen;
+    trackBeingFrozen.clear();
+
+    auto resultMessage = message;
+    TrackModel track(projectManager.getProject().findTrackById(trackId));
+
+    // Edited meanwhile: the render is of something that's gone. A plugin
+    // edit during the render reported its change while the track wasn't
+    // frozen yet, so it's compared here.
+    auto* trackChain = engine.getTrackInserts(trackId);
+
+    if (success && (!track.isValid() || track.computeClipHash() != clipHash
+                    || (trackChain != nullptr && computeChainHash(*trackChain) != chainHash)))
+    {
+        success = false;
+        resultMessage = "The track changed while it was being frozen";
+    }
+
+    if (success)
+    {
+        track.setFrozen(outputFile, startSample, clipHash, chainHash);
+        chainsKnown.addIfNotAlreadyThere(trackId);
+    }
+    else if (outputFile.exists() && !outputFile.deleteFile())
+    {
+        // Aborted (cancelled, the device changed, the track was edited):
+        // nothing of the render may be left to be taken for a freeze
+        pendingDeletions.addIfNotAlreadyThere(outputFile.getFullPathName());
+
+        if (!isTimerRunning())
+            startTimer(deletionRetryIntervalMs);
+    }
+
+    outputFile = juce::File();
+
+    if (onFinished != nullptr)
+        onFinished(trackId, success, success ? "Frozen to " + track.getFreezeFile().getFileName() : resultMessage);
+}
+
+//==============================================================================
+void TrackFreezer::timerCallback()
+{
+    for (int i = pendingDeletions.size(); --i >= 0;)
+    {
+        juce::File file(pendingDeletions[i]);
+
+        if (!file.exists() || file.deleteFile())
+            pendingDeletions.remove(i);
+    }
+
+    if (pendingDeletions.isEmpty())
+        stopTimer();
+}
+
+void TrackFreezer::projectChanged()
+{
+    // The track being frozen belongs to the last project
+    if (renderer.isRunning())
+        cancel();
+
+    chainsKnown.clear();
+    checkClips();
+}
+
+void TrackFreezer::clipAdded(const juce::ValueTree& clip)
+{
+    juce::ignoreUnused(clip);
+    checkClips();
+}
+
+void TrackFreezer::clipRemoved(const juce::ValueTree& clip)
+{
+    juce::ignoreUnused(clip);
+    checkClips();
+}
+
+void TrackFreezer::clipPropertyChanged(const juce::ValueTree& clip, const juce::Identifier& property)
+{
+    juce::ignoreUnused(property);
+
+    // Only the edited clip's track can have changed
+    TrackModel track(clip.getParent());
+    if (track.isValid() && track.isFrozen() && track.computeClipHash() != track.getFreezeClipHash())
+        unfreeze(track.getTrackId());
+}
+
+void TrackFreezer::checkClips()
+{
+    auto& project = projectManager.getProject();
+
+    for (int i = 0; i < project.getNumTracks(); ++i)
+    {
+        TrackModel track(project.getTrack(i));
+
+        if (!track.isFrozen())
+            continue;
+
+        if (!track.getFreezeFile().existsAsFile())
+            track.clearFrozen();
+        else if (track.computeClipHash() != track.getFreezeClipHash())
+            unfreeze(track.getTrackId());
+    }
+}
+
+void TrackFreezer::checkChain(const juce::String& trackId)
+{
+    TrackModel track(projectManager.getProject().findTrackById(trackId));
+
+    if (!track.isValid() || !track.isFrozen())
+        return;
+
+    auto* trackChain = engine.getTrackInserts(trackId);
+    if (trackChain == nullptr)
+        return;
+
+    if (trackChain->getNumPlugins() == 0 && !chainsKnown.contains(trackId))
+        return;
+
+    if (computeChainHash(*trackChain) != track.getFreezeChainHash())
+        unfreeze(trackId);
+}
+
+juce::String TrackFreezer::computeChainHash(EffectChain& effectChain)
+{
+    juce::MemoryBlock state;
+    effectChain.getStateInformation(state);
+    return TrackModel::hashOf(state);
+}
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    TrackFreezer.h
+
+    Track freeze: a track's clips are rendered offline through its insert
+    chain into a file in the project folder, and the track then plays that
+    file as a single streamed clip with its inserts switched off. The
+    render runs through OfflineRenderer from a private, offline copy of
+    the track, borrowing the live chain; the track plays dry until it's
+    done. A freeze that's cancelled, or that the device interrupts by
+    re-preparing the chain, leaves the track as it was and its file is
+    deleted.
+
+    The freeze is stored on the track (TrackModel::setFrozen), so it's
+    saved with the project, together with hashes of the clips and the
+    chain state it was rendered from. Editing the track's clips, or its
+    plugins' settings, unfreezes it and deletes the file.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "ProjectManager.h"
+#include "MultiTrackAudioSource.h"
+#include "OfflineRenderer.h"
+#include <functional>
+#include <memory>
+
+class TrackFreezer : private juce::Timer,
+                     private ProjectManager::Listener
+{
+public:
+    TrackFreezer(ProjectManager& projectManager, MultiTrackAudioSource& engine,
+                 juce::AudioFormatManager& formatManager);
+    ~TrackFreezer() override;
+
+    //==========================================================================
+    // Message thread. Starts freezing a track; returns an error message, or
+    // an empty string if the render has started. One track at a time.
+    juce::String freeze(const juce::String& trackId);
+
+    // Back to the live clips and inserts; the file is deleted
+    void unfreeze(const juce::String& trackId);
+
+    // The track is left as it was; onFinished is still called
+    void cancel();
+
+    bool isRunning() const { return renderer.isRunning(); }
+    const juce::String& getTrackBeingFrozen() const { return trackBeingFrozen; }
+
+    // 0 to 1
+    double getProgress() const { return renderer.getProgress(); }
+
+    // Message thread, when a freeze ends
+    std::function<void(const juce::String& trackId, bool success, const juce::String& message)> onFinished;
+
+    // Longest effect tail rendered after the last clip
+    static constexpr double maxTailSeconds = 10.0;
+
+    // Where a project's freeze files go: a Freeze folder next to the
+    // project file, or in the temp folder while it's unsaved
+    static juce::File getFreezeFolder(const juce::File& projectFile);
+
+private:
+    //==========================================================================
+    // Keeps the render if it completed and the track is still what it was
+    // rendered from; otherwise deletes the file
+    void renderFinished(bool success, const juce::String& message);
+    void timerCallback() override;  // Pending deletions
+
+    // ProjectManager::Listener
+    void projectChanged() override;
+    void clipAdded(const juce::ValueTree& clip) override;
+    void clipRemoved(const juce::ValueTree& clip) override;
+    void clipPropertyChanged(const juce::ValueTree& clip, const juce::Identifier& property) override;
+
+    // Unfreezes tracks whose clips, or (if it's known) insert chain, are no
+    // longer what they were rendered from, and forgets missing files. The
+    // chain is only hashed when it reports a change.
+    void checkClips();
+    void checkChain(const juce::String& trackId);
+
+    static juce::String computeChainHash(EffectChain& chain);
+
+    ProjectManager& projectManager;
+    MultiTrackAudioSource& engine;
+    juce::AudioFormatManager& formatManager;
+    juce::WavAudioFormat wavFormat;
+    OfflineRenderer renderer;
+
+    // Of the freeze running
+    juce::String trackBeingFrozen;
+    juce::File outputFile;
+    juce::String clipHash, chainHash;
+    juce::int64 startSample { 0 };
+
+    // Tracks frozen in this session, whose chain state is known. A loaded
+    // project's chains start empty (inserts aren't saved with projects),
+    // so those are only compared once plugins are added.
+    juce::StringArray chainsKnown;
+
+    // Files of unfrozen tracks; retried until they can be deleted (a clip
+    // may still have one open)
+    juce::StringArray pendingDeletions;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackFreezer)
+};
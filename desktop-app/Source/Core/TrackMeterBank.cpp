@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    TrackMeterBank.cpp
+
+    Lock-free track and master metering implementation
+
+  ==============================================================================
+*/
+
+#include "TrackMeterBank.h"
+#include <cmath>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+ #define SOUNDMAN_METER_NEON 1
+#endif
+
+//==============================================================================
+int TrackMeterBank::assign(const juce::String& trackId)
+{
+    auto existing = trackIndices.find(trackId);
+    if (existing != trackIndices.end())
+        return existing->second;
+
+    for (int i = 1; i <= maxTracks; ++i)
+    {
+        if (!inUse[static_cast<size_t>(i)])
+        {
+            // A plan still rendering the meter's last track may touch it
+            // until the next one is picked up; at worst a block's blip
+            inUse[static_cast<size_t>(i)] = true;
+            reset(i);
+            trackIndices[trackId] = i;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void TrackMeterBank::retainOnly(const juce::StringArray& trackIds)
+{
+    for (auto it = trackIndices.begin(); it != trackIndices.end();)
+    {
+        if (trackIds.contains(it->first))
+        {
+            ++it;
+            continue;
+        }
+
+        inUse[static_cast<size_t>(it->second)] = false;
+        it = trackIndices.erase(it);
+    }
+}
+
+//==============================================================================
+void TrackMeterBank::measure(int index, const juce::AudioBuffer<float>& buffer,
+                             int startSample, int numSamples) noexcept
+{
+    if (index < 0 || index > maxTracks || numSamples <= 0 || buffer.getNumChannels() == 0)
+        return;
+
+    auto& meter = meters[static_cast<size_t>(index)];
+
+    // Mean square follows each block's with a rmsWindowSeconds time constant
+    const float coefficient = static_cast<float>(std::exp(-numSamples / (rmsWindowSeconds * sampleRate)));
+
+    for (int side = 0; side < 2; ++side)
+    {
+        const int channel = juce::jmin(side, buffer.getNumChannels() - 1);
+        float blockPeak = 0.0f, sumOfSquares = 0.0f;
+
+        measureChannel(buffer.getReadPointer(channel, startSample), numSamples, blockPeak, sumOfSquares);
+
+        // The display thread zeroes the peak when it reads it
+        auto peak = meter.peak[side].load(std::memory_order_relaxed);
+        while (blockPeak > peak
+               && !meter.peak[side].compare_exchange_weak(peak, blockPeak, std::memory_order_relaxed))
+        {
+        }
+
+        const float blockMeanSquare = sumOfSquares / static_cast<float>(numSamples);
+        const float meanSquare = meter.meanSquare[side].load(std::memory_order_relaxed);
+        meter.meanSquare[side].store(blockMeanSquare + (meanSquare - blockMeanSquare) * coefficient,
+                                     std::memory_order_relaxed);
+    }
+}
+
+void TrackMeterBank::measureChannel(const float* data, int numSamples, float& peak, float& sumOfSquares) noexcept
+{
+    int i = 0;
+    float maxMagnitude = 0.0f, sum = 0.0f;
+
+   #if JUCE_INTEL
+    // Two accumulators per quantity so consecutive vectors don't wait on each other
+    const __m128 magnitudeMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 max0 = _mm_setzero_ps(), max1 = _mm_setzero_ps();
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m128 a = _mm_loadu_ps(data + i);
+        const __m128 b = _mm_loadu_ps(data + i + 4);
+
+        max0 = _mm_max_ps(max0, _mm_and_ps(a, magnitudeMask));
+        max1 = _mm_max_ps(max1, _mm_and_ps(b, magnitudeMask));
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+    }
+
+    alignas(16) float lanes[4];
+
+    _mm_store_ps(lanes, _mm_max_ps(max0, max1));
+    maxMagnitude = juce::jmax(juce::jmax(lanes[0], lanes[1]), juce::jmax(lanes[2], lanes[3]));
+
+    _mm_store_ps(lanes, _mm_add_ps(sum0, sum1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+   #elif SOUNDMAN_METER_NEON
+    float32x4_t max0 = vdupq_n_f32(0.0f), max1 = vdupq_n_f32(0.0f);
+    float32x4_t sum0 = vdupq_n_f32(0.0f), sum1 = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const float32x4_t a = vld1q_f32(data + i);
+        const float32x4_t b = vld1q_f32(data + i + 4);
+
+        max0 = vmaxq_f32(max0, vabsq_f32(a));
+        max1 = vmaxq_f32(max1, vabsq_f32(b));
+        sum0 = vmlaq_f32(sum0, a, a);
+        sum1 = vmlaq_f32(sum1, b, b);
+    }
+
+    float lanes[4];
+
+    vst1q_f32(lanes, vmaxq_f32(max0, max1));
+    maxMagnitude = juce::jmax(juce::jmax(lanes[0], lanes[1]), juce::jmax(lanes[2], lanes[3]));
+
+    vst1q_f32(lanes, vaddq_f32(sum0, sum1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+   #endif
+
+    for (; i < numSamples; ++i)
+    {
+        maxMagnitude = juce::jmax(maxMagnitude, std::abs(data[i]));
+        sum += data[i] * data[i];
+    }
+
+    peak = maxMagnitude;
+    sumOfSquares = sum;
+}
+
+//==============================================================================
+bool TrackMeterBank::getTrackLevels(const juce::String& trackId, Levels& levels)
+{
+    auto it = trackIndices.find(trackId);
+    if (it == trackIndices.end())
+        return false;
+
+    levels = read(it->second);
+    return true;
+}
+
+TrackMeterBank::Levels TrackMeterBank::read(int index) noexcept
+{
+    auto& meter = meters[static_cast<size_t>(index)];
+
+    Levels levels;
+    levels.peakLeft = meter.peak[0].exchange(0.0f, std::memory_order_relaxed);
+    levels.peakRight = meter.peak[1].exchange(0.0f, std::memory_order_relaxed);
+    levels.rmsLeft = std::sqrt(meter.meanSquare[0].load(std::memory_order_relaxed));
+    levels.rmsRight = std::sqrt(meter.meanSquare[1].load(std::memory_order_relaxed));
+    return levels;
+}
+
+void TrackMeterBank::reset(int index) noexcept
+{
+    auto& meter = meters[static_cast<size_t>(index)];
+
+    for (int side = 0; side < 2; ++side)
+    {
+        meter.peak[side].store(0.0f, std::memory_order_relaxed);
+        meter.meanSquare[side].store(0.0f, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    TrackMeterBank.h
+
+    Post-fader peak and RMS levels for every track and the master bus, in
+    one fixed array of lock-free meters. The audio thread (or the render
+    worker that produced a track) measures each block into the track's
+    meter; the mixer polls the array at display rate. Nothing is posted to
+    the message thread and no lock is taken on either side.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <map>
+
+class TrackMeterBank
+{
+public:
+    TrackMeterBank() = default;
+    ~TrackMeterBank() = default;
+
+    struct Levels
+    {
+        float peakLeft { 0.0f };   // Highest sample since the last read
+        float peakRight { 0.0f };
+        float rmsLeft { 0.0f };    // Over about rmsWindowSeconds
+        float rmsRight { 0.0f };
+    };
+
+    static constexpr int maxTracks = 256;
+    static constexpr int masterIndex = 0;  // Tracks use 1 to maxTracks
+    static constexpr double rmsWindowSeconds = 0.3;
+
+    //==========================================================================
+    // Message thread (plan compiles)
+
+    // The track's meter index, assigned on first use; -1 if all are taken
+    int assign(const juce::String& trackId);
+
+    // Frees the meters of tracks that aren't in trackIds
+    void retainOnly(const juce::StringArray& trackIds);
+
+    //==========================================================================
+    // Audio thread
+
+    // Not while measuring
+    void setSampleRate(double newSampleRate) noexcept { sampleRate = newSampleRate; }
+
+    // Measures [startSample, + numSamples) of the buffer (mono is metered on
+    // both sides). One thread per meter at a time.
+    void measure(int index, const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    //==========================================================================
+    // Message thread (display)
+
+    // Peaks since the last read of the meter, and the current RMS
+    bool getTrackLevels(const juce::String& trackId, Levels& levels);
+    Levels getMasterLevels() { return read(masterIndex); }
+
+    // Peak and sum of squares of numSamples floats
+    static void measureChannel(const float* data, int numSamples, float& peak, float& sumOfSquares) noexcept;
+
+private:
+    //==========================================================================
+    // A cache line each, so tracks rendered on different workers don't
+    // contend for one
+    struct alignas(64) Meter
+    {
+        std::atomic<float> peak[2] {};
+        std::atomic<float> meanSquare[2] {};  // Smoothed; written by the measuring thread only
+    };
+
+    std::array<Meter, maxTracks + 1> meters;
+    double sampleRate { 44100.0 };
+
+    std::map<juce::String, int> trackIndices;
+    std::array<bool, maxTracks + 1> inUse {};
+
+    Levels read(int index) noexcept;
+    void reset(int index) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackMeterBank)
+};
@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    TrackRenderPool.cpp
+
+    Parallel block rendering implementation
+
+  ==============================================================================
+*/
+
+#include "TrackRenderPool.h"
+#include "RealtimeSafety.h"
+#include <thread>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr double spinTimeMs = 1.0;  // Busy-wait after the last task before sleeping
+    constexpr int idleWaitMs = 100;
+    constexpr int maxDefaultWorkers = 7;
+
+    inline void pauseBriefly() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #else
+        std::this_thread::yield();
+       #endif
+    }
+}
+
+//==============================================================================
+class TrackRenderPool::Worker : public juce::Thread
+{
+public:
+    Worker(TrackRenderPool& owner, int index)
+        : juce::Thread("Track Render " + juce::String(index + 1)),
+          pool(owner)
+    {
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeEvent.signal();
+        stopThread(2000);
+    }
+
+    void run() override
+    {
+        auto lastTaskTime = juce::Time::getMillisecondCounterHiRes();
+
+        while (!threadShouldExit())
+        {
+            bool performed = false;
+
+            {
+                RealtimeSafety::ScopedRealtimeContext realtimeContext;
+                performed = pool.performTasks();
+            }
+
+            auto now = juce::Time::getMillisecondCounterHiRes();
+
+            if (performed || now - lastTaskTime < spinTimeMs)
+            {
+                if (performed)
+                    lastTaskTime = now;
+
+                pauseBriefly();
+                continue;
+            }
+
+            // Idle: sleep until run() wakes us. Checking again after
+            // announcing it means a run published meanwhile isn't missed.
+            sleeping.store(true);
+
+            if (!pool.hasUnclaimedTasks())
+                wakeEvent.wait(idleWaitMs);
+
+            sleeping.store(false);
+            lastTaskTime = juce::Time::getMillisecondCounterHiRes();
+        }
+    }
+
+    void wake() noexcept
+    {
+        if (sleeping.load())
+        {
+            // Signalling takes the event's mutex; uncontended, and only
+            // needed when a worker has been idle for spinTimeMs
+            RealtimeSafety::ScopedAllowance allowance;
+            wakeEvent.signal();
+        }
+    }
+
+private:
+    TrackRenderPool& pool;
+    std::atomic<bool> sleeping { false };
+    juce::WaitableEvent wakeEvent;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+TrackRenderPool::TrackRenderPool(int numWorkers)
+{
+    const int numCpus = juce::SystemStats::getNumCpus();
+
+    if (numWorkers < 0)
+        numWorkers = juce::jlimit(0, maxDefaultWorkers, numCpus - 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i));
+
+        // Not pinned: the audio thread isn't either, so no core is known
+        // to be free of it, and the scheduler can move a worker off a busy one
+        if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions{}))
+            worker->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+TrackRenderPool::~TrackRenderPool()
+{
+    // Workers stop in their destructors
+    workers.clear();
+}
+
+//==============================================================================
+void TrackRenderPool::run(Job& job, int numTasks) noexcept
+{
+    if (numTasks <= 0)
+        return;
+
+    if (workers.isEmpty() || numTasks == 1 || numTasks > maxTasks)
+    {
+        for (int i = 0; i < numTasks; ++i)
+            job.perform(i);
+
+        return;
+    }
+
+    // Every task of the previous run finished before it returned, so
+    // nothing else touches these until the claim word below is published
+    currentJob.store(&job, std::memory_order_relaxed);
+    tasksDone.store(0, std::memory_order_relaxed);
+
+    const auto generation = (claim.load(std::memory_order_relaxed) >> 32) + 1;
+    claim.store((generation << 32) | ((juce::uint64)numTasks << 16));
+
+    for (auto* worker : workers)
+        worker->wake();
+
+    // Take tasks ourselves, then wait for the ones still on workers
+    performTasks();
+
+    while (tasksDone.load(std::memory_order_acquire) < numTasks)
+        pauseBriefly();
+}
+
+bool TrackRenderPool::performTasks() noexcept
+{
+    bool performedAny = false;
+    auto current = claim.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto index = (int)(current & 0xffff);
+        const auto count = (int)((current >> 16) & 0xffff);
+
+        if (index >= count)
+            return performedAny;
+
+        // A claimed index below the count means its run hasn't returned,
+        // so currentJob is still that run's job
+        if (claim.compare_exchange_weak(current, current + 1,
+                                        std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            currentJob.load(std::memory_order_acquire)->perform(index);
+            tasksDone.fetch_add(1, std::memory_order_release);
+            performedAny = true;
+
+            current = claim.load(std::memory_order_acquire);
+        }
+    }
+}
+
+bool TrackRenderPool::hasUnclaimedTasks() const noexcept
+{
+    const auto current = claim.load();
+    return (int)(current & 0xffff) < (int)((current >> 16) & 0xffff);
+}
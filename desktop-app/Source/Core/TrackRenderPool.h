@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    TrackRenderPool.h
+
+    Pre-spawned worker threads that help the audio thread render a block's
+    independent tasks (tracks) in parallel. The caller publishes a job with
+    a task count; the workers and the caller itself claim task indices from
+    one shared atomic counter until none are left, so a worker that wakes
+    late simply takes fewer tasks. run() returns once every task is done,
+    though: a worker preempted in the middle of a task holds the block up
+    until it gets the CPU back. That's why workers are real-time threads,
+    scheduled like the audio thread rather than by the OS's fair share.
+
+    The audio-thread side takes no locks and allocates nothing. Workers
+    spin for a short while after their last task, so during playback they
+    are normally awake for the next block; only one that has gone to sleep
+    needs an event signalled.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+class TrackRenderPool
+{
+public:
+    //==========================================================================
+    class Job
+    {
+    public:
+        virtual ~Job() = default;
+
+        // Called once per index, on the audio thread or a worker
+        virtual void perform(int taskIndex) noexcept = 0;
+    };
+
+    // Most tasks one run() takes
+    static constexpr int maxTasks = 0xffff;
+
+    // numWorkers < 0 picks one per CPU core beyond the audio thread's, up
+    // to 7; 0 makes every run() serial
+    explicit TrackRenderPool(int numWorkers = -1);
+    ~TrackRenderPool();
+
+    //==========================================================================
+    // Performs job for every index in [0, numTasks) and returns when all are
+    // done. One caller at a time (the audio thread). Real-time safe.
+    void run(Job& job, int numTasks) noexcept;
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+private:
+    //==========================================================================
+    class Worker;
+
+    // Claims and performs tasks of the current run until none are left.
+    // Returns true if it performed any.
+    bool performTasks() noexcept;
+    bool hasUnclaimedTasks() const noexcept;
+
+    // generation << 32 | numTasks << 16 | next index. One word, so a worker
+    // still looking at an old run can never claim a task of a new one.
+    std::atomic<juce::uint64> claim { 0 };
+    std::atomic<Job*> currentJob { nullptr };
+    std::atomic<int> tasksDone { 0 };
+
+    juce::OwnedArray<Worker> workers;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackRenderPool)
+};
@@ -180,166 +180,166 @@ void AudioFilter::getMagnitudeForFrequencyArray(const float* frequencies, float*
 ParametricEQ::ParametricEQ()
 {
     // Initialize default band frequencies
-    bands[0] = { 100.0f, 0.0f, 1.0f, true };   // Low band
-    bands[1] = { 1000.0f, 0.0f, 1.0f, true };  // Mid band
-    bands[2] = { 8000.0f, 0.0f, 1.0f, true };  // High band
-
-    for (int i = 0; i < numBands; ++i)
-    {
-        bandCoefficients[i] = Coefficients::makePeakFilter(44100.0, bands[i].frequency,
-                                                            bands[i].q, 1.0f);
-    }
+    bandParameters[0].frequency = 100.0f;    // Low band
+    bandParameters[1].frequency = 1000.0f;   // Mid band
+    bandParameters[2].frequency = 8000.0f;   // High band
 }
 
 void ParametricEQ::prepare(double rate, int samplesPerBlock, int numChannels)
 {
     sampleRate = rate;
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = rate;
-    spec.maximumBlockSize = (juce::uint32)samplesPerBlock;
-    spec.numChannels = (juce::uint32)numChannels;
+    cascade.prepare(numChannels, samplesPerBlock);
 
-    for (int band = 0; band < numBands; ++band)
-    {
-        for (auto& filter : bandFilters[band])
-        {
-            filter.prepare(spec);
-        }
-        updateBandCoefficients(band);
-    }
+    // Straight to the current settings
+    BandCoefficients coefficients;
+    appliedVersion = parameterVersion.load();
+    const int numBands = getCoefficients(coefficients);
+    cascade.setTargets(coefficients.data(), numBands, 0);
 
     isPrepared = true;
 }
 
 void ParametricEQ::reset()
 {
-    for (int band = 0; band < numBands; ++band)
-    {
-        for (auto& filter : bandFilters[band])
-        {
-            filter.reset();
-        }
-    }
+    cascade.reset();
+}
+
+void ParametricEQ::setNumBands(int numBands)
+{
+    numActiveBands = juce::jlimit(1, maxBands, numBands);
+    bandChanged();
 }
 
 void ParametricEQ::setBand(int bandIndex, float frequency, float gainDb, float q)
 {
-    if (bandIndex < 0 || bandIndex >= numBands)
+    if (!isValidBand(bandIndex))
         return;
 
-    bands[bandIndex].frequency = juce::jlimit(20.0f, 20000.0f, frequency);
-    bands[bandIndex].gain = juce::jlimit(-24.0f, 24.0f, gainDb);
-    bands[bandIndex].q = juce::jlimit(0.1f, 10.0f, q);
+    auto& band = bandParameters[(size_t)bandIndex];
+    band.frequency = juce::jlimit(20.0f, 20000.0f, frequency);
+    band.gain = juce::jlimit(-24.0f, 24.0f, gainDb);
+    band.q = juce::jlimit(0.1f, 10.0f, q);
 
-    updateBandCoefficients(bandIndex);
+    bandChanged();
 }
 
 void ParametricEQ::setBandFrequency(int bandIndex, float freq)
 {
-    if (bandIndex < 0 || bandIndex >= numBands)
+    if (!isValidBand(bandIndex))
         return;
 
-    bands[bandIndex].frequency = juce::jlimit(20.0f, 20000.0f, freq);
-    updateBandCoefficients(bandIndex);
+    bandParameters[(size_t)bandIndex].frequency = juce::jlimit(20.0f, 20000.0f, freq);
+    bandChanged();
 }
 
 void ParametricEQ::setBandGain(int bandIndex, float gain)
 {
-    if (bandIndex < 0 || bandIndex >= numBands)
+    if (!isValidBand(bandIndex))
         return;
 
-    bands[bandIndex].gain = juce::jlimit(-24.0f, 24.0f, gain);
-    updateBandCoefficients(bandIndex);
+    bandParameters[(size_t)bandIndex].gain = juce::jlimit(-24.0f, 24.0f, gain);
+    bandChanged();
 }
 
 void ParametricEQ::setBandQ(int bandIndex, float q)
 {
-    if (bandIndex < 0 || bandIndex >= numBands)
+    if (!isValidBand(bandIndex))
         return;
 
-    bands[bandIndex].q = juce::jlimit(0.1f, 10.0f, q);
-    updateBandCoefficients(bandIndex);
+    bandParameters[(size_t)bandIndex].q = juce::jlimit(0.1f, 10.0f, q);
+    bandChanged();
 }
 
 void ParametricEQ::setBandEnabled(int bandIndex, bool enabled)
 {
-    if (bandIndex < 0 || bandIndex >= numBands)
+    if (!isValidBand(bandIndex))
         return;
 
-    bands[bandIndex].enabled = enabled;
+    bandParameters[(size_t)bandIndex].enabled = enabled;
+    bandChanged();
 }
 
 ParametricEQ::Band ParametricEQ::getBand(int bandIndex) const
 {
-    if (bandIndex < 0 || bandIndex >= numBands)
+    if (!isValidBand(bandIndex))
         return Band();
 
-    return bands[bandIndex];
+    const auto& band = bandParameters[(size_t)bandIndex];
+    return { band.frequency.load(), band.gain.load(), band.q.load(), band.enabled.load() };
 }
 
-void ParametricEQ::updateBandCoefficients(int bandIndex)
+//==============================================================================
+int ParametricEQ::getCoefficients(BandCoefficients& coefficients) const
 {
-    if (bandIndex < 0 || bandIndex >= numBands)
-        return;
+    const int numBands = numActiveBands.load();
 
-    const auto& band = bands[bandIndex];
-    float gainLinear = juce::Decibels::decibelsToGain(band.gain);
+    for (int i = 0; i < numBands; ++i)
+        coefficients[(size_t)i] = makePeakCoefficients(getBand(i), sampleRate);
 
-    bandCoefficients[bandIndex] = Coefficients::makePeakFilter(
-        sampleRate, band.frequency, band.q, gainLinear);
+    return numBands;
+}
 
-    for (auto& filter : bandFilters[bandIndex])
-    {
-        *filter.coefficients = *bandCoefficients[bandIndex];
-    }
+BiquadCascade::Coefficients ParametricEQ::makePeakCoefficients(const Band& band, double rate)
+{
+    if (!band.enabled || band.gain == 0.0f)
+        return {};
+
+    // As juce::dsp::IIR::Coefficients::makePeakFilter, in double, below Nyquist
+    const double frequency = juce::jmin((double)band.frequency, rate * 0.49);
+    const double A = std::pow(10.0, band.gain / 40.0);
+    const double omega = juce::MathConstants<double>::twoPi * frequency / rate;
+    const double alpha = std::sin(omega) / (2.0 * band.q);
+    const double c2 = -2.0 * std::cos(omega);
+
+    const double a0 = 1.0 + alpha / A;
+
+    BiquadCascade::Coefficients c;
+    c.b0 = (1.0 + alpha * A) / a0;
+    c.b1 = c2 / a0;
+    c.b2 = (1.0 - alpha * A) / a0;
+    c.a1 = c2 / a0;
+    c.a2 = (1.0 - alpha / A) / a0;
+    return c;
 }
 
+//==============================================================================
 void ParametricEQ::process(juce::AudioBuffer<float>& buffer)
 {
     if (!eqEnabled || !isPrepared)
         return;
 
-    for (int channel = 0; channel < buffer.getNumChannels() && channel < 2; ++channel)
-    {
-        auto* channelData = buffer.getWritePointer(channel);
+    juce::ScopedNoDenormals noDenormals;
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            float value = channelData[sample];
+    // Bands changed since the last block: glide to them
+    const auto version = parameterVersion.load();
 
-            for (int band = 0; band < numBands; ++band)
-            {
-                if (bands[band].enabled)
-                {
-                    value = bandFilters[band][channel].processSample(value);
-                }
-            }
+    if (version != appliedVersion)
+    {
+        appliedVersion = version;
 
-            channelData[sample] = value;
-        }
+        BandCoefficients coefficients;
+        const int numBands = getCoefficients(coefficients);
+        cascade.setTargets(coefficients.data(), numBands, juce::roundToInt(sampleRate * coefficientGlideSeconds));
     }
+
+    cascade.process(buffer, 0, buffer.getNumSamples());
 }
 
 float ParametricEQ::getMagnitudeForFrequency(float freq) const
 {
-    float totalMagnitude = 1.0f;
-
-    for (int band = 0; band < numBands; ++band)
-    {
-        if (bands[band].enabled && bandCoefficients[band] != nullptr)
-        {
-            totalMagnitude *= bandCoefficients[band]->getMagnitudeForFrequency(freq, sampleRate);
-        }
-    }
-
-    return totalMagnitude;
+    float magnitude = 1.0f;
+    getMagnitudeForFrequencyArray(&freq, &magnitude, 1);
+    return magnitude;
 }
 
 void ParametricEQ::getMagnitudeForFrequencyArray(const float* frequencies, float* magnitudes, int numPoints) const
 {
     for (int i = 0; i < numPoints; ++i)
-    {
-        magnitudes[i] = getMagnitudeForFrequency(frequencies[i]);
-    }
+        magnitudes[i] = 1.0f;
+
+    BandCoefficients coefficients;
+    const int numBands = getCoefficients(coefficients);
+
+    BiquadCascade::applyMagnitudes(coefficients.data(), numBands, sampleRate, frequencies, magnitudes, numPoints);
 }
@@ -12,7 +12,9 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <juce_core/juce_core.h>
+#include "BiquadCascade.h"
 #include <array>
+#include <atomic>
 
 class AudioFilter
 {
@@ -88,7 +90,10 @@ class AudioFilter
 
 //==============================================================================
 /**
-    3-Band Parametric EQ
+    N-band parametric EQ: up to maxBands peak filters in series, run by a
+    BiquadCascade. Bands can be set from any thread; the audio thread picks
+    the change up at its next block and glides to it over
+    coefficientGlideSeconds, so dragging a control doesn't zipper.
 */
 class ParametricEQ
 {
@@ -102,6 +107,10 @@ class ParametricEQ
         bool enabled { true };
     };
 
+    static constexpr int maxBands = BiquadCascade::maxStages;
+    static constexpr int defaultNumBands = 3;
+    static constexpr double coefficientGlideSeconds = 0.02;
+
     //==========================================================================
     ParametricEQ();
     ~ParametricEQ() = default;
@@ -113,6 +122,12 @@ class ParametricEQ
 
     //==========================================================================
     // Band parameters
+
+    // Bands in use, 1 to maxBands. The first three start at 100 Hz, 1 kHz
+    // and 8 kHz, the rest at 1 kHz; all flat.
+    void setNumBands(int numBands);
+    int getNumBands() const { return numActiveBands.load(); }
+
     void setBand(int bandIndex, float frequency, float gainDb, float q);
     void setBandFrequency(int bandIndex, float freq);
     void setBandGain(int bandIndex, float gainDb);
@@ -120,7 +135,6 @@ class ParametricEQ
     void setBandEnabled(int bandIndex, bool enabled);
 
     Band getBand(int bandIndex) const;
-    static constexpr int numBands = 3;
 
     //==========================================================================
     // Master
@@ -132,22 +146,40 @@ class ParametricEQ
     void process(juce::AudioBuffer<float>& buffer);
 
     //==========================================================================
-    // Get frequency response for visualization
+    // Get frequency response for visualization (from the bands as set,
+    // not as far as the audio thread has glided)
     float getMagnitudeForFrequency(float freq) const;
     void getMagnitudeForFrequencyArray(const float* frequencies, float* magnitudes, int numPoints) const;
 
 private:
     //==========================================================================
-    void updateBandCoefficients(int bandIndex);
+    using BandCoefficients = std::array<BiquadCascade::Coefficients, maxBands>;
+
+    // The bands in use; returns how many
+    int getCoefficients(BandCoefficients& coefficients) const;
+
+    // A band's peak filter; a pass through while it's disabled
+    static BiquadCascade::Coefficients makePeakCoefficients(const Band& band, double sampleRate);
+
+    bool isValidBand(int bandIndex) const { return bandIndex >= 0 && bandIndex < maxBands; }
+    void bandChanged() { parameterVersion.fetch_add(1); }
 
     //==========================================================================
-    using Filter = juce::dsp::IIR::Filter<float>;
-    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+    struct BandParameters
+    {
+        std::atomic<float> frequency { 1000.0f };
+        std::atomic<float> gain { 0.0f };
+        std::atomic<float> q { 1.0f };
+        std::atomic<bool> enabled { true };
+    };
+
+    std::array<BandParameters, maxBands> bandParameters;
+    std::atomic<int> numActiveBands { defaultNumBands };
+    std::atomic<juce::uint32> parameterVersion { 1 };
 
-    // 3 bands x 2 channels
-    std::array<std::array<Filter, 2>, numBands> bandFilters;
-    std::array<typename Coefficients::Ptr, numBands> bandCoefficients;
-    std::array<Band, numBands> bands;
+    // Audio thread
+    BiquadCascade cascade;
+    juce::uint32 appliedVersion { 0 };
 
     bool eqEnabled { true };
     double sampleRate { 44100.0 };
@@ -0,0 +1,308 @@
+/*
+  ==============================================================================
+
+    BiquadCascade.cpp
+
+    SIMD biquad cascade implementation
+
+  ==============================================================================
+*/
+
+#include "BiquadCascade.h"
+#include <cmath>
+#include <vector>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #define SOUNDMAN_BIQUAD_SSE 1
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+ #define SOUNDMAN_BIQUAD_NEON 1
+#endif
+
+namespace
+{
+    //==========================================================================
+    // Four lanes of floats
+   #if SOUNDMAN_BIQUAD_SSE
+    using Vec = __m128;
+
+    inline Vec load(const float* p) noexcept             { return _mm_loadu_ps(p); }
+    inline void store(float* p, Vec v) noexcept          { _mm_storeu_ps(p, v); }
+    inline Vec broadcast(float x) noexcept               { return _mm_set1_ps(x); }
+    inline Vec add(Vec a, Vec b) noexcept                { return _mm_add_ps(a, b); }
+    inline Vec sub(Vec a, Vec b) noexcept                { return _mm_sub_ps(a, b); }
+    inline Vec mul(Vec a, Vec b) noexcept                { return _mm_mul_ps(a, b); }
+   #elif SOUNDMAN_BIQUAD_NEON
+    using Vec = float32x4_t;
+
+    inline Vec load(const float* p) noexcept             { return vld1q_f32(p); }
+    inline void store(float* p, Vec v) noexcept          { vst1q_f32(p, v); }
+    inline Vec broadcast(float x) noexcept               { return vdupq_n_f32(x); }
+    inline Vec add(Vec a, Vec b) noexcept                { return vaddq_f32(a, b); }
+    inline Vec sub(Vec a, Vec b) noexcept                { return vsubq_f32(a, b); }
+    inline Vec mul(Vec a, Vec b) noexcept                { return vmulq_f32(a, b); }
+   #else
+    struct Vec { float v[BiquadCascade::lanes]; };
+
+    inline Vec load(const float* p) noexcept             { Vec r; for (int i = 0; i < 4; ++i) r.v[i] = p[i]; return r; }
+    inline void store(float* p, Vec a) noexcept          { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+    inline Vec broadcast(float x) noexcept               { return { { x, x, x, x } }; }
+    inline Vec add(Vec a, Vec b) noexcept                { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+    inline Vec sub(Vec a, Vec b) noexcept                { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+    inline Vec mul(Vec a, Vec b) noexcept                { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+   #endif
+
+    constexpr std::array<float, 5> passThrough { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+    //==========================================================================
+    // One stage over a group's interleaved block, in place
+    template <bool ramping>
+    void runStage(float* data, int numSamples, float* stageState,
+                  const std::array<float, 5>& c, const std::array<float, 5>& dc) noexcept
+    {
+        auto b0 = broadcast(c[0]), b1 = broadcast(c[1]), b2 = broadcast(c[2]);
+        auto a1 = broadcast(c[3]), a2 = broadcast(c[4]);
+
+        auto db0 = broadcast(dc[0]), db1 = broadcast(dc[1]), db2 = broadcast(dc[2]);
+        auto da1 = broadcast(dc[3]), da2 = broadcast(dc[4]);
+
+        auto z1 = load(stageState);
+        auto z2 = load(stageState + BiquadCascade::lanes);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = data + i * BiquadCascade::lanes;
+
+            const auto x = load(frame);
+            const auto y = add(mul(b0, x), z1);
+
+            z1 = add(sub(mul(b1, x), mul(a1, y)), z2);
+            z2 = sub(mul(b2, x), mul(a2, y));
+
+            store(frame, y);
+
+            if (ramping)
+            {
+                b0 = add(b0, db0); b1 = add(b1, db1); b2 = add(b2, db2);
+                a1 = add(a1, da1); a2 = add(a2, da2);
+            }
+        }
+
+        store(stageState, z1);
+        store(stageState + BiquadCascade::lanes, z2);
+    }
+}
+
+//==============================================================================
+void BiquadCascade::prepare(int channels, int maxBlockSize)
+{
+    numChannels = juce::jmax(0, channels);
+    numGroups = (numChannels + lanes - 1) / lanes;
+    blockSize = juce::jmax(1, maxBlockSize);
+
+    scratch.allocate(static_cast<size_t>(blockSize * lanes), true);
+    state.allocate(static_cast<size_t>(juce::jmax(1, numGroups) * maxStages * 2 * lanes), true);
+
+    current.fill(passThrough);
+    target.fill(passThrough);
+    step.fill({});
+
+    numStagesRun = 0;
+    numStagesTarget = 0;
+    rampRemaining = 0;
+}
+
+void BiquadCascade::reset() noexcept
+{
+    if (state != nullptr)
+        juce::FloatVectorOperations::clear(state.get(), juce::jmax(1, numGroups) * maxStages * 2 * lanes);
+}
+
+//==============================================================================
+void BiquadCascade::setTargets(const Coefficients* coefficients, int numStages, int rampSamples) noexcept
+{
+    numStages = juce::jlimit(0, maxStages, numStages);
+
+    for (int s = 0; s < maxStages; ++s)
+    {
+        if (s < numStages)
+        {
+            const auto& c = coefficients[s];
+            target[static_cast<size_t>(s)] = { static_cast<float>(c.b0), static_cast<float>(c.b1), static_cast<float>(c.b2),
+                                               static_cast<float>(c.a1), static_cast<float>(c.a2) };
+        }
+        else
+        {
+            target[static_cast<size_t>(s)] = passThrough;
+        }
+    }
+
+    numStagesTarget = numStages;
+    numStagesRun = juce::jmax(numStagesRun, numStages);
+
+    if (rampSamples <= 0)
+    {
+        finishGlide();
+        return;
+    }
+
+    // From wherever the last glide had got to
+    for (int s = 0; s < numStagesRun; ++s)
+    {
+        for (size_t k = 0; k < 5; ++k)
+            step[static_cast<size_t>(s)][k] = (target[static_cast<size_t>(s)][k] - current[static_cast<size_t>(s)][k]) / static_cast<float>(rampSamples);
+    }
+
+    rampRemaining = rampSamples;
+}
+
+void BiquadCascade::advance(int numSamples) noexcept
+{
+    rampRemaining -= numSamples;
+
+    if (rampRemaining > 0)
+    {
+        for (int s = 0; s < numStagesRun; ++s)
+        {
+            for (size_t k = 0; k < 5; ++k)
+                current[static_cast<size_t>(s)][k] += step[static_cast<size_t>(s)][k] * static_cast<float>(numSamples);
+        }
+
+        return;
+    }
+
+    finishGlide();
+}
+
+void BiquadCascade::finishGlide() noexcept
+{
+    // Exactly on target; stages that have glided out stop, with their
+    // state cleared for when they're next used
+    rampRemaining = 0;
+    current = target;
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        for (int s = numStagesTarget; s < numStagesRun; ++s)
+            juce::FloatVectorOperations::clear(getStageState(group, s), 2 * lanes);
+    }
+
+    numStagesRun = numStagesTarget;
+}
+
+float* BiquadCascade::getStageState(int group, int stage) const noexcept
+{
+    return state.get() + (group * maxStages + stage) * 2 * lanes;
+}
+
+//==============================================================================
+void BiquadCascade::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (numStagesRun == 0 || numGroups == 0)
+        return;
+
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+    float* data = scratch.get();
+
+    for (int done = 0; done < numSamples;)
+    {
+        // The rest of a glide first, then the targets
+        const bool ramping = rampRemaining > 0;
+        int count = juce::jmin(blockSize, numSamples - done);
+
+        if (ramping)
+            count = juce::jmin(count, rampRemaining);
+
+        for (int group = 0; group * lanes < channels; ++group)
+        {
+            // Channels into lanes; missing ones run on silence
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const int channel = group * lanes + lane;
+
+                if (channel < channels)
+                {
+                    const float* source = buffer.getReadPointer(channel, startSample + done);
+
+                    for (int i = 0; i < count; ++i)
+                        data[i * lanes + lane] = source[i];
+                }
+                else
+                {
+                    for (int i = 0; i < count; ++i)
+                        data[i * lanes + lane] = 0.0f;
+                }
+            }
+
+            // A stage at a time over the block; every group starts from
+            // the same point of the glide
+            for (int s = 0; s < numStagesRun; ++s)
+            {
+                const auto index = static_cast<size_t>(s);
+
+                if (ramping)
+                    runStage<true>(data, count, getStageState(group, s), current[index], step[index]);
+                else
+                    runStage<false>(data, count, getStageState(group, s), current[index], step[index]);
+            }
+
+            for (int lane = 0; lane < lanes && group * lanes + lane < channels; ++lane)
+            {
+                float* destination = buffer.getWritePointer(group * lanes + lane, startSample + done);
+
+                for (int i = 0; i < count; ++i)
+                    destination[i] = data[i * lanes + lane];
+            }
+        }
+
+        if (ramping)
+            advance(count);
+
+        done += count;
+    }
+}
+
+//==============================================================================
+void BiquadCascade::applyMagnitudes(const Coefficients* stages, int numStages, double sampleRate,
+                                    const float* frequencies, float* magnitudes, int numPoints)
+{
+    if (numStages <= 0 || numPoints <= 0 || sampleRate <= 0.0)
+        return;
+
+    // |H|^2 of a biquad, with c = cos w:
+    // (b0^2 + b1^2 + b2^2 + 2(b0 b1 + b1 b2) c + 2 b0 b2 cos 2w) /
+    // (1 + a1^2 + a2^2 + 2(a1 + a1 a2) c + 2 a2 cos 2w)
+    std::vector<double> cosW(static_cast<size_t>(numPoints));
+    std::vector<double> power(static_cast<size_t>(numPoints), 1.0);
+
+    const double radiansPerHz = juce::MathConstants<double>::twoPi / sampleRate;
+
+    for (size_t i = 0; i < cosW.size(); ++i)
+        cosW[i] = std::cos(radiansPerHz * frequencies[i]);
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        const auto& c = stages[s];
+
+        const double n0 = c.b0 * c.b0 + c.b1 * c.b1 + c.b2 * c.b2;
+        const double n1 = 2.0 * (c.b0 * c.b1 + c.b1 * c.b2);
+        const double n2 = 2.0 * c.b0 * c.b2;
+
+        const double d0 = 1.0 + c.a1 * c.a1 + c.a2 * c.a2;
+        const double d1 = 2.0 * (c.a1 + c.a1 * c.a2);
+        const double d2 = 2.0 * c.a2;
+
+        const double* cw = cosW.data();
+        double* p = power.data();
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const double cos2w = 2.0 * cw[i] * cw[i] - 1.0;
+            p[i] *= (n0 + n1 * cw[i] + n2 * cos2w) / (d0 + d1 * cw[i] + d2 * cos2w);
+        }
+    }
+
+    for (int i = 0; i < numPoints; ++i)
+        magnitudes[i] *= static_cast<float>(std::sqrt(power[static_cast<size_t>(i)]));
+}
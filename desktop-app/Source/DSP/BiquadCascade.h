@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    BiquadCascade.h
+
+    Up to maxStages biquads in series over any number of channels, in
+    transposed direct form II. Channels are processed four at a time in
+    SIMD lanes (SSE or NEON, scalar otherwise), one stage at a time over
+    the block, so each stage's coefficients and state stay in registers.
+
+    New coefficients aren't switched to: every stage glides to them
+    linearly, per sample, over a given number of samples, so dragging a
+    control doesn't zipper. Stages dropped from the end glide to a pass
+    through before they're skipped.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+
+class BiquadCascade
+{
+public:
+    BiquadCascade() = default;
+    ~BiquadCascade() = default;
+
+    // Normalised (a0 = 1); the default passes the signal through
+    struct Coefficients
+    {
+        double b0 { 1.0 }, b1 { 0.0 }, b2 { 0.0 };
+        double a1 { 0.0 }, a2 { 0.0 };
+    };
+
+    static constexpr int maxStages = 32;
+    static constexpr int lanes = 4;  // Channels per SIMD register
+
+    //==========================================================================
+    // Not on the audio thread. Allocates for numChannels and blocks of up
+    // to maxBlockSize (longer ones are processed in pieces); clears the
+    // state and puts every stage at a pass through.
+    void prepare(int numChannels, int maxBlockSize);
+
+    //==========================================================================
+    // Audio thread
+
+    // Glides the first numStages stages to the given coefficients over
+    // rampSamples (0 jumps there), and any after them to a pass through
+    void setTargets(const Coefficients* coefficients, int numStages, int rampSamples) noexcept;
+
+    // Filters [startSample, + numSamples) in place. Channels beyond the
+    // prepared count are left alone.
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    void reset() noexcept;
+
+    bool isRamping() const noexcept { return rampRemaining > 0; }
+
+    //==========================================================================
+    // Any thread. Multiplies each magnitude by the cascade's gain at that
+    // frequency: the cosines are shared by every stage, and each stage is
+    // one pass over the points that the compiler vectorises.
+    static void applyMagnitudes(const Coefficients* stages, int numStages, double sampleRate,
+                                const float* frequencies, float* magnitudes, int numPoints);
+
+private:
+    //==========================================================================
+    // b0, b1, b2, a1, a2
+    using StageCoefficients = std::array<float, 5>;
+
+    // Moves the glide on by numSamples; at its end, everything is on
+    // target and stages glided out stop
+    void advance(int numSamples) noexcept;
+    void finishGlide() noexcept;
+
+    float* getStageState(int group, int stage) const noexcept;
+
+    std::array<StageCoefficients, maxStages> current {};
+    std::array<StageCoefficients, maxStages> target {};
+    std::array<StageCoefficients, maxStages> step {};     // Per sample while ramping
+
+    int numStagesRun { 0 };        // Including stages still gliding out
+    int numStagesTarget { 0 };
+    int rampRemaining { 0 };
+
+    int numChannels { 0 };
+    int numGroups { 0 };
+    int blockSize { 0 };
+
+    // One group's block, interleaved a lane per channel
+    juce::HeapBlock<float> scratch;
+
+    // z1 and z2 lanes per group and stage
+    juce::HeapBlock<float> state;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BiquadCascade)
+};
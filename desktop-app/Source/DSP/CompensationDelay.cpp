@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    CompensationDelay.cpp
+
+    Latency compensation delay line implementation
+
+  ==============================================================================
+*/
+
+#include "CompensationDelay.h"
+
+//==============================================================================
+void CompensationDelay::prepare(int numChannels, int maxDelaySamples, int maxBlockSize)
+{
+    maxDelay = juce::jmax(0, maxDelaySamples);
+
+    // Room for the longest delay plus the block being written
+    const int capacity = juce::nextPowerOfTwo(juce::jmax(1, maxDelay + juce::jmax(1, maxBlockSize)));
+
+    history.setSize(juce::jmax(1, numChannels), capacity);
+    mask = capacity - 1;
+    clear();
+}
+
+void CompensationDelay::release()
+{
+    history.setSize(0, 0);
+    mask = 0;
+    maxDelay = 0;
+    writePosition = 0;
+}
+
+void CompensationDelay::clear() noexcept
+{
+    history.clear();
+    writePosition = 0;
+}
+
+//==============================================================================
+void CompensationDelay::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                int delaySamples) noexcept
+{
+    if (history.getNumSamples() == 0)
+        return;
+
+    const int delay = juce::jlimit(0, maxDelay, delaySamples);
+    const int capacity = mask + 1;
+    const int numChannels = juce::jmin(buffer.getNumChannels(), history.getNumChannels());
+
+    // In pieces no longer than the room left behind the longest delay
+    const int maxChunk = capacity - maxDelay;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int count = juce::jmin(maxChunk, numSamples - done);
+        const int readPosition = (writePosition - delay) & mask;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* samples = buffer.getWritePointer(ch, startSample + done);
+            float* ring = history.getWritePointer(ch);
+
+            // Write the new samples, then read the delayed ones (delay 0
+            // reads back what was just written); each wraps at most once
+            const int writeFirst = juce::jmin(count, capacity - writePosition);
+            juce::FloatVectorOperations::copy(ring + writePosition, samples, writeFirst);
+            juce::FloatVectorOperations::copy(ring, samples + writeFirst, count - writeFirst);
+
+            const int readFirst = juce::jmin(count, capacity - readPosition);
+            juce::FloatVectorOperations::copy(samples, ring + readPosition, readFirst);
+            juce::FloatVectorOperations::copy(samples + readFirst, ring, count - readFirst);
+        }
+
+        writePosition = (writePosition + count) & mask;
+        done += count;
+    }
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    CompensationDelay.h
+
+    Multichannel delay line for latency compensation. Capacity is set up
+    front; the delay itself can change from one block to the next (it
+    follows plugin latency), reading further back in the same history, so
+    a change moves the signal in time without a gap.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+class CompensationDelay
+{
+public:
+    CompensationDelay() = default;
+    ~CompensationDelay() = default;
+
+    //==========================================================================
+    // Not on the audio thread. Allocates for delays up to maxDelaySamples
+    // and clears the history.
+    void prepare(int numChannels, int maxDelaySamples, int maxBlockSize);
+    void release();
+
+    int getMaxDelay() const noexcept { return maxDelay; }
+
+    //==========================================================================
+    // Audio thread
+
+    // Delays [startSample, + numSamples) of the buffer in place by
+    // delaySamples (clamped to getMaxDelay()). Channels beyond the prepared
+    // count are left alone.
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int delaySamples) noexcept;
+
+    void clear() noexcept;
+
+private:
+    juce::AudioBuffer<float> history;
+    int mask { 0 };                // Capacity - 1 (a power of two)
+    int writePosition { 0 };
+    int maxDelay { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CompensationDelay)
+};
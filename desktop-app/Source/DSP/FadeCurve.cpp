@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    FadeCurve.cpp
+
+    Clip fade shape implementation
+
+  ==============================================================================
+*/
+
+#include "FadeCurve.h"
+#include <cmath>
+
+namespace
+{
+    // Steepness of the exponential / logarithmic shapes: an exponential
+    // fade-in is about -40 dB a tenth of the way in
+    constexpr double steepness = 4.0;
+
+    // (e^(kx) - 1) / (e^k - 1): 0 at x = 0, 1 at x = 1
+    const double exponentialScale = 1.0 / (std::exp(steepness) - 1.0);
+
+    constexpr double halfPi = juce::MathConstants<double>::halfPi;
+}
+
+//==============================================================================
+FadeCurve::Shape FadeCurve::fromInt(int value) noexcept
+{
+    switch (value)
+    {
+        case 1:  return Shape::exponential;
+        case 2:  return Shape::logarithmic;
+        case 3:  return Shape::equalPower;
+        default: return Shape::linear;
+    }
+}
+
+float FadeCurve::getGain(Shape shape, double x) noexcept
+{
+    x = juce::jlimit(0.0, 1.0, x);
+
+    switch (shape)
+    {
+        case Shape::exponential: return (float)((std::exp(steepness * x) - 1.0) * exponentialScale);
+        case Shape::logarithmic: return (float)(1.0 - (std::exp(steepness * (1.0 - x)) - 1.0) * exponentialScale);
+        case Shape::equalPower:  return (float)std::sin(x * halfPi);
+        case Shape::linear:
+        default:                 return (float)x;
+    }
+}
+
+//==============================================================================
+void FadeCurve::multiplyRamp(Shape shape, float* gains, int numSamples, double x0, double dx) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    switch (shape)
+    {
+        case Shape::exponential:
+        {
+            // e^(kx) advances by a constant ratio per sample
+            double e = std::exp(steepness * x0);
+            const double ratio = std::exp(steepness * dx);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gains[i] *= (float)((e - 1.0) * exponentialScale);
+                e *= ratio;
+            }
+            break;
+        }
+
+        case Shape::logarithmic:
+        {
+            // Mirror image of the exponential: e^(k(1 - x))
+            double e = std::exp(steepness * (1.0 - x0));
+            const double ratio = std::exp(-steepness * dx);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gains[i] *= (float)(1.0 - (e - 1.0) * exponentialScale);
+                e *= ratio;
+            }
+            break;
+        }
+
+        case Shape::equalPower:
+        {
+            // sin and cos of x * pi / 2, rotated by a fixed angle per sample
+            double s = std::sin(x0 * halfPi), c = std::cos(x0 * halfPi);
+            const double stepSin = std::sin(dx * halfPi), stepCos = std::cos(dx * halfPi);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gains[i] *= (float)s;
+
+                const double nextS = s * stepCos + c * stepSin;
+                c = c * stepCos - s * stepSin;
+                s = nextS;
+            }
+            break;
+        }
+
+        case Shape::linear:
+        default:
+        {
+            // Independent per sample, so the compiler vectorises it
+            const float start = (float)x0, step = (float)dx;
+
+            for (int i = 0; i < numSamples; ++i)
+                gains[i] *= start + step * (float)i;
+            break;
+        }
+    }
+}
+
+juce::String FadeCurve::getName(Shape shape)
+{
+    switch (shape)
+    {
+        case Shape::linear:       return "Linear";
+        case Shape::exponential:  return "Exponential";
+        case Shape::logarithmic:  return "Logarithmic";
+        case Shape::equalPower:   return "Equal Power";
+    }
+
+    return {};
+}
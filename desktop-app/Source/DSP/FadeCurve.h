@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    FadeCurve.h
+
+    Clip fade shapes and a block kernel that renders them. Shapes are
+    defined as fade-in gains over x = 0..1; a fade-out plays the same curve
+    with x running from 1 down to 0.
+
+    Blocks are rendered with closed-form recurrences (one multiply per
+    sample for the exponential shapes, a rotation for equal power) carried
+    in double precision and restarted exactly at every call, so nothing is
+    evaluated with exp() or sin() per sample and no error builds up.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+class FadeCurve
+{
+public:
+    //==========================================================================
+    // Values match the fadeInCurve / fadeOutCurve clip properties
+    enum class Shape
+    {
+        linear = 0,
+        exponential = 1,   // Slow start, fast finish
+        logarithmic = 2,   // Fast start, slow finish
+        equalPower = 3     // sin(x * pi / 2); constant power across a crossfade
+    };
+
+    static Shape fromInt(int value) noexcept;
+
+    // Fade-in gain at x (clamped to 0..1)
+    static float getGain(Shape shape, double x) noexcept;
+
+    // Multiplies gains[0, numSamples) by the curve at x0, x0 + dx, ...
+    // (dx is negative for fade-outs). x must stay within 0..1.
+    static void multiplyRamp(Shape shape, float* gains, int numSamples, double x0, double dx) noexcept;
+
+    static juce::String getName(Shape shape);
+
+private:
+    FadeCurve() = delete;
+};
@@ -0,0 +1,313 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyzer.cpp
+
+    ITU-R BS.1770-4 / EBU R128 loudness measurement implementation
+
+  ==============================================================================
+*/
+
+#include "LoudnessAnalyzer.h"
+#include <cmath>
+#include <limits>
+
+//==============================================================================
+LoudnessAnalyzer::LoudnessAnalyzer()
+{
+    channelWeights.fill(1.0);
+}
+
+//==============================================================================
+void LoudnessAnalyzer::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+    numPreparedChannels = juce::jlimit(1, maxChannels, numChannels);
+    hopSize = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));  // 100 ms
+
+    channelWeights.fill(1.0);
+    if (numPreparedChannels == 6)
+    {
+        // ITU 5.1 order: L R C LFE Ls Rs
+        channelWeights[3] = 0.0;
+        channelWeights[4] = 1.41;
+        channelWeights[5] = 1.41;
+    }
+
+    calculateFilterCoefficients();
+
+    momentaryHistogram.allocate();
+    shortTermHistogram.allocate();
+
+    reset();
+}
+
+void LoudnessAnalyzer::reset()
+{
+    for (auto& filter : shelfFilters)
+        filter.reset();
+    for (auto& filter : highPassFilters)
+        filter.reset();
+
+    hopSumSquares = 0.0;
+    hopSamples = 0;
+    hopEnergies.fill(0.0);
+    hopWriteIndex = 0;
+    hopsMeasured = 0;
+
+    momentaryHistogram.clear();
+    shortTermHistogram.clear();
+
+    momentaryLoudness = absoluteGate;
+    shortTermLoudness = absoluteGate;
+    integratedLoudness = absoluteGate;
+    loudnessRange = 0.0f;
+}
+
+void LoudnessAnalyzer::setChannelWeight(int channel, float weight)
+{
+    if (juce::isPositiveAndBelow(channel, maxChannels))
+        channelWeights[(size_t)channel] = juce::jmax(0.0f, weight);
+}
+
+//==============================================================================
+void LoudnessAnalyzer::calculateFilterCoefficients()
+{
+    // BS.1770 K-weighting, re-derived for the actual sample rate
+    // (the standard's coefficient table is specified at 48 kHz only)
+
+    // Stage 1: high shelf, +4 dB above ~1.7 kHz
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        Biquad shelf;
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+        shelfFilters.fill(shelf);
+    }
+
+    // Stage 2: RLB high-pass at ~38 Hz
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        Biquad highPass;
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+
+        highPassFilters.fill(highPass);
+    }
+}
+
+//==============================================================================
+void LoudnessAnalyzer::processBlock(const juce::AudioBuffer<float>& buffer)
+{
+    processBlock(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+}
+
+void LoudnessAnalyzer::processBlock(const float* const* channelData, int numChannels, int numSamples)
+{
+    if (channelData == nullptr || numPreparedChannels == 0)
+        return;
+
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        // Never run past the end of the current 100 ms hop
+        int numThisTime = juce::jmin(numSamples - offset, hopSize - hopSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* data = channelData[ch];
+            if (data == nullptr)
+                continue;
+
+            auto& shelf = shelfFilters[(size_t)ch];
+            auto& highPass = highPassFilters[(size_t)ch];
+            double sumSquares = 0.0;
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                double y = highPass.process(shelf.process((double)data[offset + i]));
+                sumSquares += y * y;
+            }
+
+            hopSumSquares += channelWeights[(size_t)ch] * sumSquares;
+        }
+
+        hopSamples += numThisTime;
+        offset += numThisTime;
+
+        if (hopSamples >= hopSize)
+            finishHop();
+    }
+}
+
+//==============================================================================
+void LoudnessAnalyzer::finishHop()
+{
+    hopEnergies[(size_t)hopWriteIndex] = hopSumSquares / (double)hopSize;
+    hopWriteIndex = (hopWriteIndex + 1) % shortTermHops;
+    ++hopsMeasured;
+
+    hopSumSquares = 0.0;
+    hopSamples = 0;
+
+    auto windowEnergy = [this](int numHops)
+    {
+        double sum = 0.0;
+        for (int i = 1; i <= numHops; ++i)
+            sum += hopEnergies[(size_t)((hopWriteIndex - i + shortTermHops) % shortTermHops)];
+        return sum / numHops;
+    };
+
+    // Momentary: 400 ms gating blocks with 75 % overlap
+    if (hopsMeasured >= momentaryHops)
+    {
+        double energy = windowEnergy(momentaryHops);
+        momentaryLoudness = juce::jmax(absoluteGate, energyToLoudness(energy));
+        momentaryHistogram.add(energyToLoudness(energy), energy);
+    }
+
+    // Short-term: 3 s window, updated every 100 ms (EBU Tech 3342)
+    if (hopsMeasured >= shortTermHops)
+    {
+        double energy = windowEnergy(shortTermHops);
+        shortTermLoudness = juce::jmax(absoluteGate, energyToLoudness(energy));
+        shortTermHistogram.add(energyToLoudness(energy), energy);
+    }
+
+    updateGatedMeasurements();
+}
+
+void LoudnessAnalyzer::updateGatedMeasurements()
+{
+    // Integrated: absolute gate, then relative gate 10 LU below the gated mean
+    if (momentaryHistogram.getTotalCount() > 0)
+    {
+        double absoluteMean = momentaryHistogram.getTotalEnergy() / (double)momentaryHistogram.getTotalCount();
+        float relativeThreshold = energyToLoudness(absoluteMean) + integratedRelativeGate;
+        double gatedMean = momentaryHistogram.getMeanEnergyAbove(relativeThreshold);
+
+        integratedLoudness = gatedMean > 0.0 ? juce::jmax(absoluteGate, energyToLoudness(gatedMean))
+                                             : absoluteGate;
+    }
+
+    // Loudness range: relative gate 20 LU below, then 95th - 10th percentile
+    if (shortTermHistogram.getTotalCount() > 0)
+    {
+        double absoluteMean = shortTermHistogram.getTotalEnergy() / (double)shortTermHistogram.getTotalCount();
+        float relativeThreshold = energyToLoudness(absoluteMean) + rangeRelativeGate;
+
+        float low = shortTermHistogram.getPercentileAbove(relativeThreshold, 0.10);
+        float high = shortTermHistogram.getPercentileAbove(relativeThreshold, 0.95);
+        loudnessRange = juce::jmax(0.0f, high - low);
+    }
+}
+
+//==============================================================================
+float LoudnessAnalyzer::energyToLoudness(double energy)
+{
+    if (energy <= 0.0)
+        return -std::numeric_limits<float>::infinity();
+
+    return (float)(-0.691 + 10.0 * std::log10(energy));
+}
+
+//==============================================================================
+void LoudnessAnalyzer::GatingHistogram::allocate()
+{
+    counts.assign((size_t)numBins, 0);
+    energies.assign((size_t)numBins, 0.0);
+    clear();
+}
+
+void LoudnessAnalyzer::GatingHistogram::clear()
+{
+    std::fill(counts.begin(), counts.end(), (juce::int64)0);
+    std::fill(energies.begin(), energies.end(), 0.0);
+    totalEnergy = 0.0;
+    totalCount = 0;
+}
+
+int LoudnessAnalyzer::GatingHistogram::getBin(float loudness) const
+{
+    return juce::jlimit(0, numBins - 1, (int)std::floor((loudness - minLoudness) / binWidth));
+}
+
+void LoudnessAnalyzer::GatingHistogram::add(float loudness, double energy)
+{
+    if (!(loudness >= minLoudness) || counts.empty())
+        return;
+
+    int bin = getBin(loudness);
+    counts[(size_t)bin] += 1;
+    energies[(size_t)bin] += energy;
+    totalEnergy += energy;
+    totalCount += 1;
+}
+
+double LoudnessAnalyzer::GatingHistogram::getMeanEnergyAbove(float threshold) const
+{
+    if (counts.empty())
+        return 0.0;
+
+    double energy = 0.0;
+    juce::int64 count = 0;
+
+    for (int bin = getBin(threshold); bin < numBins; ++bin)
+    {
+        energy += energies[(size_t)bin];
+        count += counts[(size_t)bin];
+    }
+
+    return count > 0 ? energy / (double)count : 0.0;
+}
+
+float LoudnessAnalyzer::GatingHistogram::getPercentileAbove(float threshold, double fraction) const
+{
+    if (counts.empty())
+        return minLoudness;
+
+    int firstBin = getBin(threshold);
+    juce::int64 count = 0;
+
+    for (int bin = firstBin; bin < numBins; ++bin)
+        count += counts[(size_t)bin];
+
+    if (count == 0)
+        return minLoudness;
+
+    // Rank of the requested value among the gated blocks (0-based)
+    auto rank = (juce::int64)std::floor(fraction * (double)(count - 1) + 0.5);
+    juce::int64 seen = 0;
+
+    for (int bin = firstBin; bin < numBins; ++bin)
+    {
+        seen += counts[(size_t)bin];
+        if (seen > rank)
+            return minLoudness + ((float)bin + 0.5f) * binWidth;
+    }
+
+    return maxLoudness;
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyzer.h
+
+    Streaming ITU-R BS.1770-4 / EBU R128 loudness measurement:
+    K-weighting, 400 ms momentary and 3 s short-term windows on 100 ms hops,
+    gated integrated loudness and loudness range (EBU Tech 3342).
+
+    Gating uses fixed-resolution histograms, so every hop is an O(1) update
+    and memory stays constant however long the programme runs.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+
+class LoudnessAnalyzer
+{
+public:
+    //==========================================================================
+    static constexpr float absoluteGate = -70.0f;      // LUFS, also reported for "no value"
+    static constexpr float integratedRelativeGate = -10.0f;  // LU
+    static constexpr float rangeRelativeGate = -20.0f;       // LU
+    static constexpr int maxChannels = 8;
+
+    LoudnessAnalyzer();
+    ~LoudnessAnalyzer() = default;
+
+    //==========================================================================
+    // Allocates; call before processing (not on the audio thread)
+    void prepare(double sampleRate, int numChannels);
+
+    // Clears filter state and all measurements (no allocation)
+    void reset();
+
+    // Channel weighting G_i. Defaults to 1.0, or the BS.1770 5.1 weights
+    // (L R C LFE Ls Rs: 1 1 1 0 1.41 1.41) when prepared with 6 channels.
+    void setChannelWeight(int channel, float weight);
+
+    //==========================================================================
+    // Process audio (real-time safe). Channels beyond the prepared count are ignored.
+    void processBlock(const juce::AudioBuffer<float>& buffer);
+    void processBlock(const float* const* channelData, int numChannels, int numSamples);
+
+    //==========================================================================
+    // Results (LUFS / LU). absoluteGate means not measured yet.
+    float getMomentaryLoudness() const { return momentaryLoudness; }
+    float getShortTermLoudness() const { return shortTermLoudness; }
+    float getIntegratedLoudness() const { return integratedLoudness; }
+    float getLoudnessRange() const { return loudnessRange; }
+
+    // Number of 100 ms hops measured since the last reset
+    juce::int64 getNumHops() const { return hopsMeasured; }
+
+private:
+    //==========================================================================
+    // Transposed direct form II biquad, double precision state
+    struct Biquad
+    {
+        double b0 { 1.0 }, b1 { 0.0 }, b2 { 0.0 }, a1 { 0.0 }, a2 { 0.0 };
+        double z1 { 0.0 }, z2 { 0.0 };
+
+        double process(double x)
+        {
+            double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+
+        void reset() { z1 = z2 = 0.0; }
+    };
+
+    //==========================================================================
+    /**
+        Block loudness histogram. Each bin keeps its block count and the sum of
+        the blocks' mean-square energies, so gated means stay exact; the bin
+        width only limits where the relative gate and percentiles fall.
+    */
+    class GatingHistogram
+    {
+    public:
+        static constexpr float minLoudness = absoluteGate;
+        static constexpr float maxLoudness = 10.0f;
+        static constexpr float binWidth = 0.01f;
+        static constexpr int numBins = (int)((maxLoudness - minLoudness) / binWidth) + 1;
+
+        void allocate();
+        void clear();
+
+        // O(1): blocks below the absolute gate are ignored
+        void add(float loudness, double energy);
+
+        // Mean energy of blocks at or above the given loudness
+        double getMeanEnergyAbove(float threshold) const;
+
+        // Loudness at the given fraction (0..1) of blocks at or above threshold
+        float getPercentileAbove(float threshold, double fraction) const;
+
+        double getTotalEnergy() const { return totalEnergy; }
+        juce::int64 getTotalCount() const { return totalCount; }
+
+    private:
+        int getBin(float loudness) const;
+
+        std::vector<juce::int64> counts;
+        std::vector<double> energies;
+        double totalEnergy { 0.0 };
+        juce::int64 totalCount { 0 };
+    };
+
+    //==========================================================================
+    void calculateFilterCoefficients();
+    void finishHop();
+    void updateGatedMeasurements();
+
+    static float energyToLoudness(double energy);
+
+    //==========================================================================
+    double sampleRate { 48000.0 };
+    int numPreparedChannels { 0 };
+    int hopSize { 4800 };
+
+    std::array<Biquad, maxChannels> shelfFilters;     // Stage 1: head response high shelf
+    std::array<Biquad, maxChannels> highPassFilters;  // Stage 2: RLB high-pass
+    std::array<double, maxChannels> channelWeights {};
+
+    // Current 100 ms hop
+    double hopSumSquares { 0.0 };
+    int hopSamples { 0 };
+
+    // Mean-square energy of recent hops (ring of the last 3 s)
+    static constexpr int momentaryHops = 4;    // 400 ms
+    static constexpr int shortTermHops = 30;   // 3 s
+    std::array<double, shortTermHops> hopEnergies {};
+    int hopWriteIndex { 0 };
+    juce::int64 hopsMeasured { 0 };
+
+    GatingHistogram momentaryHistogram;  // Integrated loudness gating
+    GatingHistogram shortTermHistogram;  // Loudness range
+
+    float momentaryLoudness { absoluteGate };
+    float shortTermLoudness { absoluteGate };
+    float integratedLoudness { absoluteGate };
+    float loudnessRange { 0.0f };
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessAnalyzer)
+};
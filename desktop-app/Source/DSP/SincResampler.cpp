@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    SincResampler.cpp
+
+    Polyphase windowed-sinc sample-rate conversion implementation
+
+  ==============================================================================
+*/
+
+#include "SincResampler.h"
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+namespace
+{
+    //==========================================================================
+    struct QualitySpec
+    {
+        int numTaps;
+        int phaseBits;   // log2 of the tabulated fractional phases
+        double beta;     // Kaiser window
+        double cutoff;   // Relative to the lower Nyquist frequency
+    };
+
+    // Cutoffs put the stopband edge close to Nyquist, so aliasing is limited
+    // to the top few percent of the band
+    QualitySpec getSpec(SincResampler::Quality quality)
+    {
+        switch (quality)
+        {
+            case SincResampler::Quality::draft:   return { 8,  5, 4.0,  0.80 };
+            case SincResampler::Quality::normal:  return { 16, 6, 6.0,  0.85 };
+            case SincResampler::Quality::best:    return { 64, 9, 10.0, 0.92 };
+            case SincResampler::Quality::high:
+            default:                              return { 32, 8, 8.0,  0.88 };
+        }
+    }
+
+    // Downsampling stretches the kernel by the ratio, up to this much
+    constexpr double maxStretch = 4.0;
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; term > 1.0e-12 * sum; ++k)
+        {
+            double half = x / (2.0 * k);
+            term *= half * half;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    float* alignedStart(std::vector<float>& storage)
+    {
+        return juce::dsp::SIMDRegister<float>::getNextSIMDAlignedPtr(storage.data());
+    }
+}
+
+//==============================================================================
+struct SincResampler::Kernel
+{
+    int numTaps { 0 };
+    int phaseBits { 0 };
+
+    // (1 << phaseBits) + 1 rows of numTaps, each SIMD aligned. Row r is the
+    // kernel for a fractional position of r / (1 << phaseBits).
+    std::vector<float> storage;
+    const float* coefficients { nullptr };
+};
+
+std::shared_ptr<const SincResampler::Kernel> SincResampler::getKernel(Quality quality, double ratio)
+{
+    auto spec = getSpec(quality);
+
+    // Multiple of every SIMD width we build for
+    const int tapMultiple = juce::jmax(8, numLanes);
+    const double stretch = juce::jlimit(1.0, maxStretch, ratio);
+    const int taps = ((int)std::ceil(spec.numTaps * stretch) + tapMultiple - 1) / tapMultiple * tapMultiple;
+    const double cutoff = spec.cutoff / juce::jmax(1.0, ratio);
+
+    // Kernels are shared by every stream with the same settings
+    static juce::CriticalSection registryLock;
+    static std::map<std::tuple<int, int, juce::int64>, std::weak_ptr<const Kernel>> registry;
+
+    const auto key = std::make_tuple((int)quality, taps, (juce::int64)std::llround(cutoff * 1.0e9));
+    const juce::ScopedLock sl(registryLock);
+
+    if (auto existing = registry[key].lock())
+        return existing;
+
+    auto kernel = std::make_shared<Kernel>();
+    kernel->numTaps = taps;
+    kernel->phaseBits = spec.phaseBits;
+
+    const int numPhases = 1 << spec.phaseBits;
+    kernel->storage.resize((size_t)((numPhases + 1) * taps + numLanes));
+    auto* coefficients = alignedStart(kernel->storage);
+
+    const double pi = juce::MathConstants<double>::pi;
+    const double halfLength = taps * 0.5;
+    const double windowNorm = 1.0 / besselI0(spec.beta);
+
+    for (int row = 0; row <= numPhases; ++row)
+    {
+        auto* rowCoefficients = coefficients + row * taps;
+        const double fraction = (double)row / numPhases;
+        double sum = 0.0;
+
+        for (int k = 0; k < taps; ++k)
+        {
+            // Distance in input samples from the output position to tap k
+            double d = fraction + halfLength - 1.0 - k;
+            double x = cutoff * d;
+            double sinc = std::abs(x) < 1.0e-12 ? 1.0 : std::sin(pi * x) / (pi * x);
+            double r = d / halfLength;
+            double window = besselI0(spec.beta * std::sqrt(juce::jmax(0.0, 1.0 - r * r))) * windowNorm;
+
+            double value = cutoff * sinc * window;
+            rowCoefficients[k] = (float)value;
+            sum += value;
+        }
+
+        // Unity gain at DC for every phase
+        for (int k = 0; k < taps; ++k)
+            rowCoefficients[k] = (float)(rowCoefficients[k] / sum);
+    }
+
+    kernel->coefficients = coefficients;
+    registry[key] = kernel;
+    return kernel;
+}
+
+//==============================================================================
+void SincResampler::prepare(int newNumChannels, double newRatio, Quality quality, int maxOutputSamplesPerCall)
+{
+    jassert(newRatio > 0.0);
+
+    numChannels = juce::jlimit(1, maxChannels, newNumChannels);
+    ratio = newRatio;
+    step = (juce::uint64)std::llround(ratio * 4294967296.0);
+
+    kernel = getKernel(quality, ratio);
+    numTaps = kernel->numTaps;
+
+    maxInputPerCall = (int)std::ceil(juce::jmax(1, maxOutputSamplesPerCall) * ratio) + numTaps + 2;
+
+    // At most numTaps samples are carried over between calls
+    int copyLength = numTaps + maxInputPerCall + numLanes;
+    copyLength = (copyLength + numLanes - 1) / numLanes * numLanes;
+
+    storage.assign((size_t)(numChannels * numLanes * copyLength + numLanes), 0.0f);
+    copies.resize((size_t)(numChannels * numLanes));
+
+    auto* base = alignedStart(storage);
+    for (size_t i = 0; i < copies.size(); ++i)
+        copies[i] = base + i * (size_t)copyLength;
+
+    reset();
+}
+
+void SincResampler::reset(double initialFraction) noexcept
+{
+    numBuffered = 0;
+    fraction = (juce::uint64)(juce::jlimit(0.0, 1.0 - 1.0e-9, initialFraction) * 4294967296.0);
+}
+
+//==============================================================================
+int SincResampler::getNumInputSamplesNeeded(int numOutputSamples) const noexcept
+{
+    if (numOutputSamples <= 0 || kernel == nullptr)
+        return 0;
+
+    // The last output's window, and where the next call's first window starts
+    auto lastStart = (int)((fraction + (juce::uint64)(numOutputSamples - 1) * step) >> 32);
+    auto nextStart = (int)((fraction + (juce::uint64)numOutputSamples * step) >> 32);
+
+    return juce::jmax(0, juce::jmax(lastStart + numTaps, nextStart) - numBuffered);
+}
+
+void SincResampler::process(const float* const* input, float* const* output, int numOutputSamples) noexcept
+{
+    if (numOutputSamples <= 0 || kernel == nullptr)
+        return;
+
+    const int numNeeded = getNumInputSamplesNeeded(numOutputSamples);
+    jassert(numNeeded <= maxInputPerCall);
+
+    // Append the input to every lane copy
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int lane = 0; lane < numLanes; ++lane)
+            std::memcpy(getCopy(ch, lane) + numBuffered + lane, input[ch], (size_t)numNeeded * sizeof(float));
+
+    numBuffered += numNeeded;
+
+    const int phaseShift = 32 - kernel->phaseBits;
+    const juce::uint32 phaseMask = (1u << phaseShift) - 1u;
+    const float alphaScale = 1.0f / (float)(1u << phaseShift);
+    const float* coefficients = kernel->coefficients;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* out = output[ch];
+        auto position = fraction;
+
+        for (int i = 0; i < numOutputSamples; ++i, position += step)
+        {
+            const int start = (int)(position >> 32);
+            const auto phase = (juce::uint32)position;
+            const float alpha = (float)(phase & phaseMask) * alphaScale;
+
+            const int lane = (-start) & (numLanes - 1);
+            const float* window = getCopy(ch, lane) + start + lane;
+            const float* lower = coefficients + (size_t)(phase >> phaseShift) * (size_t)numTaps;
+            const float* upper = lower + numTaps;
+
+            // Both neighbouring phases at once, blended after the sums
+            auto sumLower = Register::expand(0.0f);
+            auto sumUpper = Register::expand(0.0f);
+
+            for (int k = 0; k < numTaps; k += numLanes)
+            {
+                auto samples = Register::fromRawArray(window + k);
+                sumLower = Register::multiplyAdd(sumLower, samples, Register::fromRawArray(lower + k));
+                sumUpper = Register::multiplyAdd(sumUpper, samples, Register::fromRawArray(upper + k));
+            }
+
+            const float a = sumLower.sum();
+            out[i] = a + alpha * (sumUpper.sum() - a);
+        }
+    }
+
+    // Drop what the next call's first window no longer needs
+    const auto end = fraction + (juce::uint64)numOutputSamples * step;
+    const int consumed = (int)(end >> 32);
+    const int remaining = numBuffered - consumed;
+    jassert(remaining >= 0);
+
+    if (consumed > 0)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                auto* copy = getCopy(ch, lane);
+                std::memmove(copy + lane, copy + consumed + lane, (size_t)remaining * sizeof(float));
+            }
+        }
+    }
+
+    numBuffered = remaining;
+    fraction = end & 0xffffffffu;
+}
+
+//==============================================================================
+juce::String SincResampler::getQualityName(Quality quality)
+{
+    switch (quality)
+    {
+        case Quality::draft:   return "Draft";
+        case Quality::normal:  return "Normal";
+        case Quality::high:    return "High";
+        case Quality::best:    return "Best";
+    }
+
+    return {};
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    SincResampler.h
+
+    Arbitrary-ratio sample-rate conversion with a polyphase Kaiser-windowed
+    sinc. The kernel is tabulated at a power-of-two number of fractional
+    phases and linearly interpolated between neighbouring phases; when
+    downsampling the cutoff follows the output Nyquist and the kernel is
+    stretched to keep its transition band.
+
+    Each instance holds one stream's state (history and fractional
+    position); kernel tables are shared between instances with the same
+    quality and ratio. The dot products run on juce::dsp::SIMDRegister:
+    the history is stored once per SIMD lane offset so every kernel window
+    starts on an aligned address.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+class SincResampler
+{
+public:
+    //==========================================================================
+    enum class Quality
+    {
+        draft,   // 8 taps, ~45 dB stopband
+        normal,  // 16 taps, ~65 dB
+        high,    // 32 taps, ~80 dB
+        best     // 64 taps, ~100 dB
+    };
+
+    static constexpr int maxChannels = 8;
+
+    SincResampler() = default;
+    ~SincResampler() = default;
+
+    //==========================================================================
+    // ratio is input rate / output rate. Allocates (and may design a kernel);
+    // call before processing, not on the audio thread.
+    void prepare(int numChannels, double ratio, Quality quality, int maxOutputSamplesPerCall);
+
+    // Clears the history. The next output is taken initialFraction input
+    // samples after the input sample at index getInputLatency() of what is
+    // fed next, so feed from that many samples before the wanted position.
+    void reset(double initialFraction = 0.0) noexcept;
+
+    //==========================================================================
+    // Input samples the next process() call with this many outputs consumes
+    int getNumInputSamplesNeeded(int numOutputSamples) const noexcept;
+
+    // Consumes exactly getNumInputSamplesNeeded(numOutputSamples) samples
+    // per channel and writes numOutputSamples (real-time safe)
+    void process(const float* const* input, float* const* output, int numOutputSamples) noexcept;
+
+    //==========================================================================
+    int getInputLatency() const noexcept { return numTaps / 2 - 1; }
+    int getNumTaps() const noexcept { return numTaps; }
+    int getMaxInputSamplesPerCall() const noexcept { return maxInputPerCall; }
+    double getRatio() const noexcept { return ratio; }
+
+    static juce::String getQualityName(Quality quality);
+
+private:
+    //==========================================================================
+    using Register = juce::dsp::SIMDRegister<float>;
+    static constexpr int numLanes = (int)Register::size();
+
+    struct Kernel;
+    static std::shared_ptr<const Kernel> getKernel(Quality quality, double ratio);
+
+    float* getCopy(int channel, int lane) const noexcept { return copies[(size_t)(channel * numLanes + lane)]; }
+
+    //==========================================================================
+    std::shared_ptr<const Kernel> kernel;
+    int numChannels { 0 };
+    int numTaps { 0 };
+    double ratio { 1.0 };
+    juce::uint64 step { 0 };  // ratio in 32.32 fixed point
+    int maxInputPerCall { 0 };
+
+    // numLanes copies of each channel's input; copy l holds sample j at
+    // index j + l, so a window starting at j is aligned in copy (-j mod numLanes)
+    std::vector<float> storage;
+    std::vector<float*> copies;
+
+    int numBuffered { 0 };    // Input samples held in each copy
+    juce::uint64 fraction { 0 };  // Position of the next output past the first window, 0.32
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SincResampler)
+};
@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    TruePeakDetector.cpp
+
+    ITU-R BS.1770-4 Annex 2 true-peak measurement implementation
+
+  ==============================================================================
+*/
+
+#include "TruePeakDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    //==========================================================================
+    // BS.1770-4 Annex 2, 48-tap 4x interpolator (phases 0 and 1; phases 2 and 3
+    // are their time reverses)
+    constexpr int annexTapsPerPhase = 12;
+
+    constexpr float annexPhase0[annexTapsPerPhase] =
+    {
+         0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+        -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+         0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f
+    };
+
+    constexpr float annexPhase1[annexTapsPerPhase] =
+    {
+        -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+        -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+         0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f
+    };
+
+    //==========================================================================
+    // 8x: Kaiser-windowed sinc over 16 input samples, cut off at the input
+    // Nyquist. Flat within 0.1 dB to 0.83 Nyquist, at least 50 dB down above
+    // 1.25 Nyquist (the Annex 2 filter manages 40 dB).
+    constexpr int windowedSincTapsPerPhase = 16;
+    constexpr double windowedSincBeta = 4.0;
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; term > 1.0e-12 * sum; ++k)
+        {
+            double half = x / (2.0 * k);
+            term *= half * half;
+            sum += term;
+        }
+
+        return sum;
+    }
+}
+
+//==============================================================================
+TruePeakDetector::TruePeakDetector()
+{
+    designFilter();
+}
+
+//==============================================================================
+void TruePeakDetector::prepare(int numChannels, int newOversamplingFactor)
+{
+    jassert(newOversamplingFactor == 4 || newOversamplingFactor == 8);
+
+    numPreparedChannels = juce::jlimit(1, maxChannels, numChannels);
+    oversamplingFactor = newOversamplingFactor >= 8 ? 8 : 4;
+
+    designFilter();
+    reset();
+}
+
+void TruePeakDetector::reset()
+{
+    for (auto& channelHistory : history)
+        channelHistory.fill(0.0f);
+
+    blockPeaks.fill(0.0f);
+    peaks.fill(0.0f);
+}
+
+//==============================================================================
+void TruePeakDetector::designFilter()
+{
+    // phases[p][k]: tap k of phase p, i.e. h[k * factor + p]
+    float phases[maxOversamplingFactor][maxTapsPerPhase] {};
+
+    if (oversamplingFactor == 4)
+    {
+        tapsPerPhase = annexTapsPerPhase;
+
+        for (int k = 0; k < annexTapsPerPhase; ++k)
+        {
+            phases[0][k] = annexPhase0[k];
+            phases[1][k] = annexPhase1[k];
+            phases[2][k] = annexPhase1[annexTapsPerPhase - 1 - k];
+            phases[3][k] = annexPhase0[annexTapsPerPhase - 1 - k];
+        }
+    }
+    else
+    {
+        tapsPerPhase = windowedSincTapsPerPhase;
+
+        const int length = oversamplingFactor * tapsPerPhase;
+        const double centre = (length - 1) * 0.5;
+        const double pi = juce::MathConstants<double>::pi;
+
+        for (int n = 0; n < length; ++n)
+        {
+            double t = (n - centre) / oversamplingFactor;  // In input samples
+            double sinc = std::sin(pi * t) / (pi * t);     // centre is never on a tap
+            double r = (n - centre) / centre;
+            double window = besselI0(windowedSincBeta * std::sqrt(juce::jmax(0.0, 1.0 - r * r)))
+                          / besselI0(windowedSincBeta);
+
+            phases[n % oversamplingFactor][n / oversamplingFactor] = (float)(sinc * window);
+        }
+    }
+
+    // Phases across the lanes of each tap's registers
+    const int laneCount = (int)Register::size();
+    registersPerTap = (oversamplingFactor + laneCount - 1) / laneCount;
+    jassert(registersPerTap <= maxRegistersPerTap);
+
+    for (int k = 0; k < tapsPerPhase; ++k)
+    {
+        for (int r = 0; r < registersPerTap; ++r)
+        {
+            auto& coefficient = coefficients[(size_t)(k * registersPerTap + r)];
+            coefficient = Register::expand(0.0f);
+
+            for (int lane = 0; lane < laneCount; ++lane)
+            {
+                int phase = r * laneCount + lane;
+                if (phase < oversamplingFactor)
+                    coefficient.set((size_t)lane, phases[phase][k]);
+            }
+        }
+    }
+}
+
+//==============================================================================
+template <int numTaps, int numRegisters, int numSamples>
+TruePeakDetector::Register TruePeakDetector::filterSamples(const float* window) const
+{
+    Register sums[numSamples][numRegisters];
+
+    for (auto& sampleSums : sums)
+        for (auto& sum : sampleSums)
+            sum = Register::expand(0.0f);
+
+    for (int k = 0; k < numTaps; ++k)
+    {
+        const auto* tapCoefficients = coefficients.data() + k * numRegisters;
+
+        for (int j = 0; j < numSamples; ++j)
+        {
+            auto sample = Register::expand(window[j + k]);
+
+            for (int r = 0; r < numRegisters; ++r)
+                sums[j][r] = Register::multiplyAdd(sums[j][r], tapCoefficients[r], sample);
+        }
+    }
+
+    auto peak = Register::abs(sums[0][0]);
+
+    for (int j = 0; j < numSamples; ++j)
+        for (int r = 0; r < numRegisters; ++r)
+            peak = Register::max(peak, Register::abs(sums[j][r]));
+
+    return peak;
+}
+
+//==============================================================================
+template <int numTaps, int numRegisters>
+float TruePeakDetector::processChannel(int channel, const float* data, int numSamples)
+{
+    auto& channelHistory = history[(size_t)channel];
+    const int offset = historySize - (numTaps - 1);  // First history sample still in use
+
+    // History followed by the current chunk, so every window is contiguous
+    float input[historySize + chunkSize];
+    std::copy(channelHistory.begin(), channelHistory.end(), input);
+
+    auto peak = Register::expand(0.0f);
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const int numThisTime = juce::jmin(chunkSize, numSamples - start);
+        std::copy(data + start, data + start + numThisTime, input + historySize);
+
+        // Several input samples per pass: their sums are independent, so the
+        // multiply-adds aren't serialised on one accumulator
+        const float* window = input + offset;  // Oldest tap first
+        int i = 0;
+
+        for (; i + samplesPerPass <= numThisTime; i += samplesPerPass)
+            peak = Register::max(peak, filterSamples<numTaps, numRegisters, samplesPerPass>(window + i));
+
+        for (; i < numThisTime; ++i)
+            peak = Register::max(peak, filterSamples<numTaps, numRegisters, 1>(window + i));
+
+        // Keep the newest samples as the next chunk's history
+        std::copy(input + numThisTime, input + numThisTime + historySize, input);
+    }
+
+    std::copy(input, input + historySize, channelHistory.begin());
+
+    float result = 0.0f;
+    for (size_t lane = 0; lane < Register::size(); ++lane)
+        result = juce::jmax(result, peak.get(lane));
+
+    return result;
+}
+
+//==============================================================================
+void TruePeakDetector::processBlock(const juce::AudioBuffer<float>& buffer)
+{
+    processBlock(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+}
+
+void TruePeakDetector::processBlock(const float* const* channelData, int numChannels, int numSamples)
+{
+    if (channelData == nullptr || numPreparedChannels == 0)
+        return;
+
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* data = channelData[ch];
+        if (data == nullptr || numSamples <= 0)
+        {
+            blockPeaks[(size_t)ch] = 0.0f;
+            continue;
+        }
+
+        float peak = oversamplingFactor == 4
+            ? processChannel<annexTapsPerPhase, (4 + (int)Register::size() - 1) / (int)Register::size()>(ch, data, numSamples)
+            : processChannel<windowedSincTapsPerPhase, maxRegistersPerTap>(ch, data, numSamples);
+
+        // Never report less than the sample peak (the interpolator's centre
+        // taps are slightly below unity)
+        auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+        peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+
+        blockPeaks[(size_t)ch] = peak;
+        peaks[(size_t)ch] = juce::jmax(peaks[(size_t)ch], peak);
+    }
+}
+
+//==============================================================================
+float TruePeakDetector::getBlockPeak(int channel) const
+{
+    return juce::isPositiveAndBelow(channel, maxChannels) ? blockPeaks[(size_t)channel] : 0.0f;
+}
+
+float TruePeakDetector::getPeak(int channel) const
+{
+    return juce::isPositiveAndBelow(channel, maxChannels) ? peaks[(size_t)channel] : 0.0f;
+}
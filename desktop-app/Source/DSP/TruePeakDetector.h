@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    TruePeakDetector.h
+
+    ITU-R BS.1770-4 Annex 2 true-peak measurement: each channel is
+    upsampled with a polyphase FIR (4x using the Annex 2 coefficients,
+    or 8x) and the largest absolute value of the interpolated signal is
+    reported. The reading never falls below the sample peak.
+
+    The inner loop computes every output phase of one input sample at once
+    with juce::dsp::SIMDRegister, so one multiply-add per tap produces
+    four (or eight) oversampled values.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+class TruePeakDetector
+{
+public:
+    //==========================================================================
+    static constexpr int maxChannels = 8;
+
+    TruePeakDetector();
+    ~TruePeakDetector() = default;
+
+    //==========================================================================
+    // Oversampling factor is 4 (BS.1770 Annex 2) or 8. Call before
+    // processing (not on the audio thread); the filter is sample-rate
+    // independent.
+    void prepare(int numChannels, int oversamplingFactor = 4);
+
+    // Clears the filter history and all peaks (no allocation)
+    void reset();
+
+    //==========================================================================
+    // Process audio (real-time safe). Channels beyond the prepared count are ignored.
+    void processBlock(const juce::AudioBuffer<float>& buffer);
+    void processBlock(const float* const* channelData, int numChannels, int numSamples);
+
+    //==========================================================================
+    // Linear true peak of the most recent block / since the last reset
+    float getBlockPeak(int channel) const;
+    float getPeak(int channel) const;
+
+    int getOversamplingFactor() const { return oversamplingFactor; }
+
+private:
+    //==========================================================================
+    using Register = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int maxOversamplingFactor = 8;
+    static constexpr int maxTapsPerPhase = 16;
+    static constexpr int historySize = maxTapsPerPhase - 1;
+    static constexpr int maxRegistersPerTap = (maxOversamplingFactor + (int)Register::size() - 1) / (int)Register::size();
+    static constexpr int chunkSize = 256;
+    static constexpr int samplesPerPass = 4;
+
+    void designFilter();
+
+    // Tap and register counts are fixed per factor so the inner loops unroll
+    template <int numTaps, int numRegisters>
+    float processChannel(int channel, const float* data, int numSamples);
+
+    // Absolute values of all interpolated outputs for numSamples consecutive
+    // inputs; window points at the oldest tap of the first one
+    template <int numTaps, int numRegisters, int numSamples>
+    Register filterSamples(const float* window) const;
+
+    //==========================================================================
+    int numPreparedChannels { 0 };
+    int oversamplingFactor { 4 };
+    int tapsPerPhase { 12 };
+    int registersPerTap { 1 };
+
+    // coefficients[tap * registersPerTap + r], lane l holds phase r * size + l.
+    // Lanes beyond the oversampling factor are zero.
+    std::array<Register, maxTapsPerPhase * maxRegistersPerTap> coefficients;
+
+    // Last historySize input samples per channel, oldest first
+    std::array<std::array<float, historySize>, maxChannels> history {};
+
+    std::array<float, maxChannels> blockPeaks {};
+    std::array<float, maxChannels> peaks {};
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakDetector)
+};
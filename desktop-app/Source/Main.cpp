@@ -11,6 +11,8 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 #include "Core/AudioEngine.h"
+#include "Core/AnalysisScheduler.h"
+#include "Core/RealtimeSafety.h"
 #include "UI/WaveformDisplay.h"
 #include "UI/LevelMeter.h"
 #include "UI/PanelContainer.h"
@@ -42,6 +44,8 @@
 #include "UI/MixerPanel.h"
 #include "Core/ProjectManager.h"
 #include "Core/MultiTrackAudioSource.h"
+#include "Core/ProjectBouncer.h"
+#include "Core/TrackFreezer.h"
 
 //==============================================================================
 /**
@@ -111,6 +115,7 @@ class MainComponent : public juce::Component,
         fileAddToTrack,
         fileNewProject,
         fileAddTrack,
+        fileBounceProject,
         fileSettings,
         fileExit,
 
@@ -184,7 +189,11 @@ class MainComponent : public juce::Component,
     ~MainComponent() override
     {
         stopTimer();
+        analysisScheduler.stop();
         audioEngine.shutdown();
+
+        // Plugin editors go before the chains holding their plugins
+        pluginHostPanel.closeAllEditorWindows();
         setLookAndFeel(nullptr);
     }
 
@@ -213,6 +222,23 @@ class MainComponent : public juce::Component,
     {
         // Update UI based on audio engine state
         updateUI();
+
+        if (projectBouncer != nullptr && projectBouncer->isRunning())
+            statusBar.setText("Bouncing... " + juce::String(juce::roundToInt(projectBouncer->getProgress() * 100.0)) + "%",
+                              juce::dontSendNotification);
+
+        if (trackFreezer != nullptr && trackFreezer->isRunning())
+            statusBar.setText("Freezing... " + juce::String(juce::roundToInt(trackFreezer->getProgress() * 100.0)) + "%",
+                              juce::dontSendNotification);
+
+        // Plugins can change their latency at any time; the dry path follows
+        auto& chain = pluginHostPanel.getEffectChain();
+        chain.updateLatency();
+        audioEngine.setProcessLatency(chain.getLatencySamples());
+        abCompareControl.setLatency(chain.getLatencySamples(), audioEngine.getCurrentSampleRate());
+
+        // Debug builds: report allocations / locks seen on the audio thread
+        RealtimeSafety::logPendingViolations();
     }
 
 private:
@@ -449,7 +475,7 @@ class MainComponent : public juce::Component,
         double sampleRate = audioEngine.getCurrentSampleRate();
         int bufferSize = audioEngine.getCurrentBufferSize();
 
-        analysisPanel.prepare(sampleRate, bufferSize);
+        analysisScheduler.prepare(sampleRate, bufferSize);
         toolsPanel.prepare(sampleRate, bufferSize);
         pluginHostPanel.prepare(sampleRate, bufferSize);
 
@@ -495,16 +521,13 @@ class MainComponent : public juce::Component,
                     }
                 }
             }
-
-            // BPM and Key detection
-            analysisPanel.processBlock(buffer);
         });
 
         // Set device started callback to prepare effect chain with correct sample rate
         audioEngine.setDeviceStartedCallback([this](double sampleRate, int blockSize)
         {
             pluginHostPanel.prepare(sampleRate, blockSize);
-            analysisPanel.prepare(sampleRate, blockSize);
+            analysisScheduler.prepare(sampleRate, blockSize);
             toolsPanel.prepare(sampleRate, blockSize);
         });
 
@@ -516,24 +539,20 @@ class MainComponent : public juce::Component,
             lastLevelUpdatePosition = position;
         });
 
-        // Setup spectrum analyzer callback from audio engine
-        audioEngine.setSpectrumCallback([this](float sample)
-        {
-            // Spectrum panel
-            spectrumPanel.pushNextSampleIntoFifo(sample);
+        // Attach displays and analyzers to the engine's analysis tap.
+        // Each one owns a reader and drains it from its own timer.
+        auto& analysisTap = audioEngine.getAnalysisTap();
+        spectrumPanel.setAnalysisTap(&analysisTap);
+        metersPanel.setAnalysisTap(&analysisTap);
 
-            // Analysis panel
-            analysisPanel.pushSample(sample);
+        if (auto* spectrum = multiViewContainer.getSpectrumDisplay())
+            spectrum->setAnalysisTap(&analysisTap);
+        if (auto* histogram = multiViewContainer.getHistogramDisplay())
+            histogram->setAnalysisTap(&analysisTap);
 
-            // Meters panel
-            metersPanel.pushSample(sample);
-
-            // Multi-view container
-            if (auto* spectrum = multiViewContainer.getSpectrumDisplay())
-                spectrum->pushNextSampleIntoFifo(sample);
-            if (auto* histogram = multiViewContainer.getHistogramDisplay())
-                histogram->pushSample(sample);
-        });
+        // Pitch, Harmonics, MFCC, BPM and Key run on the analysis worker pool
+        analysisPanel.setAnalysisScheduler(&analysisScheduler);
+        analysisScheduler.start();
 
         // Tab changed callback
         tabbedDisplay.setTabChangedCallback([this](int index, const juce::String& name)
@@ -612,6 +631,12 @@ class MainComponent : public juce::Component,
             loudnessMeter.setMomentaryLoudness(momentary);
             loudnessMeter.setLoudnessRange(lra);
         });
+
+        // Clicking the loudness meter restarts the integrated measurement
+        loudnessMeter.setResetCallback([this]()
+        {
+            audioEngine.resetLoudness();
+        });
     }
 
     void setupRecordingPanel()
@@ -772,6 +797,53 @@ class MainComponent : public juce::Component,
         // Create mixer panel
         mixerPanel = std::make_unique<MixerPanel>(projectManager);
 
+        // Both poll the engine's meters
+        multiTrackTimeline->setMeterSource(&multiTrackSource->getMeters());
+        mixerPanel->setMeterSource(&multiTrackSource->getMeters());
+
+        // Track and master inserts, edited from the mixer's FX buttons
+        mixerPanel->onEditInserts = [this](const juce::String& trackId)
+        {
+            auto title = trackId.isEmpty()
+                ? juce::String("Master")
+                : TrackModel(projectManager.getProject().findTrackById(trackId)).getName();
+
+            pluginHostPanel.showInsertMenu(title, [this, trackId]() -> EffectChain*
+            {
+                if (multiTrackSource == nullptr)
+                    return nullptr;
+
+                return trackId.isEmpty() ? &multiTrackSource->getMasterInserts()
+                                         : multiTrackSource->getTrackInserts(trackId);
+            });
+        };
+
+        multiTrackSource->onTrackInsertsReleased = [this](EffectChain& chain)
+        {
+            pluginHostPanel.closeEditorsFor(chain);
+        };
+
+        // Track freeze, from the mixer's freeze buttons
+        trackFreezer = std::make_unique<TrackFreezer>(projectManager, *multiTrackSource,
+                                                      audioEngine.getFormatManager());
+
+        trackFreezer->onFinished = [this](const juce::String&, bool, const juce::String& message)
+        {
+            statusBar.setText(message, juce::dontSendNotification);
+        };
+
+        mixerPanel->onToggleFreeze = [this](const juce::String& trackId)
+        {
+            if (TrackModel(projectManager.getProject().findTrackById(trackId)).isFrozen())
+            {
+                trackFreezer->unfreeze(trackId);
+                return;
+            }
+
+            auto error = trackFreezer->freeze(trackId);
+            statusBar.setText(error.isEmpty() ? "Freezing..." : error, juce::dontSendNotification);
+        };
+
         // Add to tabbed display
         tabbedDisplay.addTab("Multi-Track", multiTrackTimeline.get());
         tabbedDisplay.addTab("Mixer", mixerPanel.get());
@@ -1218,6 +1290,45 @@ class MainComponent : public juce::Component,
             audioEngine.play();
     }
 
+    void showBounceDialog()
+    {
+        auto name = projectManager.getProject().getProjectName();
+        auto defaultFile = juce::File::getSpecialLocation(juce::File::userMusicDirectory)
+                               .getChildFile(juce::File::createLegalFileName(name.isEmpty() ? "Mixdown" : name) + ".wav");
+
+        fileChooser = std::make_unique<juce::FileChooser>("Bounce project to", defaultFile, "*.wav;*.flac");
+
+        auto chooserFlags = juce::FileBrowserComponent::saveMode |
+                            juce::FileBrowserComponent::canSelectFiles |
+                            juce::FileBrowserComponent::warnAboutOverwriting;
+
+        fileChooser->launchAsync(chooserFlags, [this](const juce::FileChooser& fc)
+        {
+            auto file = fc.getResult();
+            if (file == juce::File())
+                return;
+
+            if (multiTrackSource == nullptr)
+                return;
+
+            if (projectBouncer == nullptr)
+            {
+                projectBouncer = std::make_unique<ProjectBouncer>(*multiTrackSource, audioEngine.getFormatManager());
+                projectBouncer->onFinished = [this](bool, const juce::String& message)
+                {
+                    statusBar.setText(message, juce::dontSendNotification);
+                };
+            }
+
+            // Whole project at its own rate, 24-bit
+            ProjectBouncer::Settings settings;
+            settings.outputFile = file.hasFileExtension("wav;flac") ? file : file.withFileExtension("wav");
+
+            auto error = projectBouncer->start(projectManager.getProjectState(), settings);
+            statusBar.setText(error.isEmpty() ? "Bouncing..." : error, juce::dontSendNotification);
+        });
+    }
+
     void showSettings()
     {
         auto* settingsDialog = new SettingsDialog(audioEngine.getDeviceManager());
@@ -1347,6 +1458,9 @@ class MainComponent : public juce::Component,
             menu.addSeparator();
             menu.addItem(fileNewProject, "New Multi-Track Project");
             menu.addItem(fileAddTrack, "Add Track");
+            menu.addItem(fileBounceProject, "Bounce Project...",
+                         projectManager.getProject().getNumTracks() > 0
+                             && (projectBouncer == nullptr || !projectBouncer->isRunning()));
             menu.addSeparator();
             menu.addItem(fileSettings, "Settings...     Cmd+,");
             menu.addSeparator();
@@ -1413,6 +1527,10 @@ class MainComponent : public juce::Component,
                 }
                 break;
 
+            case fileBounceProject:
+                showBounceDialog();
+                break;
+
             case fileSettings:
                 showSettings();
                 break;
@@ -1536,6 +1654,7 @@ class MainComponent : public juce::Component,
     //==========================================================================
     JapaneseLookAndFeel japaneseLookAndFeel;
     AudioEngine audioEngine;
+    AnalysisScheduler analysisScheduler { audioEngine.getAnalysisTap() };
 
     // UI Components
     PanelContainer mainPanelContainer { PanelContainer::Orientation::Horizontal };
@@ -1567,6 +1686,8 @@ class MainComponent : public juce::Component,
     std::unique_ptr<TimelinePanel> multiTrackTimeline;
     std::unique_ptr<MixerPanel> mixerPanel;
     std::unique_ptr<MultiTrackAudioSource> multiTrackSource;
+    std::unique_ptr<ProjectBouncer> projectBouncer;
+    std::unique_ptr<TrackFreezer> trackFreezer;
 
     MultiViewContainer multiViewContainer;
     ABCompareControl abCompareControl;
@@ -1606,6 +1727,14 @@ class SoundmanApplication : public juce::JUCEApplication
     //==========================================================================
     void initialise(const juce::String& commandLine) override
     {
+        // Started as a plugin scanner (see PluginManager): scan and exit
+        if (PluginManager::isScannerCommandLine(getCommandLineParameterArray()))
+        {
+            setApplicationReturnValue(PluginManager::runScanner(getCommandLineParameterArray()));
+            quit();
+            return;
+        }
+
         // Create and show the main window
         mainWindow.reset(new MainWindow(getApplicationName()));
     }
@@ -84,6 +84,11 @@ ABCompareControl::ABCompareControl()
     wetLabel.setJustificationType(juce::Justification::centredRight);
     wetLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
 
+    addAndMakeVisible(latencyLabel);
+    latencyLabel.setFont(juce::Font(10.0f));
+    latencyLabel.setJustificationType(juce::Justification::centred);
+    latencyLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+
     updateButtonStates();
     updateMixLabel();
 }
@@ -156,6 +161,7 @@ void ABCompareControl::resized()
     auto labelRow = bounds.removeFromTop(14);
     dryLabel.setBounds(labelRow.removeFromLeft(30));
     wetLabel.setBounds(labelRow.removeFromRight(30));
+    latencyLabel.setBounds(labelRow);
 
     // Mix slider
     mixSlider.setBounds(bounds.removeFromTop(20));
@@ -208,6 +214,26 @@ void ABCompareControl::toggleAB()
         setMode(CompareMode::A_Original);
 }
 
+void ABCompareControl::setLatency(int samples, double sampleRate)
+{
+    if (samples == latencySamples && sampleRate == latencySampleRate)
+        return;
+
+    latencySamples = samples;
+    latencySampleRate = sampleRate;
+
+    if (samples <= 0 || sampleRate <= 0.0)
+    {
+        latencyLabel.setText({}, juce::dontSendNotification);
+        return;
+    }
+
+    // The dry path is delayed to line up with the processed one
+    latencyLabel.setText("Dry +" + juce::String(samples) + " smp ("
+                         + juce::String(samples * 1000.0 / sampleRate, 1) + " ms)",
+                         juce::dontSendNotification);
+}
+
 void ABCompareControl::updateButtonStates()
 {
     buttonA.setColour(juce::TextButton::buttonColourId,
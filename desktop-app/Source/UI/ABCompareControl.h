@@ -42,6 +42,9 @@ class ABCompareControl : public juce::Component
     // Quick toggle between A and B
     void toggleAB();
 
+    // Processing latency the dry signal is delayed by, shown under the mix
+    void setLatency(int samples, double sampleRate);
+
     //==========================================================================
     // Callbacks
     std::function<void(CompareMode)> onModeChanged;
@@ -63,6 +66,10 @@ class ABCompareControl : public juce::Component
     juce::Label mixLabel;
     juce::Label dryLabel { {}, "Dry" };
     juce::Label wetLabel { {}, "Wet" };
+    juce::Label latencyLabel;
+
+    int latencySamples { 0 };
+    double latencySampleRate { 0.0 };
 
     juce::Colour activeColor { 0xff4a90e2 };
     juce::Colour inactiveColor { 0xff3a3a3a };
@@ -28,25 +28,13 @@ AnalysisPanel::AnalysisPanel()
 }
 
 //==============================================================================
-void AnalysisPanel::prepare(double sampleRate, int samplesPerBlock)
+void AnalysisPanel::setAnalysisScheduler(AnalysisScheduler* scheduler)
 {
-    // Only BPM and Key displays have prepare methods
-    bpmDisplay.prepare(sampleRate, samplesPerBlock);
-    keyDisplay.prepare(sampleRate, samplesPerBlock);
-    // PitchDisplay, HarmonicsDisplay, MFCCDisplay don't need explicit prepare
-}
-
-void AnalysisPanel::pushSample(float sample)
-{
-    pitchDisplay.pushSample(sample);
-    harmonicsDisplay.pushSample(sample);
-    mfccDisplay.pushSample(sample);
-}
-
-void AnalysisPanel::processBlock(const juce::AudioBuffer<float>& buffer)
-{
-    bpmDisplay.processBlock(buffer);
-    keyDisplay.processBlock(buffer);
+    pitchDisplay.setAnalysisScheduler(scheduler);
+    bpmDisplay.setAnalysisScheduler(scheduler);
+    keyDisplay.setAnalysisScheduler(scheduler);
+    harmonicsDisplay.setAnalysisScheduler(scheduler);
+    mfccDisplay.setAnalysisScheduler(scheduler);
 }
 
 //==============================================================================
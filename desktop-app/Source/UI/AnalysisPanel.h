@@ -16,6 +16,7 @@
 #include "KeyDisplay.h"
 #include "HarmonicsDisplay.h"
 #include "MFCCDisplay.h"
+#include "../Core/AnalysisScheduler.h"
 
 class AnalysisPanel : public juce::Component
 {
@@ -25,13 +26,9 @@ class AnalysisPanel : public juce::Component
     ~AnalysisPanel() override = default;
 
     //==========================================================================
-    void prepare(double sampleRate, int samplesPerBlock);
-
-    // Forward samples to all analyzers
-    void pushSample(float sample);
-
-    // Process audio block (for BPM and Key)
-    void processBlock(const juce::AudioBuffer<float>& buffer);
+    // Connect all displays to the background analysis scheduler
+    // (the analyzers themselves run on its worker pool)
+    void setAnalysisScheduler(AnalysisScheduler* scheduler);
 
     //==========================================================================
     void paint(juce::Graphics& g) override;
@@ -90,14 +90,12 @@ BPMDisplay::~BPMDisplay()
 }
 
 //==============================================================================
-void BPMDisplay::prepare(double sampleRate, int samplesPerBlock)
+void BPMDisplay::setAnalysisScheduler(AnalysisScheduler* scheduler)
 {
-    detector.prepare(sampleRate, samplesPerBlock);
-}
+    analysisScheduler = scheduler;
 
-void BPMDisplay::processBlock(const juce::AudioBuffer<float>& buffer)
-{
-    detector.processBlock(buffer);
+    if (analysisScheduler != nullptr)
+        analysisScheduler->setBPMRange((float)minBPMSlider.getValue(), (float)maxBPMSlider.getValue());
 }
 
 //==============================================================================
@@ -146,11 +144,19 @@ void BPMDisplay::resized()
 //==============================================================================
 void BPMDisplay::timerCallback()
 {
-    displayBPM = detector.getBPM();
-    displayConfidence = detector.getConfidence();
+    if (analysisScheduler == nullptr)
+        return;
 
-    // Beat flash effect
-    if (detector.isBeatDetected())
+    analysisScheduler->getBPMSnapshot(latestSnapshot);
+
+    displayBPM = latestSnapshot.result.bpm;
+    displayConfidence = latestSnapshot.result.confidence;
+
+    // Beat flash effect (any beat since the last frame)
+    bool beatSinceLastFrame = latestSnapshot.result.beatCount != lastBeatCount;
+    lastBeatCount = latestSnapshot.result.beatCount;
+
+    if (beatSinceLastFrame)
     {
         beatFlash = true;
         beatFlashCounter = 5;  // Flash for 5 frames
@@ -170,7 +176,8 @@ void BPMDisplay::sliderValueChanged(juce::Slider* slider)
     if (slider == &minBPMSlider)
     {
         float minBPM = (float)minBPMSlider.getValue();
-        detector.setMinBPM(minBPM);
+        if (analysisScheduler != nullptr)
+            analysisScheduler->setBPMRange(minBPM, juce::jmax(minBPM + 10.0f, (float)maxBPMSlider.getValue()));
 
         // Ensure max is greater than min
         if (maxBPMSlider.getValue() <= minBPM)
@@ -179,7 +186,8 @@ void BPMDisplay::sliderValueChanged(juce::Slider* slider)
     else if (slider == &maxBPMSlider)
     {
         float maxBPM = (float)maxBPMSlider.getValue();
-        detector.setMaxBPM(maxBPM);
+        if (analysisScheduler != nullptr)
+            analysisScheduler->setBPMRange(juce::jmin(maxBPM - 10.0f, (float)minBPMSlider.getValue()), maxBPM);
 
         // Ensure min is less than max
         if (minBPMSlider.getValue() >= maxBPM)
@@ -271,7 +279,7 @@ void BPMDisplay::drawOnsetGraph(juce::Graphics& g, const juce::Rectangle<int>& b
     g.drawHorizontalLine(graphBounds.getCentreY(), (float)graphBounds.getX(), (float)graphBounds.getRight());
 
     // Draw onset strength
-    const auto& onset = detector.getOnsetStrength();
+    const auto& onset = latestSnapshot.result.onsetStrength;
     if (onset.empty())
         return;
 
@@ -308,7 +316,7 @@ void BPMDisplay::drawOnsetGraph(juce::Graphics& g, const juce::Rectangle<int>& b
         g.setFont(juce::Font(10.0f));
         g.drawText("Autocorrelation", autoArea.getX(), autoArea.getY() - 15, 100, 12, juce::Justification::centredLeft);
 
-        const auto& autocorr = detector.getAutocorrelation();
+        const auto& autocorr = latestSnapshot.result.autocorrelation;
         if (!autocorr.empty())
         {
             juce::Path autoPath;
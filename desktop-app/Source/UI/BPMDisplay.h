@@ -12,6 +12,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../DSP/BPMDetector.h"
+#include "../Core/AnalysisScheduler.h"
 
 class BPMDisplay : public juce::Component,
                    public juce::Timer,
@@ -23,8 +24,8 @@ class BPMDisplay : public juce::Component,
     ~BPMDisplay() override;
 
     //==========================================================================
-    void prepare(double sampleRate, int samplesPerBlock);
-    void processBlock(const juce::AudioBuffer<float>& buffer);
+    // Read results from the background analysis scheduler (nullptr to detach)
+    void setAnalysisScheduler(AnalysisScheduler* scheduler);
 
     //==========================================================================
     // Component overrides
@@ -44,7 +45,9 @@ class BPMDisplay : public juce::Component,
     void drawBeatIndicator(juce::Graphics& g, const juce::Rectangle<int>& bounds);
 
     //==========================================================================
-    BPMDetector detector;
+    AnalysisScheduler* analysisScheduler { nullptr };
+    AnalysisScheduler::BPMSnapshot latestSnapshot;
+    juce::uint32 lastBeatCount { 0 };
 
     // Display values
     float displayBPM { 0.0f };
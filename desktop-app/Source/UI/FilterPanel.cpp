@@ -10,6 +10,7 @@
 
 #include "FilterPanel.h"
 #include <cmath>
+#include <vector>
 
 //==============================================================================
 FilterPanel::FilterPanel()
@@ -352,24 +353,28 @@ void FilterPanel::drawFrequencyResponse(juce::Graphics& g, const juce::Rectangle
     bool pathStarted = false;
 
     const int numPoints = chartBounds.getWidth();
+    if (numPoints <= 0)
+        return;
+
+    // The whole curve at once: the EQ evaluates all its bands in a few
+    // vectorised passes
+    std::vector<float> frequencies((size_t)numPoints);
+    std::vector<float> filterMagnitudes((size_t)numPoints, 1.0f);
+    std::vector<float> eqMagnitudes((size_t)numPoints, 1.0f);
+
     for (int i = 0; i < numPoints; ++i)
-    {
-        float x = (float)i;
-        float freq = 20.0f * std::pow(1000.0f, x / (float)numPoints);
+        frequencies[(size_t)i] = 20.0f * std::pow(1000.0f, (float)i / (float)numPoints);
 
-        float magnitude = 1.0f;
+    if (filter.isEnabled())
+        filter.getMagnitudeForFrequencyArray(frequencies.data(), filterMagnitudes.data(), numPoints);
 
-        // Apply filter magnitude
-        if (filter.isEnabled())
-        {
-            magnitude *= filter.getMagnitudeForFrequency(freq);
-        }
+    if (eq.isEnabled())
+        eq.getMagnitudeForFrequencyArray(frequencies.data(), eqMagnitudes.data(), numPoints);
 
-        // Apply EQ magnitude
-        if (eq.isEnabled())
-        {
-            magnitude *= eq.getMagnitudeForFrequency(freq);
-        }
+    for (int i = 0; i < numPoints; ++i)
+    {
+        float x = (float)i;
+        float magnitude = filterMagnitudes[(size_t)i] * eqMagnitudes[(size_t)i];
 
         float gainDb = juce::Decibels::gainToDecibels(magnitude);
         gainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
@@ -36,16 +36,6 @@ void HarmonicsDisplay::setAnalysisResult(const HarmonicsAnalyzer::AnalysisResult
     }
 }
 
-void HarmonicsDisplay::pushSample(float sample)
-{
-    analyzer.pushSample(sample);
-}
-
-void HarmonicsDisplay::setSampleRate(double rate)
-{
-    analyzer.setSampleRate(rate);
-}
-
 //==============================================================================
 void HarmonicsDisplay::paint(juce::Graphics& g)
 {
@@ -81,8 +71,11 @@ void HarmonicsDisplay::resized()
 
 void HarmonicsDisplay::timerCallback()
 {
-    auto result = analyzer.getLatestAnalysis();
-    setAnalysisResult(result);
+    if (analysisScheduler == nullptr)
+        return;
+
+    analysisScheduler->getHarmonicsSnapshot(latestSnapshot);
+    setAnalysisResult(latestSnapshot.result);
     repaint();
 }
 
@@ -12,6 +12,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../DSP/HarmonicsAnalyzer.h"
+#include "../Core/AnalysisScheduler.h"
 
 class HarmonicsDisplay : public juce::Component,
                          public juce::Timer
@@ -25,11 +26,8 @@ class HarmonicsDisplay : public juce::Component,
     // Update harmonic data
     void setAnalysisResult(const HarmonicsAnalyzer::AnalysisResult& result);
 
-    // Direct sample input (uses internal analyzer)
-    void pushSample(float sample);
-
-    // Set sample rate for internal analyzer
-    void setSampleRate(double rate);
+    // Read results from the background analysis scheduler (nullptr to detach)
+    void setAnalysisScheduler(AnalysisScheduler* scheduler) { analysisScheduler = scheduler; }
 
     //==========================================================================
     // Display settings
@@ -59,7 +57,8 @@ class HarmonicsDisplay : public juce::Component,
     float dbToY(float db, float height) const;
 
     //==========================================================================
-    HarmonicsAnalyzer analyzer;
+    AnalysisScheduler* analysisScheduler { nullptr };
+    AnalysisScheduler::HarmonicsSnapshot latestSnapshot;
     HarmonicsAnalyzer::AnalysisResult currentResult;
 
     // Display settings
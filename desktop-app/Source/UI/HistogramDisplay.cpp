@@ -72,6 +72,20 @@ void HistogramDisplay::clear()
     maxBinValue = 1;
 }
 
+//==============================================================================
+void HistogramDisplay::setAnalysisTap(AnalysisTap* tap)
+{
+    tapReader = tap != nullptr ? std::make_unique<AnalysisTap::Reader>(*tap) : nullptr;
+}
+
+void HistogramDisplay::drainAnalysisTap()
+{
+    if (tapReader == nullptr)
+        return;
+
+    tapReader->drainMono([this](float sample) { pushSample(sample); });
+}
+
 //==============================================================================
 void HistogramDisplay::paint(juce::Graphics& g)
 {
@@ -153,6 +167,8 @@ void HistogramDisplay::resized()
 
 void HistogramDisplay::timerCallback()
 {
+    drainAnalysisTap();
+
     // Apply decay to histogram
     {
         juce::ScopedLock lock(histogramLock);
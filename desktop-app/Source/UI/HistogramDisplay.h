@@ -11,6 +11,8 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
+#include "../Core/AnalysisTap.h"
+#include <memory>
 #include <vector>
 
 class HistogramDisplay : public juce::Component,
@@ -25,6 +27,9 @@ class HistogramDisplay : public juce::Component,
     // Add sample for histogram
     void pushSample(float sample);
 
+    // Drain samples from the engine's analysis tap on the timer (nullptr to detach)
+    void setAnalysisTap(AnalysisTap* tap);
+
     // Clear the histogram
     void clear();
 
@@ -39,6 +44,8 @@ class HistogramDisplay : public juce::Component,
 
 private:
     //==========================================================================
+    void drainAnalysisTap();
+
     void drawHistogram(juce::Graphics& g, const juce::Rectangle<int>& bounds);
     void drawGrid(juce::Graphics& g, const juce::Rectangle<int>& bounds);
 
@@ -55,6 +62,10 @@ class HistogramDisplay : public juce::Component,
     // Precomputed bar colors
     std::vector<juce::Colour> barColors;
 
+    //==========================================================================
+    // Analysis tap reader (message thread)
+    std::unique_ptr<AnalysisTap::Reader> tapReader;
+
     //==========================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HistogramDisplay)
 };
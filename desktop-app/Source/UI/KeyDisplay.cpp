@@ -21,17 +21,6 @@ KeyDisplay::~KeyDisplay()
     stopTimer();
 }
 
-//==============================================================================
-void KeyDisplay::prepare(double sampleRate, int samplesPerBlock)
-{
-    detector.prepare(sampleRate, samplesPerBlock);
-}
-
-void KeyDisplay::processBlock(const juce::AudioBuffer<float>& buffer)
-{
-    detector.processBlock(buffer);
-}
-
 //==============================================================================
 void KeyDisplay::paint(juce::Graphics& g)
 {
@@ -61,10 +50,15 @@ void KeyDisplay::resized()
 //==============================================================================
 void KeyDisplay::timerCallback()
 {
-    displayKey = detector.getDetectedKey();
-    displayConfidence = detector.getConfidence();
-    displayChroma = detector.getChroma();
-    displayCorrelations = detector.getKeyCorrelations();
+    if (analysisScheduler == nullptr)
+        return;
+
+    analysisScheduler->getKeySnapshot(latestSnapshot);
+
+    displayKey = latestSnapshot.result.key;
+    displayConfidence = latestSnapshot.result.confidence;
+    displayChroma = latestSnapshot.result.chroma;
+    displayCorrelations = latestSnapshot.result.correlations;
 
     repaint();
 }
@@ -12,6 +12,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../DSP/KeyDetector.h"
+#include "../Core/AnalysisScheduler.h"
 
 class KeyDisplay : public juce::Component,
                    public juce::Timer
@@ -22,8 +23,8 @@ class KeyDisplay : public juce::Component,
     ~KeyDisplay() override;
 
     //==========================================================================
-    void prepare(double sampleRate, int samplesPerBlock);
-    void processBlock(const juce::AudioBuffer<float>& buffer);
+    // Read results from the background analysis scheduler (nullptr to detach)
+    void setAnalysisScheduler(AnalysisScheduler* scheduler) { analysisScheduler = scheduler; }
 
     //==========================================================================
     // Component overrides
@@ -40,7 +41,8 @@ class KeyDisplay : public juce::Component,
     void drawCircleOfFifths(juce::Graphics& g, const juce::Rectangle<int>& bounds);
 
     //==========================================================================
-    KeyDetector detector;
+    AnalysisScheduler* analysisScheduler { nullptr };
+    AnalysisScheduler::KeySnapshot latestSnapshot;
 
     // Display values
     KeyDetector::Key displayKey { KeyDetector::Key::Unknown };
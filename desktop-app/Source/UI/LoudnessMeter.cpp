@@ -99,6 +99,10 @@ void LoudnessMeter::resized()
 void LoudnessMeter::mouseDown(const juce::MouseEvent& /*event*/)
 {
     reset();
+
+    if (resetCallback)
+        resetCallback();
+
     repaint();
 }
 
@@ -12,6 +12,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <atomic>
+#include <functional>
 
 class LoudnessMeter : public juce::Component,
                       public juce::Timer
@@ -31,6 +32,10 @@ class LoudnessMeter : public juce::Component,
     // Reset measurements
     void reset();
 
+    // Called when the user clicks the meter to restart the measurement
+    using ResetCallback = std::function<void()>;
+    void setResetCallback(ResetCallback callback) { resetCallback = callback; }
+
     //==========================================================================
     // Component overrides
     void paint(juce::Graphics& g) override;
@@ -65,6 +70,8 @@ class LoudnessMeter : public juce::Component,
 
     static constexpr float SMOOTHING = 0.85f;
 
+    ResetCallback resetCallback;
+
     // Broadcast standards reference levels
     static constexpr float TARGET_LEVEL = -23.0f;     // EBU R128 target
     static constexpr float MAX_SHORT_TERM = -18.0f;   // Maximum short-term
@@ -54,16 +54,6 @@ void MFCCDisplay::setMFCCResult(const MFCCAnalyzer::MFCCResult& result)
     }
 }
 
-void MFCCDisplay::pushSample(float sample)
-{
-    analyzer.pushSample(sample);
-}
-
-void MFCCDisplay::setSampleRate(double rate)
-{
-    analyzer.setSampleRate(rate);
-}
-
 void MFCCDisplay::setHistoryLength(int length)
 {
     maxHistoryLength = juce::jmax(10, length);
@@ -113,8 +103,13 @@ void MFCCDisplay::resized()
 
 void MFCCDisplay::timerCallback()
 {
-    auto result = analyzer.getLatestResult();
-    setMFCCResult(result);
+    if (analysisScheduler == nullptr)
+        return;
+
+    // Only new frames extend the history
+    if (analysisScheduler->getMFCCSnapshot(latestSnapshot))
+        setMFCCResult(latestSnapshot.result);
+
     repaint();
 }
 
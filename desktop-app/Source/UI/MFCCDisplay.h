@@ -12,6 +12,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../DSP/MFCCAnalyzer.h"
+#include "../Core/AnalysisScheduler.h"
 #include <deque>
 
 class MFCCDisplay : public juce::Component,
@@ -26,11 +27,8 @@ class MFCCDisplay : public juce::Component,
     // Update MFCC data
     void setMFCCResult(const MFCCAnalyzer::MFCCResult& result);
 
-    // Direct sample input (uses internal analyzer)
-    void pushSample(float sample);
-
-    // Set sample rate for internal analyzer
-    void setSampleRate(double rate);
+    // Read results from the background analysis scheduler (nullptr to detach)
+    void setAnalysisScheduler(AnalysisScheduler* scheduler) { analysisScheduler = scheduler; }
 
     //==========================================================================
     // Display settings
@@ -58,7 +56,8 @@ class MFCCDisplay : public juce::Component,
     juce::Colour getMelColor(float normalizedValue) const;
 
     //==========================================================================
-    MFCCAnalyzer analyzer;
+    AnalysisScheduler* analysisScheduler { nullptr };
+    AnalysisScheduler::MFCCSnapshot latestSnapshot;
     MFCCAnalyzer::MFCCResult currentResult;
 
     // MFCC history for visualization
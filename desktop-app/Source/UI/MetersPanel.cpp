@@ -25,9 +25,9 @@ MetersPanel::MetersPanel()
 }
 
 //==============================================================================
-void MetersPanel::pushSample(float sample)
+void MetersPanel::setAnalysisTap(AnalysisTap* tap)
 {
-    histogramDisplay.pushSample(sample);
+    histogramDisplay.setAnalysisTap(tap);
 }
 
 void MetersPanel::pushStereoSample(float left, float right)
@@ -13,6 +13,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "VectorscopeDisplay.h"
 #include "HistogramDisplay.h"
+#include "../Core/AnalysisTap.h"
 
 class MetersPanel : public juce::Component
 {
@@ -22,8 +23,10 @@ class MetersPanel : public juce::Component
     ~MetersPanel() override = default;
 
     //==========================================================================
-    // Forward samples
-    void pushSample(float sample);
+    // Attach the histogram to the engine's analysis tap
+    void setAnalysisTap(AnalysisTap* tap);
+
+    // Forward stereo level pairs to the vectorscope
     void pushStereoSample(float left, float right);
 
     // Access for multi-view
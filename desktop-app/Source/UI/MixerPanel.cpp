@@ -235,6 +235,21 @@ void ChannelStripComponent::setupComponents()
     };
     addAndMakeVisible(armButton);
 
+    // Insert chain
+    insertsButton.onClick = [this]() {
+        if (onInsertsClicked)
+            onInsertsClicked();
+    };
+    addAndMakeVisible(insertsButton);
+
+    // Freeze (lit while frozen)
+    freezeButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::lightblue.darker());
+    freezeButton.onClick = [this]() {
+        if (onFreezeClicked)
+            onFreezeClicked();
+    };
+    addAndMakeVisible(freezeButton);
+
     // Level label
     levelLabel.setJustificationType(juce::Justification::centred);
     levelLabel.setFont(juce::Font(10.0f));
@@ -279,6 +294,13 @@ void ChannelStripComponent::resized()
 
     bounds.removeFromTop(4);
 
+    // Inserts and freeze
+    auto insertsRow = bounds.removeFromTop(20);
+    insertsButton.setBounds(insertsRow.removeFromLeft((insertsRow.getWidth() - 2) / 2));
+    insertsRow.removeFromLeft(2);
+    freezeButton.setBounds(insertsRow);
+    bounds.removeFromTop(4);
+
     // Pan knob
     panKnob.setBounds(bounds.removeFromTop(40));
     bounds.removeFromTop(4);
@@ -308,6 +330,7 @@ void ChannelStripComponent::updateFromState()
     muteButton.setToggleState(track.isMuted(), juce::dontSendNotification);
     soloButton.setToggleState(track.isSoloed(), juce::dontSendNotification);
     armButton.setToggleState(track.isArmed(), juce::dontSendNotification);
+    freezeButton.setToggleState(track.isFrozen(), juce::dontSendNotification);
 
     updateLevelLabel();
     repaint();
@@ -324,6 +347,12 @@ void ChannelStripComponent::setMeterLevels(float left, float right)
     meter.setPeakHold(left, right);
 }
 
+void ChannelStripComponent::setMeterLevels(const TrackMeterBank::Levels& levels)
+{
+    meter.setLevel(levels.rmsLeft, levels.rmsRight);
+    meter.setPeakHold(levels.peakLeft, levels.peakRight);
+}
+
 void ChannelStripComponent::updateLevelLabel()
 {
     float volume = static_cast<float>(faderSlider.getValue());
@@ -368,6 +397,13 @@ void MasterChannelStripComponent::setupComponents()
     };
     addAndMakeVisible(panKnob);
 
+    // Insert chain
+    insertsButton.onClick = [this]() {
+        if (onInsertsClicked)
+            onInsertsClicked();
+    };
+    addAndMakeVisible(insertsButton);
+
     // Meter
     addAndMakeVisible(meter);
 
@@ -406,6 +442,10 @@ void MasterChannelStripComponent::resized()
     nameLabel.setBounds(bounds.removeFromTop(24));
     bounds.removeFromTop(8);
 
+    // Inserts
+    insertsButton.setBounds(bounds.removeFromTop(20));
+    bounds.removeFromTop(4);
+
     // Pan knob
     panKnob.setBounds(bounds.removeFromTop(40));
     bounds.removeFromTop(4);
@@ -438,6 +478,12 @@ void MasterChannelStripComponent::setMeterLevels(float left, float right)
     meter.setPeakHold(left, right);
 }
 
+void MasterChannelStripComponent::setMeterLevels(const TrackMeterBank::Levels& levels)
+{
+    meter.setLevel(levels.rmsLeft, levels.rmsRight);
+    meter.setPeakHold(levels.peakLeft, levels.peakRight);
+}
+
 void MasterChannelStripComponent::updateLevelLabel()
 {
     float volume = static_cast<float>(faderSlider.getValue());
@@ -461,6 +507,10 @@ MixerPanel::MixerPanel(ProjectManager& pm)
 
     // Create master strip
     masterStrip = std::make_unique<MasterChannelStripComponent>(projectManager);
+    masterStrip->onInsertsClicked = [this]() {
+        if (onEditInserts)
+            onEditInserts({});
+    };
     addAndMakeVisible(masterStrip.get());
 
     rebuildStrips();
@@ -499,6 +549,18 @@ void MixerPanel::timerCallback()
 {
     // Update master strip from project (in case external changes)
     masterStrip->updateFromProject();
+
+    // Levels since the last tick, one lookup per strip
+    if (meterSource != nullptr)
+    {
+        TrackMeterBank::Levels levels;
+
+        for (auto* strip : channelStrips)
+            if (meterSource->getTrackLevels(strip->getTrackId(), levels))
+                strip->setMeterLevels(levels);
+
+        masterStrip->setMeterLevels(meterSource->getMasterLevels());
+    }
 }
 
 void MixerPanel::projectChanged()
@@ -562,6 +624,14 @@ void MixerPanel::rebuildStrips()
     for (auto& trackState : tracks)
     {
         auto* strip = new ChannelStripComponent(projectManager, trackState);
+        strip->onInsertsClicked = [this, trackId = strip->getTrackId()]() {
+            if (onEditInserts)
+                onEditInserts(trackId);
+        };
+        strip->onFreezeClicked = [this, trackId = strip->getTrackId()]() {
+            if (onToggleFreeze)
+                onToggleFreeze(trackId);
+        };
         channelStrips.add(strip);
         stripContainer.addAndMakeVisible(strip);
     }
@@ -14,6 +14,7 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "../Core/ProjectModel.h"
 #include "../Core/ProjectManager.h"
+#include "../Core/TrackMeterBank.h"
 
 //==============================================================================
 // Forward declarations
@@ -93,6 +94,12 @@ class ChannelStripComponent : public juce::Component
     // Set levels for metering
     void setMeterLevels(float left, float right);
 
+    // RMS as the bar, peak as the hold
+    void setMeterLevels(const TrackMeterBank::Levels& levels);
+
+    std::function<void()> onInsertsClicked;
+    std::function<void()> onFreezeClicked;
+
 private:
     ProjectManager& projectManager;
     juce::ValueTree state;
@@ -105,6 +112,8 @@ class ChannelStripComponent : public juce::Component
     juce::TextButton muteButton { "M" };
     juce::TextButton soloButton { "S" };
     juce::TextButton armButton { "R" };
+    juce::TextButton insertsButton { "FX" };
+    juce::TextButton freezeButton { "Frz" };
     juce::Label levelLabel;
 
     juce::Colour trackColor;
@@ -130,6 +139,9 @@ class MasterChannelStripComponent : public juce::Component
 
     void updateFromProject();
     void setMeterLevels(float left, float right);
+    void setMeterLevels(const TrackMeterBank::Levels& levels);
+
+    std::function<void()> onInsertsClicked;
 
 private:
     ProjectManager& projectManager;
@@ -139,6 +151,7 @@ class MasterChannelStripComponent : public juce::Component
     juce::Slider faderSlider;
     PanKnobComponent panKnob;
     ChannelMeterComponent meter;
+    juce::TextButton insertsButton { "FX" };
     juce::Label levelLabel;
 
     void setupComponents();
@@ -179,14 +192,27 @@ class MixerPanel : public juce::Component,
     // Metering
     //==========================================================================
 
-    // Set levels for a specific track (called from audio thread)
+    // Set levels for a specific track
     void setTrackLevels(const juce::String& trackId, float left, float right);
 
     // Set master levels
     void setMasterLevels(float left, float right);
 
+    // Meters polled by the timer (the engine's); nullptr stops polling
+    void setMeterSource(TrackMeterBank* meters) { meterSource = meters; }
+
+    //==========================================================================
+    // Inserts
+
+    // A strip's FX button; an empty ID is the master
+    std::function<void(const juce::String& trackId)> onEditInserts;
+
+    // A strip's freeze button: freeze the track, or unfreeze it if it's frozen
+    std::function<void(const juce::String& trackId)> onToggleFreeze;
+
 private:
     ProjectManager& projectManager;
+    TrackMeterBank* meterSource { nullptr };
 
     // UI Components
     juce::Viewport viewport;
@@ -21,9 +21,11 @@ PitchDisplay::PitchDisplay()
 
 void PitchDisplay::setupControls()
 {
+    const PitchDetector defaults;
+
     // Threshold slider (0.1 - 0.8)
     thresholdSlider.setRange(0.1, 0.8, 0.05);
-    thresholdSlider.setValue(pitchDetector.getThreshold());
+    thresholdSlider.setValue(defaults.getThreshold());
     thresholdSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     thresholdSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     thresholdSlider.addListener(this);
@@ -35,12 +37,12 @@ void PitchDisplay::setupControls()
 
     thresholdValueLabel.setFont(juce::Font(11.0f));
     thresholdValueLabel.setColour(juce::Label::textColourId, juce::Colours::white);
-    thresholdValueLabel.setText(juce::String(pitchDetector.getThreshold(), 2), juce::dontSendNotification);
+    thresholdValueLabel.setText(juce::String(defaults.getThreshold(), 2), juce::dontSendNotification);
     addAndMakeVisible(thresholdValueLabel);
 
     // Min frequency slider (20 - 500 Hz)
     minFreqSlider.setRange(20, 500, 1);
-    minFreqSlider.setValue(pitchDetector.getMinFrequency());
+    minFreqSlider.setValue(defaults.getMinFrequency());
     minFreqSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     minFreqSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     minFreqSlider.setSkewFactorFromMidPoint(100);
@@ -53,12 +55,12 @@ void PitchDisplay::setupControls()
 
     minFreqValueLabel.setFont(juce::Font(11.0f));
     minFreqValueLabel.setColour(juce::Label::textColourId, juce::Colours::white);
-    minFreqValueLabel.setText(juce::String((int)pitchDetector.getMinFrequency()) + " Hz", juce::dontSendNotification);
+    minFreqValueLabel.setText(juce::String((int)defaults.getMinFrequency()) + " Hz", juce::dontSendNotification);
     addAndMakeVisible(minFreqValueLabel);
 
     // Max frequency slider (500 - 5000 Hz)
     maxFreqSlider.setRange(500, 5000, 10);
-    maxFreqSlider.setValue(pitchDetector.getMaxFrequency());
+    maxFreqSlider.setValue(defaults.getMaxFrequency());
     maxFreqSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     maxFreqSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     maxFreqSlider.setSkewFactorFromMidPoint(1500);
@@ -71,7 +73,7 @@ void PitchDisplay::setupControls()
 
     maxFreqValueLabel.setFont(juce::Font(11.0f));
     maxFreqValueLabel.setColour(juce::Label::textColourId, juce::Colours::white);
-    maxFreqValueLabel.setText(juce::String((int)pitchDetector.getMaxFrequency()) + " Hz", juce::dontSendNotification);
+    maxFreqValueLabel.setText(juce::String((int)defaults.getMaxFrequency()) + " Hz", juce::dontSendNotification);
     addAndMakeVisible(maxFreqValueLabel);
 }
 
@@ -79,17 +81,20 @@ void PitchDisplay::sliderValueChanged(juce::Slider* slider)
 {
     if (slider == &thresholdSlider)
     {
-        pitchDetector.setThreshold((float)thresholdSlider.getValue());
+        if (analysisScheduler != nullptr)
+            analysisScheduler->setPitchThreshold((float)thresholdSlider.getValue());
         thresholdValueLabel.setText(juce::String(thresholdSlider.getValue(), 2), juce::dontSendNotification);
     }
     else if (slider == &minFreqSlider)
     {
-        pitchDetector.setMinFrequency((float)minFreqSlider.getValue());
+        if (analysisScheduler != nullptr)
+            analysisScheduler->setPitchFrequencyRange((float)minFreqSlider.getValue(), (float)maxFreqSlider.getValue());
         minFreqValueLabel.setText(juce::String((int)minFreqSlider.getValue()) + " Hz", juce::dontSendNotification);
     }
     else if (slider == &maxFreqSlider)
     {
-        pitchDetector.setMaxFrequency((float)maxFreqSlider.getValue());
+        if (analysisScheduler != nullptr)
+            analysisScheduler->setPitchFrequencyRange((float)minFreqSlider.getValue(), (float)maxFreqSlider.getValue());
         maxFreqValueLabel.setText(juce::String((int)maxFreqSlider.getValue()) + " Hz", juce::dontSendNotification);
     }
 }
@@ -127,14 +132,16 @@ void PitchDisplay::setPitchResult(const PitchDetector::PitchResult& result)
     }
 }
 
-void PitchDisplay::pushSample(float sample)
+void PitchDisplay::setAnalysisScheduler(AnalysisScheduler* scheduler)
 {
-    pitchDetector.pushSample(sample);
-}
+    analysisScheduler = scheduler;
 
-void PitchDisplay::setSampleRate(double rate)
-{
-    pitchDetector.setSampleRate(rate);
+    // Push the current control values to the new scheduler
+    if (analysisScheduler != nullptr)
+    {
+        analysisScheduler->setPitchThreshold((float)thresholdSlider.getValue());
+        analysisScheduler->setPitchFrequencyRange((float)minFreqSlider.getValue(), (float)maxFreqSlider.getValue());
+    }
 }
 
 void PitchDisplay::setHistoryLength(int length)
@@ -233,9 +240,12 @@ void PitchDisplay::resized()
 
 void PitchDisplay::timerCallback()
 {
-    // Get latest pitch from internal detector
-    auto result = pitchDetector.getLatestPitch();
-    setPitchResult(result);
+    // Get latest pitch from the analysis worker
+    if (analysisScheduler == nullptr)
+        return;
+
+    analysisScheduler->getPitchSnapshot(latestSnapshot);
+    setPitchResult(latestSnapshot.result);
     repaint();
 }
 
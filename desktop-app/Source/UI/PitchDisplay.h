@@ -12,6 +12,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../DSP/PitchDetector.h"
+#include "../Core/AnalysisScheduler.h"
 #include <deque>
 
 class PitchDisplay : public juce::Component,
@@ -31,11 +32,8 @@ class PitchDisplay : public juce::Component,
     // Update pitch data
     void setPitchResult(const PitchDetector::PitchResult& result);
 
-    // Direct sample input (uses internal pitch detector)
-    void pushSample(float sample);
-
-    // Set sample rate for internal detector
-    void setSampleRate(double rate);
+    // Read results from the background analysis scheduler (nullptr to detach)
+    void setAnalysisScheduler(AnalysisScheduler* scheduler);
 
     //==========================================================================
     // Display settings
@@ -63,7 +61,8 @@ class PitchDisplay : public juce::Component,
     juce::Colour getNoteColor(int midiNote) const;
 
     //==========================================================================
-    PitchDetector pitchDetector;
+    AnalysisScheduler* analysisScheduler { nullptr };
+    AnalysisScheduler::PitchSnapshot latestSnapshot;
     PitchDetector::PitchResult currentPitch;
 
     // Pitch history for visualization
@@ -66,13 +66,37 @@ void PluginSlotComponent::paint(juce::Graphics& g)
     g.setFont(12.0f);
     g.drawText(juce::String(index + 1), bounds.removeFromLeft(25), juce::Justification::centred);
 
-    // Plugin name
-    auto textBounds = bounds.reduced(5);
+    // Plugin name, DSP load below it
+    auto textBounds = bounds.reduced(5, 2);
     textBounds.removeFromRight(180); // Space for buttons
+    auto loadBounds = textBounds.removeFromBottom(textBounds.getHeight() / 2);
+
     g.setFont(14.0f);
     if (isBypassed)
         g.setColour(juce::Colours::grey);
     g.drawText(pluginName, textBounds, juce::Justification::centredLeft);
+
+    if (load.numBlocks == 0)
+        return;
+
+    // Red once the p99 crosses the spike threshold, orange past half of it
+    if (load.p99Percent >= loadSpikeThreshold)
+        g.setColour(juce::Colour(0xffe24a4a));
+    else if (load.p99Percent >= loadSpikeThreshold * 0.5f)
+        g.setColour(juce::Colour(0xffe2a04a));
+    else
+        g.setColour(juce::Colours::lightgrey);
+
+    juce::String text;
+    text << "DSP " << juce::String(load.meanPercent, 1) << "% avg  "
+         << juce::String(load.p99Percent, 1) << "% p99  "
+         << juce::String(load.minPercent, 1) << "-" << juce::String(load.maxPercent, 1) << "%";
+
+    if (load.numSpikes > 0)
+        text << "  " << load.numSpikes << (load.numSpikes == 1 ? " spike" : " spikes");
+
+    g.setFont(11.0f);
+    g.drawText(text, loadBounds, juce::Justification::centredLeft);
 }
 
 void PluginSlotComponent::resized()
@@ -86,6 +110,17 @@ void PluginSlotComponent::resized()
     editButton.setBounds(buttonArea.removeFromRight(60).reduced(2));
 }
 
+void PluginSlotComponent::setLoad(const PluginLoadMeter::Stats& stats, float spikeThreshold)
+{
+    if (stats.numBlocks == load.numBlocks && stats.numSpikes == load.numSpikes
+        && spikeThreshold == loadSpikeThreshold)
+        return;
+
+    load = stats;
+    loadSpikeThreshold = spikeThreshold;
+    repaint();
+}
+
 void PluginSlotComponent::setBypassed(bool bypassed)
 {
     isBypassed = bypassed;
@@ -235,6 +270,12 @@ EffectChainComponent::EffectChainComponent(EffectChain& chain)
         refreshChain();
     };
 
+    addAndMakeVisible(resetLoadButton);
+    resetLoadButton.onClick = [this]()
+    {
+        effectChain.resetPluginLoads();
+    };
+
     addAndMakeVisible(bypassChainButton);
     bypassChainButton.onClick = [this]()
     {
@@ -294,6 +335,7 @@ void EffectChainComponent::resized()
     auto headerArea = bounds.removeFromTop(30);
     titleLabel.setBounds(headerArea.removeFromLeft(150));
     clearAllButton.setBounds(headerArea.removeFromRight(80).reduced(2));
+    resetLoadButton.setBounds(headerArea.removeFromRight(90).reduced(2));
     bypassChainButton.setBounds(headerArea.removeFromRight(100).reduced(2));
 
     bounds.removeFromTop(10);
@@ -354,10 +396,18 @@ void EffectChainComponent::refreshChain()
         }
     }
 
+    updateLoads();
+
     resized();
     repaint();
 }
 
+void EffectChainComponent::updateLoads()
+{
+    for (auto* slot : slotComponents)
+        slot->setLoad(effectChain.getPluginLoad(slot->getSlotIndex()), effectChain.getLoadSpikeThreshold());
+}
+
 //==============================================================================
 // PluginEditorWindow
 //==============================================================================
@@ -397,6 +447,7 @@ PluginHostPanel::PluginHostPanel()
 
     chainComponent->onSlotRemoved = [this](int index)
     {
+        closeEditorsFor(effectChain.getPluginProcessor(index));
         effectChain.removePlugin(index);
     };
 
@@ -410,6 +461,8 @@ PluginHostPanel::PluginHostPanel()
     {
         showPluginEditor(index);
     };
+
+    startTimerHz(10);
 }
 
 PluginHostPanel::~PluginHostPanel()
@@ -436,7 +489,9 @@ void PluginHostPanel::resized()
 
 void PluginHostPanel::timerCallback()
 {
-    // Progress updates are handled via callbacks
+    // Scan progress comes through callbacks; this is the DSP load
+    if (isShowing())
+        chainComponent->updateLoads();
 }
 
 void PluginHostPanel::prepare(double sampleRate, int samplesPerBlock)
@@ -448,30 +503,55 @@ void PluginHostPanel::prepare(double sampleRate, int samplesPerBlock)
 
 void PluginHostPanel::addPluginToChain(const juce::PluginDescription& description)
 {
-    juce::String errorMessage;
+    addPluginToChain([this] { return &effectChain; }, description);
+}
+
+void PluginHostPanel::addPluginToChain(std::function<EffectChain*()> findChain, const juce::PluginDescription& description)
+{
+    auto* chain = findChain();
+    if (chain == nullptr)
+        return;
 
-    auto plugin = pluginManager.loadPlugin(description, currentSampleRate, currentBlockSize, errorMessage);
+    // Loaded at the chain's settings, so it needn't be prepared again there
+    const double sampleRate = chain->getSampleRate() > 0.0 ? chain->getSampleRate() : currentSampleRate;
+    const int blockSize = chain->getBlockSize() > 0 ? chain->getBlockSize() : currentBlockSize;
 
-    if (plugin != nullptr)
-    {
-        effectChain.addPlugin(std::move(plugin), description.name);
-    }
-    else
+    juce::Component::SafePointer<PluginHostPanel> safeThis(this);
+    const auto name = description.name;
+
+    pluginManager.loadPluginAsync(description, sampleRate, blockSize,
+        [safeThis, findChain, name](std::unique_ptr<juce::AudioPluginInstance> plugin, const juce::String& errorMessage)
     {
-        juce::AlertWindow::showMessageBoxAsync(
-            juce::AlertWindow::WarningIcon,
-            "Plugin Load Error",
-            "Failed to load plugin: " + errorMessage);
-    }
+        if (safeThis == nullptr)
+            return;
+
+        if (plugin == nullptr)
+        {
+            juce::AlertWindow::showMessageBoxAsync(
+                juce::AlertWindow::WarningIcon,
+                "Plugin Load Error",
+                "Failed to load plugin: " + errorMessage);
+            return;
+        }
+
+        // The track may have gone while the plugin loaded
+        if (auto* target = findChain())
+            target->addPlugin(std::move(plugin), name);
+    });
 }
 
 void PluginHostPanel::showPluginEditor(int slotIndex)
 {
-    auto* editor = effectChain.createEditorForPlugin(slotIndex);
+    showPluginEditor(effectChain, slotIndex);
+}
+
+void PluginHostPanel::showPluginEditor(EffectChain& chain, int slotIndex)
+{
+    auto* editor = chain.createEditorForPlugin(slotIndex);
 
     if (editor != nullptr)
     {
-        auto* slot = effectChain.getPluginSlot(slotIndex);
+        auto* slot = chain.getPluginSlot(slotIndex);
         juce::String windowName = slot ? slot->name : "Plugin Editor";
 
         auto* window = new PluginEditorWindow(editor, windowName);
@@ -490,3 +570,94 @@ void PluginHostPanel::closeAllEditorWindows()
 {
     editorWindows.clear();
 }
+
+void PluginHostPanel::closeEditorsFor(EffectChain& chain)
+{
+    for (int i = 0; i < chain.getNumPlugins(); ++i)
+        closeEditorsFor(chain.getPluginProcessor(i));
+}
+
+void PluginHostPanel::closeEditorsFor(const juce::AudioProcessor* processor)
+{
+    if (processor == nullptr)
+        return;
+
+    for (int i = editorWindows.size(); --i >= 0;)
+    {
+        auto* editor = dynamic_cast<juce::AudioProcessorEditor*>(editorWindows[i]->getContentComponent());
+
+        if (editor != nullptr && editor->getAudioProcessor() == processor)
+            editorWindows.remove(i);
+    }
+}
+
+//==============================================================================
+void PluginHostPanel::showInsertMenu(const juce::String& title, std::function<EffectChain*()> findChain)
+{
+    auto* chain = findChain();
+    if (chain == nullptr)
+        return;
+
+    enum MenuIds { editBase = 1000, bypassBase = 2000, removeBase = 3000, addBase = 10000 };
+
+    juce::PopupMenu menu;
+    juce::String header = title + " Inserts";
+
+    if (chain->getLatencySamples() > 0)
+        header << " (" << chain->getLatencySamples() << " samples latency)";
+
+    menu.addSectionHeader(header);
+
+    for (int i = 0; i < chain->getNumPlugins(); ++i)
+    {
+        auto* slot = chain->getPluginSlot(i);
+
+        juce::PopupMenu slotMenu;
+        slotMenu.addItem(editBase + i, "Edit...");
+        slotMenu.addItem(bypassBase + i, "Bypass", true, chain->isPluginBypassed(i));
+        slotMenu.addItem(removeBase + i, "Remove");
+
+        menu.addSubMenu(juce::String(i + 1) + ". " + slot->name, slotMenu);
+    }
+
+    if (chain->getNumPlugins() > 0)
+        menu.addSeparator();
+
+    auto plugins = pluginManager.getAvailablePlugins();
+    juce::PopupMenu addMenu;
+
+    for (int i = 0; i < plugins.size(); ++i)
+        addMenu.addItem(addBase + i, plugins[i].name);
+
+    menu.addSubMenu("Add Plugin", addMenu, !plugins.isEmpty());
+
+    juce::Component::SafePointer<PluginHostPanel> safeThis(this);
+
+    menu.showMenuAsync(juce::PopupMenu::Options(), [safeThis, findChain, plugins](int result)
+    {
+        if (safeThis == nullptr || result == 0)
+            return;
+
+        auto* target = findChain();
+        if (target == nullptr)
+            return;
+
+        if (result >= addBase)
+        {
+            safeThis->addPluginToChain(findChain, plugins[result - addBase]);
+        }
+        else if (result >= removeBase)
+        {
+            safeThis->closeEditorsFor(target->getPluginProcessor(result - removeBase));
+            target->removePlugin(result - removeBase);
+        }
+        else if (result >= bypassBase)
+        {
+            target->setPluginBypassed(result - bypassBase, !target->isPluginBypassed(result - bypassBase));
+        }
+        else if (target->getPluginSlot(result - editBase) != nullptr)
+        {
+            safeThis->showPluginEditor(*target, result - editBase);
+        }
+    });
+}
@@ -31,6 +31,9 @@ class PluginSlotComponent : public juce::Component
     void setBypassed(bool bypassed);
     bool getBypassed() const { return isBypassed; }
 
+    // DSP load shown under the name; spikes are blocks over the threshold
+    void setLoad(const PluginLoadMeter::Stats& stats, float spikeThreshold);
+
     int getSlotIndex() const { return index; }
     juce::String getPluginName() const { return pluginName; }
 
@@ -45,6 +48,9 @@ class PluginSlotComponent : public juce::Component
     bool isSelected { false };
     bool isBypassed { false };
 
+    PluginLoadMeter::Stats load;
+    float loadSpikeThreshold { PluginLoadMeter::defaultSpikeThreshold };
+
     juce::TextButton editButton { "Edit" };
     juce::TextButton bypassButton { "Bypass" };
     juce::TextButton removeButton { "X" };
@@ -94,6 +100,9 @@ class EffectChainComponent : public juce::Component
 
     void refreshChain();
 
+    // Polled by the panel's timer
+    void updateLoads();
+
     std::function<void(int)> onSlotSelected;
     std::function<void(int)> onSlotRemoved;
     std::function<void(int)> onSlotBypassToggled;
@@ -106,6 +115,7 @@ class EffectChainComponent : public juce::Component
 
     juce::Label titleLabel;
     juce::TextButton clearAllButton { "Clear All" };
+    juce::TextButton resetLoadButton { "Reset Load" };
     juce::ToggleButton bypassChainButton { "Bypass Chain" };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectChainComponent)
@@ -135,7 +145,7 @@ class PluginHostPanel : public juce::Component,
     void paint(juce::Graphics& g) override;
     void resized() override;
 
-    // Timer for progress updates
+    // Timer for the slots' DSP load
     void timerCallback() override;
 
     // Access to effect chain for audio processing
@@ -144,10 +154,22 @@ class PluginHostPanel : public juce::Component,
     // Prepare for audio processing
     void prepare(double sampleRate, int samplesPerBlock);
 
+    // Popup for a mixer channel's insert chain: add plugins, open their
+    // editors, bypass or remove them. The chain is looked up again when an
+    // item is picked, since the track may be gone by then.
+    void showInsertMenu(const juce::String& title, std::function<EffectChain*()> findChain);
+
+    // Editors must close before their plugins are destroyed
+    void closeEditorsFor(EffectChain& chain);
+    void closeAllEditorWindows();
+
 private:
     void addPluginToChain(const juce::PluginDescription& description);
+    // Loads in the background; the chain is looked up again once it's ready
+    void addPluginToChain(std::function<EffectChain*()> findChain, const juce::PluginDescription& description);
     void showPluginEditor(int slotIndex);
-    void closeAllEditorWindows();
+    void showPluginEditor(EffectChain& chain, int slotIndex);
+    void closeEditorsFor(const juce::AudioProcessor* processor);
 
     PluginManager pluginManager;
     EffectChain effectChain;
@@ -53,6 +53,20 @@ void SpectrogramDisplay::pushNextSampleIntoFifo(float sample)
     fifo[fifoIndex++] = sample;
 }
 
+//==============================================================================
+void SpectrogramDisplay::setAnalysisTap(AnalysisTap* tap)
+{
+    tapReader = tap != nullptr ? std::make_unique<AnalysisTap::Reader>(*tap) : nullptr;
+}
+
+void SpectrogramDisplay::drainAnalysisTap()
+{
+    if (tapReader == nullptr)
+        return;
+
+    tapReader->drainMono([this](float sample) { pushNextSampleIntoFifo(sample); });
+}
+
 //==============================================================================
 void SpectrogramDisplay::paint(juce::Graphics& g)
 {
@@ -88,6 +102,8 @@ void SpectrogramDisplay::resized()
 //==============================================================================
 void SpectrogramDisplay::timerCallback()
 {
+    drainAnalysisTap();
+
     if (nextFFTBlockReady)
     {
         // Apply windowing function
@@ -12,6 +12,8 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "../Core/AnalysisTap.h"
+#include <memory>
 #include <vector>
 
 class SpectrogramDisplay : public juce::Component,
@@ -41,9 +43,12 @@ class SpectrogramDisplay : public juce::Component,
     static constexpr int historySize = 512;  // Number of time slices to display
 
     //==========================================================================
-    // Update spectrum data (call from audio thread)
+    // Update spectrum data (fed from the analysis tap on the message thread)
     void pushNextSampleIntoFifo(float sample);
 
+    // Drain samples from the engine's analysis tap on the timer (nullptr to detach)
+    void setAnalysisTap(AnalysisTap* tap);
+
     //==========================================================================
     // Display settings
     void setMinFrequency(float freq) { minFrequency = freq; repaint(); }
@@ -84,6 +89,8 @@ class SpectrogramDisplay : public juce::Component,
 
 private:
     //==========================================================================
+    void drainAnalysisTap();
+
     void drawSpectrogram(juce::Graphics& g, const juce::Rectangle<int>& bounds);
     void drawFrequencyLabels(juce::Graphics& g, const juce::Rectangle<int>& bounds);
     void drawTimeAxis(juce::Graphics& g, const juce::Rectangle<int>& bounds);
@@ -129,6 +136,10 @@ class SpectrogramDisplay : public juce::Component,
     std::vector<juce::Colour> colorMapLUT;
     void buildColorMapLUT();
 
+    //==========================================================================
+    // Analysis tap reader (message thread)
+    std::unique_ptr<AnalysisTap::Reader> tapReader;
+
     //==========================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramDisplay)
 };
@@ -50,6 +50,20 @@ void SpectrumDisplay::pushNextSampleIntoFifo(float sample)
     fifo[fifoIndex++] = sample;
 }
 
+//==============================================================================
+void SpectrumDisplay::setAnalysisTap(AnalysisTap* tap)
+{
+    tapReader = tap != nullptr ? std::make_unique<AnalysisTap::Reader>(*tap) : nullptr;
+}
+
+void SpectrumDisplay::drainAnalysisTap()
+{
+    if (tapReader == nullptr)
+        return;
+
+    tapReader->drainMono([this](float sample) { pushNextSampleIntoFifo(sample); });
+}
+
 //==============================================================================
 void SpectrumDisplay::paint(juce::Graphics& g)
 {
@@ -76,6 +90,8 @@ void SpectrumDisplay::resized()
 //==============================================================================
 void SpectrumDisplay::timerCallback()
 {
+    drainAnalysisTap();
+
     if (nextFFTBlockReady)
     {
         // Apply windowing function
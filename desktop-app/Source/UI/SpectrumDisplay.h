@@ -12,6 +12,8 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "../Core/AnalysisTap.h"
+#include <memory>
 #include <vector>
 
 class SpectrumDisplay : public juce::Component,
@@ -28,9 +30,12 @@ class SpectrumDisplay : public juce::Component,
     static constexpr int fftSize = 1 << fftOrder;
 
     //==========================================================================
-    // Update spectrum data (call from audio thread)
+    // Update spectrum data (fed from the analysis tap on the message thread)
     void pushNextSampleIntoFifo(float sample);
 
+    // Drain samples from the engine's analysis tap on the timer (nullptr to detach)
+    void setAnalysisTap(AnalysisTap* tap);
+
     // Get FFT data buffer for external processing
     float* getFFTData() { return fftData.data(); }
     int getFFTSize() const { return fftSize; }
@@ -53,6 +58,8 @@ class SpectrumDisplay : public juce::Component,
 
 private:
     //==========================================================================
+    void drainAnalysisTap();
+
     void drawFrame(juce::Graphics& g);
     void drawSpectrum(juce::Graphics& g, const juce::Rectangle<int>& bounds);
     void drawGrid(juce::Graphics& g, const juce::Rectangle<int>& bounds);
@@ -84,6 +91,10 @@ class SpectrumDisplay : public juce::Component,
 
     float sampleRate { 44100.0f };
 
+    //==========================================================================
+    // Analysis tap reader (message thread)
+    std::unique_ptr<AnalysisTap::Reader> tapReader;
+
     //==========================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumDisplay)
 };
@@ -25,10 +25,10 @@ SpectrumPanel::SpectrumPanel()
 }
 
 //==============================================================================
-void SpectrumPanel::pushNextSampleIntoFifo(float sample)
+void SpectrumPanel::setAnalysisTap(AnalysisTap* tap)
 {
-    spectrumDisplay.pushNextSampleIntoFifo(sample);
-    spectrogramDisplay.pushNextSampleIntoFifo(sample);
+    spectrumDisplay.setAnalysisTap(tap);
+    spectrogramDisplay.setAnalysisTap(tap);
 }
 
 //==============================================================================
@@ -13,6 +13,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "SpectrumDisplay.h"
 #include "SpectrogramDisplay.h"
+#include "../Core/AnalysisTap.h"
 
 class SpectrumPanel : public juce::Component
 {
@@ -22,8 +23,8 @@ class SpectrumPanel : public juce::Component
     ~SpectrumPanel() override = default;
 
     //==========================================================================
-    // Forward samples
-    void pushNextSampleIntoFifo(float sample);
+    // Attach both displays to the engine's analysis tap
+    void setAnalysisTap(AnalysisTap* tap);
 
     // Access for multi-view
     SpectrumDisplay* getSpectrumDisplay() { return &spectrumDisplay; }
@@ -695,6 +695,15 @@ void MixerSectionComponent::setScrollOffset(int offset)
     }
 }
 
+void MixerSectionComponent::updateMeters(TrackMeterBank& meters)
+{
+    TrackMeterBank::Levels levels;
+
+    for (auto* strip : strips)
+        if (meters.getTrackLevels(strip->getTrackId(), levels))
+            strip->setMeterLevels(levels.peakLeft, levels.peakRight);
+}
+
 void MixerSectionComponent::layoutStrips()
 {
     int y = 20;  // Leave space for header
@@ -987,6 +996,9 @@ void TimelinePanel::timerCallback()
 {
     // Update playhead position from external source if needed
     playhead.repaint();
+
+    if (meterSource != nullptr && mixerSection != nullptr && mixerVisible)
+        mixerSection->updateMeters(*meterSource);
 }
 
 //==============================================================================
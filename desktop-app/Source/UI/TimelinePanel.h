@@ -14,6 +14,7 @@
 #include <juce_audio_utils/juce_audio_utils.h>
 #include "../Core/ProjectModel.h"
 #include "../Core/ProjectManager.h"
+#include "../Core/TrackMeterBank.h"
 
 //==============================================================================
 // Forward declarations
@@ -320,6 +321,9 @@ class MixerSectionComponent : public juce::Component
     // Scroll sync with timeline headers
     void setScrollOffset(int offset);
 
+    // Peaks since the last call into each strip's meter
+    void updateMeters(TrackMeterBank& meters);
+
 private:
     ProjectManager& projectManager;
 
@@ -399,6 +403,9 @@ class TimelinePanel : public juce::Component,
     void setMixerVisible(bool visible);
     bool isMixerVisible() const { return mixerVisible; }
 
+    // Meters the mixer section polls (the engine's); nullptr stops polling
+    void setMeterSource(TrackMeterBank* meters) { meterSource = meters; }
+
     // Callbacks
     std::function<void(juce::int64)> onPlayheadMoved;
     std::function<void(ClipComponent*)> onClipSelected;
@@ -423,6 +430,7 @@ class TimelinePanel : public juce::Component,
     std::unique_ptr<MixerSectionComponent> mixerSection;
     juce::TextButton toggleMixerButton { "Mix" };
     bool mixerVisible { true };
+    TrackMeterBank* meterSource { nullptr };
 
     // Layout
     static constexpr int rulerHeight = 30;
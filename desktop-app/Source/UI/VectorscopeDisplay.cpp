@@ -14,6 +14,7 @@
 VectorscopeDisplay::VectorscopeDisplay()
 {
     sampleBuffer.resize(MAX_POINTS);
+    pushBuffer.resize(FIFO_SIZE);
     startTimer(50);  // 20 fps (reduced from 30)
 }
 
@@ -25,24 +26,41 @@ VectorscopeDisplay::~VectorscopeDisplay()
 //==============================================================================
 void VectorscopeDisplay::pushSample(float leftSample, float rightSample)
 {
-    juce::ScopedLock lock(bufferLock);
+    const auto scope = pushFifo.write(1);
 
-    sampleBuffer[writeIndex].left = leftSample;
-    sampleBuffer[writeIndex].right = rightSample;
+    if (scope.blockSize1 > 0)
+        pushBuffer[(size_t)scope.startIndex1] = { leftSample, rightSample };
+}
+
+int VectorscopeDisplay::drainPushedSamples()
+{
+    const auto scope = pushFifo.read(pushFifo.getNumReady());
 
-    writeIndex++;
-    if (writeIndex >= MAX_POINTS)
+    auto copy = [this](int start, int count)
     {
-        writeIndex = 0;
-        bufferFull = true;
-    }
+        for (int i = start; i < start + count; ++i)
+        {
+            sampleBuffer[(size_t)writeIndex] = pushBuffer[(size_t)i];
 
-    pathNeedsUpdate = true;
+            writeIndex++;
+            if (writeIndex >= MAX_POINTS)
+            {
+                writeIndex = 0;
+                bufferFull = true;
+            }
+        }
+    };
+
+    copy(scope.startIndex1, scope.blockSize1);
+    copy(scope.startIndex2, scope.blockSize2);
+
+    return scope.blockSize1 + scope.blockSize2;
 }
 
 void VectorscopeDisplay::clear()
 {
-    juce::ScopedLock lock(bufferLock);
+    // Whatever was pushed before the clear goes too
+    drainPushedSamples();
 
     for (auto& sample : sampleBuffer)
     {
@@ -101,8 +119,6 @@ void VectorscopeDisplay::drawGrid(juce::Graphics& g, const juce::Rectangle<int>&
 
 void VectorscopeDisplay::drawVectorscope(juce::Graphics& g, const juce::Rectangle<int>& bounds)
 {
-    juce::ScopedLock lock(bufferLock);
-
     float centerX = bounds.getCentreX();
     float centerY = bounds.getCentreY();
     float scale = juce::jmin(bounds.getWidth(), bounds.getHeight()) * 0.45f;
@@ -184,5 +200,8 @@ void VectorscopeDisplay::resized()
 
 void VectorscopeDisplay::timerCallback()
 {
+    if (drainPushedSamples() > 0)
+        pathNeedsUpdate = true;
+
     repaint();
 }
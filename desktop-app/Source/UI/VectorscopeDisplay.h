@@ -6,6 +6,9 @@
     Vectorscope (Lissajous) display for stereo field visualization
     Optimized for performance
 
+    Samples are pushed from the audio thread into a lock-free FIFO and
+    drained into the display's ring on the timer.
+
   ==============================================================================
 */
 
@@ -23,10 +26,11 @@ class VectorscopeDisplay : public juce::Component,
     ~VectorscopeDisplay() override;
 
     //==========================================================================
-    // Add stereo sample pair for display
+    // Add stereo sample pair for display. Real-time safe; one thread at a
+    // time (the audio thread). Dropped while the FIFO is full.
     void pushSample(float leftSample, float rightSample);
 
-    // Clear the display
+    // Clear the display (message thread)
     void clear();
 
     //==========================================================================
@@ -50,14 +54,20 @@ class VectorscopeDisplay : public juce::Component,
     void drawGrid(juce::Graphics& g, const juce::Rectangle<int>& bounds);
     void drawVectorscope(juce::Graphics& g, const juce::Rectangle<int>& bounds);
 
+    // Moves pushed samples into sampleBuffer; returns how many
+    int drainPushedSamples();
+
     //==========================================================================
     static constexpr int MAX_POINTS = 512;  // Reduced from 2048
     static constexpr int DRAW_STEP = 2;     // Draw every Nth point
-    std::vector<SamplePoint> sampleBuffer;
+    std::vector<SamplePoint> sampleBuffer;   // Message thread's
     int writeIndex { 0 };
     bool bufferFull { false };
 
-    juce::CriticalSection bufferLock;
+    // Audio thread -> message thread
+    static constexpr int FIFO_SIZE = MAX_POINTS * 4;
+    juce::AbstractFifo pushFifo { FIFO_SIZE };
+    std::vector<SamplePoint> pushBuffer;
 
     // Cached path for faster drawing
     juce::Path cachedPath;
@@ -1,4 +1,150 @@
 #include "DataExporter.h"
+#include "../DSP/LoudnessAnalyzer.h"
+#include "../DSP/TruePeakDetector.h"
+#include "../DSP/BPMDetector.h"
+#include "../DSP/KeyDetector.h"
+#include "../DSP/PitchDetector.h"
+#include <algorithm>
+
+bool DataExporter::analyzeFile(const juce::File& audioFile, AnalysisData& result)
+{
+    // Own format manager, so this can run off the message thread
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
+    if (reader == nullptr || reader->sampleRate <= 0.0)
+        return false;
+
+    result = AnalysisData();
+    result.fileName = audioFile.getFileName();
+    result.format = reader->getFormatName();
+    result.sampleRate = reader->sampleRate;
+    result.numChannels = (int)reader->numChannels;
+    result.lengthInSamples = reader->lengthInSamples;
+    result.duration = (double)reader->lengthInSamples / reader->sampleRate;
+    result.bitDepth = (int)reader->bitsPerSample;
+
+    const int numChannels = juce::jmax(1, (int)reader->numChannels);
+    const int chunkSize = 65536;
+    juce::AudioBuffer<float> buffer(numChannels, chunkSize);
+
+    LoudnessAnalyzer loudness;
+    loudness.prepare(reader->sampleRate, numChannels);
+
+    TruePeakDetector truePeak;
+    truePeak.prepare(numChannels);
+
+    // BPM and key see the same block size as they do behind the audio device
+    const int musicalBlockSize = 512;
+    BPMDetector bpmDetector;
+    bpmDetector.prepare(reader->sampleRate, musicalBlockSize);
+    KeyDetector keyDetector;
+    keyDetector.prepare(reader->sampleRate, musicalBlockSize);
+
+    // Pitch on consecutive, non-overlapping mono frames
+    const int pitchFrameSize = 4096;
+    PitchDetector pitchDetector;
+    pitchDetector.setSampleRate(reader->sampleRate);
+    std::vector<float> pitchFrame((size_t)pitchFrameSize);
+    std::vector<float> pitchedFrequencies;
+    int pitchFramePosition = 0;
+    int numSoundingFrames = 0;
+    double pitchConfidenceSum = 0.0;
+
+    double sumSquaresL = 0.0, sumSquaresR = 0.0, sumLR = 0.0;
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += chunkSize)
+    {
+        int numSamples = (int)juce::jmin((juce::int64)chunkSize, reader->lengthInSamples - position);
+        if (!reader->read(&buffer, 0, numSamples, position, true, true))
+            return false;
+
+        const float* left = buffer.getReadPointer(0);
+        const float* right = buffer.getReadPointer(numChannels >= 2 ? 1 : 0);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double l = left[i];
+            double r = right[i];
+            sumSquaresL += l * l;
+            sumSquaresR += r * r;
+            sumLR += l * r;
+        }
+
+        result.leftPeak = juce::jmax(result.leftPeak, buffer.getMagnitude(0, 0, numSamples));
+        result.rightPeak = juce::jmax(result.rightPeak, buffer.getMagnitude(numChannels >= 2 ? 1 : 0, 0, numSamples));
+
+        loudness.processBlock(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+        truePeak.processBlock(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+        for (int offset = 0; offset < numSamples; offset += musicalBlockSize)
+        {
+            int numThisTime = juce::jmin(musicalBlockSize, numSamples - offset);
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, offset, numThisTime);
+            bpmDetector.processBlock(block);
+            keyDetector.processBlock(block);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            pitchFrame[(size_t)pitchFramePosition++] = 0.5f * (left[i] + right[i]);
+
+            if (pitchFramePosition < pitchFrameSize)
+                continue;
+
+            pitchFramePosition = 0;
+
+            auto range = juce::FloatVectorOperations::findMinAndMax(pitchFrame.data(), pitchFrameSize);
+            if (juce::jmax(-range.getStart(), range.getEnd()) <= 0.001f)
+                continue;
+
+            ++numSoundingFrames;
+            auto pitch = pitchDetector.detectPitch(pitchFrame.data(), pitchFrameSize);
+
+            if (pitch.isPitched)
+            {
+                pitchedFrequencies.push_back(pitch.frequency);
+                pitchConfidenceSum += pitch.confidence;
+            }
+        }
+    }
+
+    if (reader->lengthInSamples > 0)
+    {
+        result.leftRMS = (float)std::sqrt(sumSquaresL / (double)reader->lengthInSamples);
+        result.rightRMS = (float)std::sqrt(sumSquaresR / (double)reader->lengthInSamples);
+    }
+
+    double denominator = std::sqrt(sumSquaresL * sumSquaresR);
+    result.phaseCorrelation = denominator > 0.0 ? (float)(sumLR / denominator) : 0.0f;
+
+    // BS.1770-4 Annex 2 true peaks, as shown by the playback true peak meter
+    result.truePeakLeft = truePeak.getPeak(0);
+    result.truePeakRight = truePeak.getPeak(numChannels >= 2 ? 1 : 0);
+
+    result.integratedLoudness = loudness.getIntegratedLoudness();
+    result.loudnessRange = loudness.getLoudnessRange();
+
+    result.hasMusicalAnalysis = true;
+    result.bpm = bpmDetector.getBPM();
+    result.bpmConfidence = bpmDetector.getConfidence();
+    result.key = KeyDetector::getKeyName(keyDetector.getDetectedKey());
+    result.keyConfidence = keyDetector.getConfidence();
+
+    if (!pitchedFrequencies.empty())
+    {
+        auto middle = pitchedFrequencies.begin() + (std::ptrdiff_t)(pitchedFrequencies.size() / 2);
+        std::nth_element(pitchedFrequencies.begin(), middle, pitchedFrequencies.end());
+
+        result.pitchFrequency = *middle;
+        result.pitchNoteName = PitchDetector::frequencyToNoteName(result.pitchFrequency);
+        result.pitchConfidence = (float)(pitchConfidenceSum / (double)pitchedFrequencies.size());
+        result.pitchedRatio = (float)pitchedFrequencies.size() / (float)numSoundingFrames;
+    }
+
+    return true;
+}
 
 bool DataExporter::exportToJSON(const AnalysisData& data, const juce::File& outputFile)
 {
@@ -7,13 +153,18 @@ bool DataExporter::exportToJSON(const AnalysisData& data, const juce::File& outp
     // Ensure parent directory exists
     outputFile.getParentDirectory().createDirectory();
 
-    // Write to file
-    auto outputStream = outputFile.createOutputStream();
-    if (outputStream == nullptr)
+    // Write to file, replacing any previous export rather than appending to it
+    juce::FileOutputStream outputStream(outputFile);
+    if (outputStream.failedToOpen())
         return false;
 
-    juce::JSON::writeToStream(*outputStream, jsonData, true);
-    return true;
+    outputStream.setPosition(0);
+    outputStream.truncate();
+
+    juce::JSON::writeToStream(outputStream, jsonData, true);
+    outputStream.flush();
+
+    return outputStream.getStatus().wasOk();
 }
 
 juce::var DataExporter::dataToJSON(const AnalysisData& data)
@@ -59,6 +210,21 @@ juce::var DataExporter::dataToJSON(const AnalysisData& data)
     advanced->setProperty("loudnessRange_LU", data.loudnessRange);
     root->setProperty("advanced", juce::var(advanced));
 
+    // Musical analysis
+    if (data.hasMusicalAnalysis)
+    {
+        auto* musical = new juce::DynamicObject();
+        musical->setProperty("bpm", data.bpm);
+        musical->setProperty("bpmConfidence", data.bpmConfidence);
+        musical->setProperty("key", data.key);
+        musical->setProperty("keyConfidence", data.keyConfidence);
+        musical->setProperty("pitch_Hz", data.pitchFrequency);
+        musical->setProperty("pitchNote", data.pitchNoteName);
+        musical->setProperty("pitchConfidence", data.pitchConfidence);
+        musical->setProperty("pitchedRatio", data.pitchedRatio);
+        root->setProperty("musical", juce::var(musical));
+    }
+
     // Metadata
     auto* metadata = new juce::DynamicObject();
     metadata->setProperty("exportedAt", juce::Time::getCurrentTime().toString(true, true));
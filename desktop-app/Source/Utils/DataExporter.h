@@ -28,8 +28,24 @@ class DataExporter
         float phaseCorrelation { 0.0f };
         float integratedLoudness { 0.0f };
         float loudnessRange { 0.0f };
+
+        // Musical analysis (whole-file analysis only)
+        bool hasMusicalAnalysis { false };
+        float bpm { 0.0f };
+        float bpmConfidence { 0.0f };
+        juce::String key;
+        float keyConfidence { 0.0f };
+        float pitchFrequency { 0.0f };     // Median over pitched frames, 0 if none
+        juce::String pitchNoteName;
+        float pitchConfidence { 0.0f };
+        float pitchedRatio { 0.0f };       // Fraction of non-silent frames with a pitch
     };
 
+    // Reads the whole file as fast as it decodes and fills in file info,
+    // levels, true peak, phase correlation, BS.1770-4 loudness, BPM, key and
+    // pitch. Needs no audio device; safe to call from any thread.
+    static bool analyzeFile(const juce::File& audioFile, AnalysisData& result);
+
     static bool exportToJSON(const AnalysisData& data, const juce::File& outputFile);
     static juce::var dataToJSON(const AnalysisData& data);
 };
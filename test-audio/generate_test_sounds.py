@@ -33,6 +33,15 @@ def lufs_to_rms(lufs):
     ms = 10.0 ** ((lufs + 0.691) / 10.0)
     return np.sqrt(ms)
 
+def lufs_to_sine_amplitude(lufs):
+    """
+    Peak amplitude of a 1kHz sine, identical in both channels, that measures
+    the given loudness under ITU-R BS.1770 (K-weighted, channel-summed).
+    K-weighting adds ~+0.691 dB at 1kHz, cancelling the -0.691 offset, and
+    the two channels together carry A^2 (2 x A^2 / 2), so A = 10^(LUFS / 20).
+    """
+    return db_to_linear(lufs)
+
 def write_wav(filename, data, sample_rate=SAMPLE_RATE):
     """Write audio data to WAV file"""
     # Ensure output directory exists
@@ -95,21 +104,19 @@ def main():
     # -23 LUFS (EBU R128 target)
     print("  - Generating 1kHz tone at -23 LUFS...")
     amplitude_23 = lufs_to_rms(-23.0)
-    tone_1k = generate_sine_tone(1000, amplitude_23, DURATION)
+    tone_1k = generate_sine_tone(1000, lufs_to_sine_amplitude(-23.0), DURATION)
     stereo_23 = np.array([tone_1k, tone_1k])
     write_wav(f"{output_dir}/01_tone_1kHz_minus23LUFS.wav", stereo_23)
 
     # -18 LUFS (Maximum short-term for EBU R128)
     print("  - Generating 1kHz tone at -18 LUFS...")
-    amplitude_18 = lufs_to_rms(-18.0)
-    tone_1k = generate_sine_tone(1000, amplitude_18, DURATION)
+    tone_1k = generate_sine_tone(1000, lufs_to_sine_amplitude(-18.0), DURATION)
     stereo_18 = np.array([tone_1k, tone_1k])
     write_wav(f"{output_dir}/02_tone_1kHz_minus18LUFS.wav", stereo_18)
 
     # -14 LUFS (Over limit)
     print("  - Generating 1kHz tone at -14 LUFS...")
-    amplitude_14 = lufs_to_rms(-14.0)
-    tone_1k = generate_sine_tone(1000, amplitude_14, DURATION)
+    tone_1k = generate_sine_tone(1000, lufs_to_sine_amplitude(-14.0), DURATION)
     stereo_14 = np.array([tone_1k, tone_1k])
     write_wav(f"{output_dir}/03_tone_1kHz_minus14LUFS.wav", stereo_14)
 